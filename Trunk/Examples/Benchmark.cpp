@@ -0,0 +1,340 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Benchmark.h"
+#include "Examples.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "Image.h"
+#include "Camera.h"
+#include "Timer.h"
+#include "Utility.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+#ifndef _MSVC
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <sys/resource.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    // The scenes rendered by the benchmark (see Examples::GenerateStressScene())
+    const char *const Scenes[] =
+    {
+        "RandomSpheres:300",
+        "QuadGrid:32,24",
+        "TriangleSoup:1000",
+        "PointLights:64",
+        "GlassStack:6",
+        "BigAreaLight:12"
+    };
+
+    const int NumScenes = sizeof(Scenes) / sizeof(Scenes[0]);
+
+    // Returns the peak memory used by this process so far, in KiB; -1 if it can't be measured
+    const long GetPeakMemory()
+    {
+#ifdef _MSVC
+        return -1;
+#else
+        rusage usage;
+        if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+            return -1;
+
+    #ifdef __APPLE__
+        return usage.ru_maxrss / 1024;  // In bytes
+    #else
+        return usage.ru_maxrss;         // In KiB
+    #endif
+#endif
+    }
+}
+
+// Result's Constructor
+Benchmark::Result::Result() :
+    _scene(),
+    _seconds( 0 ),
+    _numRays( 0 ),
+    _peakMemory( -1 )
+{
+}
+
+// Result's Functions
+const double Benchmark::Result::RaysPerSecond() const
+{
+    return (_seconds > 0)? _numRays / _seconds: 0;
+}
+
+// Constructor
+Benchmark::Benchmark() :
+    _settings(),
+    _width( 320 ),
+    _height( 240 ),
+    _numRuns( 3 ),
+    _tolerance( 0.15f )
+{
+}
+
+// Destructor
+Benchmark::~Benchmark()
+{
+}
+
+// Functions
+const bool Benchmark::Measure(const std::string &sceneName, Result &result) const
+{
+    Scene scene;
+    if( !Examples::GenerateStressScene( scene, sceneName ) )
+    {
+        std::cout << "Error: Failed to generate scene: " << sceneName << std::endl;
+        return false;
+    }
+
+    Image image;
+    if( !image.Create( _width, _height ) )
+        return false;
+
+    Camera camera;
+    camera._position    .Set( 0, 0, 0 );
+    camera._hFov        = 45 * (_width / (float)_height);
+    camera._vFov        = 45;
+
+    RayTracer rayTracer;
+    rayTracer._settings = _settings;
+
+    // The progress displayed while rendering would garble the report, so it's kept aside
+    std::ostringstream output;
+    std::streambuf *const pOutputBuffer = std::cout.rdbuf( output.rdbuf() );
+
+    // Every scene starts from the same random sequence, so that it traces the same rays every time
+    srand( 1 );
+
+    const unsigned long long numRays = RayTracer::NumRaysTraced();
+    const Timer timer;
+    const bool bResult = rayTracer.Render( camera, scene, image );
+
+    result._scene       = sceneName;
+    result._seconds     = timer.ElapsedTime();
+    result._numRays     = RayTracer::NumRaysTraced() - numRays;
+    result._peakMemory  = GetPeakMemory();
+
+    std::cout.rdbuf( pOutputBuffer );
+
+    if( !bResult )
+        std::cout << "Error: Failed to render scene: " << sceneName << std::endl;
+
+    return bResult;
+}
+
+const bool Benchmark::MeasureInChild(const std::string &sceneName, Result &result) const
+{
+#ifdef _MSVC
+    return Measure( sceneName, result );
+#else
+    int pipeEnds[2];
+    if( pipe( pipeEnds ) != 0 )
+        return Measure( sceneName, result );
+
+    // Anything buffered for the standard output is written first, so that it isn't written twice
+    std::cout.flush();
+    const pid_t pid = fork();
+    if( pid < 0 )
+    {
+        close( pipeEnds[0] );
+        close( pipeEnds[1] );
+        return Measure( sceneName, result );
+    }
+
+    // The child renders the scene, and sends back its result as a line of text
+    if( pid == 0 )
+    {
+        close( pipeEnds[0] );
+
+        const bool bResult = Measure( sceneName, result );
+        std::ostringstream stream;
+        stream.precision( 17 );
+        stream << result._seconds << " " << result._numRays << " " << result._peakMemory;
+
+        const std::string line = stream.str();
+        const bool bSent = (write( pipeEnds[1], line.data(), line.size() ) == (ssize_t)line.size());
+        std::cout.flush();
+
+        _exit( (bResult && bSent)? 0: 1 );
+    }
+
+    close( pipeEnds[1] );
+
+    std::string line;
+    char buffer[256];
+    ssize_t numRead;
+    while( (numRead = read( pipeEnds[0], buffer, sizeof(buffer) )) > 0 )
+        line.append( buffer, numRead );
+    close( pipeEnds[0] );
+
+    int status = 0;
+    if( (waitpid( pid, &status, 0 ) != pid) || !WIFEXITED( status ) || (WEXITSTATUS( status ) != 0) )
+        return false;
+
+    std::istringstream stream( line );
+    result._scene = sceneName;
+    return !(stream >> result._seconds >> result._numRays >> result._peakMemory).fail();
+#endif
+}
+
+const bool Benchmark::LoadResults(const std::string &fileName, ResultArray &results)
+{
+    std::ifstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open benchmark results file: " << fileName << std::endl;
+        return false;
+    }
+
+    results.clear();
+
+    std::string line;
+    for(int lineNumber = 1; std::getline( stream, line ); ++lineNumber)
+    {
+        // Skip blank lines and comments
+        Utility::String::TrimWhiteSpaces( line );
+        if( line.empty() || (line[0] == '#') )
+            continue;
+
+        Result result;
+        double raysPerSecond;
+        std::istringstream lineStream( line );
+        if( (lineStream >> result._scene >> result._seconds >> result._numRays >> raysPerSecond >> result._peakMemory).fail() )
+        {
+            std::cout << "Error: Invalid line " << lineNumber << " in benchmark results file: " << fileName << std::endl;
+            return false;
+        }
+
+        results.push_back( result );
+    }
+
+    return true;
+}
+
+const bool Benchmark::SaveResults(const std::string &fileName, const ResultArray &results) const
+{
+    std::ofstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open benchmark results file: " << fileName << std::endl;
+        return false;
+    }
+
+    stream << "# RayWatch benchmark at " << _width << "x" << _height << std::endl;
+    stream << "# <scene> <seconds> <rays> <rays per second> <peak memory in KiB>" << std::endl;
+    for(std::size_t i=0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        stream << result._scene << " " << result._seconds << " " << result._numRays << " "
+            << (unsigned long long)result.RaysPerSecond() << " " << result._peakMemory << std::endl;
+    }
+
+    if( stream.fail() )
+    {
+        std::cout << "Error: Failed while writing benchmark results file: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const bool Benchmark::Compare(const ResultArray &results, const ResultArray &baseline) const
+{
+    bool bRegressed = false;
+    for(std::size_t i=0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+
+        std::size_t j = 0;
+        while( (j < baseline.size()) && (baseline[j]._scene != result._scene) )
+            ++j;
+
+        if( j == baseline.size() )
+        {
+            std::cout << "  " << result._scene << ": not in the baseline" << std::endl;
+            continue;
+        }
+
+        const double ratio = (baseline[j].RaysPerSecond() > 0)? result.RaysPerSecond() / baseline[j].RaysPerSecond(): 1;
+        const bool bSlower = (ratio < 1 - _tolerance);
+
+        std::cout << "  " << result._scene << ": " << (ratio - 1) * 100 << "% rays per second";
+        if( result._numRays != baseline[j]._numRays )
+            std::cout << " (traces " << result._numRays << " rays rather than " << baseline[j]._numRays << ")";
+        std::cout << (bSlower? " REGRESSION": "") << std::endl;
+
+        bRegressed = bRegressed || bSlower;
+    }
+
+    return !bRegressed;
+}
+
+const bool Benchmark::Run(const std::string &resultsFileName, const std::string &baselineFileName) const
+{
+    ResultArray baseline;
+    if( !baselineFileName.empty() && !LoadResults( baselineFileName, baseline ) )
+        return false;
+
+    ResultArray results;
+    for(int i=0; i < NumScenes; ++i)
+    {
+        std::cout << Scenes[i] << ": " << std::flush;
+
+        Result result;
+        for(int run=0; run < _numRuns; ++run)
+        {
+            Result runResult;
+            if( !MeasureInChild( Scenes[i], runResult ) )
+            {
+                std::cout << "Error: Failed to benchmark scene: " << Scenes[i] << std::endl;
+                return false;
+            }
+
+            if( (run == 0) || (runResult._seconds < result._seconds) )
+                result = runResult;
+        }
+
+        std::cout << result._seconds << " s, " << result._numRays << " rays, " << (unsigned long long)result.RaysPerSecond() << " rays/s";
+        if( result._peakMemory >= 0 )
+            std::cout << ", " << result._peakMemory << " KiB peak";
+        std::cout << std::endl;
+
+        results.push_back( result );
+    }
+
+    if( !SaveResults( resultsFileName, results ) )
+        return false;
+
+    std::cout << "Benchmark results written to file: " << resultsFileName << std::endl;
+
+    if( baseline.empty() )
+        return true;
+
+    std::cout << "Compared with the baseline (" << baselineFileName << "):" << std::endl;
+    return Compare( results, baseline );
+}
@@ -0,0 +1,91 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BENCHMARK_HEADER
+#define BENCHMARK_HEADER
+
+#include "RenderSettings.h"
+#include <string>
+#include <vector>
+
+// Renders each of the stress scenes (see Examples::GenerateStressScene()) at a fixed resolution,
+// and records the wall time, the no. of rays traced, the rays traced per second and the peak memory
+// use of each render. The results are saved to a file, one line per scene:
+//      <scene> <seconds> <rays> <rays per second> <peak memory in KiB>
+// and can be compared against those of an earlier run (the baseline) to catch regressions.
+// Note: The rays are those traced by the Integrator; shadow rays are only counted if they're ray traced.
+//       Each scene is rendered in a process of its own (except on Windows, where the peak memory isn't measured).
+class Benchmark
+{
+// Types
+private:
+    struct Result
+    {
+        std::string         _scene;
+        double              _seconds;
+        unsigned long long  _numRays;
+        long                _peakMemory;    // In KiB; -1 if it wasn't measured
+
+        explicit Result();
+
+        const double RaysPerSecond() const;
+    };
+
+    typedef std::vector<Result> ResultArray;
+
+// Members
+public:
+    RenderSettings  _settings;
+    int             _width;
+    int             _height;
+    int             _numRuns;       // Times each scene is rendered; the fastest is kept, as it's the least disturbed by other processes
+    float           _tolerance;     // Fraction by which the rays per second may fall below the baseline before it's a regression
+
+public:
+// Constructor
+    explicit Benchmark();
+// Destructor
+    ~Benchmark();
+
+private:
+// Copy Constructor / Assignment Operator
+    Benchmark(const Benchmark &);
+    const Benchmark &operator =(const Benchmark &);
+
+// Functions
+private:
+    // Renders the scene in this process
+    const bool Measure(const std::string &scene, Result &result) const;
+
+    // Renders the scene in a process of its own, so that its peak memory use is its own
+    const bool MeasureInChild(const std::string &scene, Result &result) const;
+
+    static const bool LoadResults(const std::string &fileName, ResultArray &results);
+    const bool SaveResults(const std::string &fileName, const ResultArray &results) const;
+
+    // Reports how the results compare with the baseline; returns false if any of them regressed
+    const bool Compare(const ResultArray &results, const ResultArray &baseline) const;
+
+public:
+    // Runs the benchmark, saving the results to the file. If a baseline file is given, the results
+    // are compared with it; returns false if there's a regression.
+    const bool Run(const std::string &resultsFileName, const std::string &baselineFileName) const;
+};
+
+#endif
@@ -37,6 +37,10 @@ const bool Examples::CornellBox(const std::string &fileName)
     scene._maxRayGenerations = 3;
     scene._ambientLight.Set( 0.1f );
 
+    // The Bottom and Top Quads share a Material
+    Material *pWhite = scene.CreateMaterial();
+    pWhite->SetColor(1, 1, 1);
+
     // Back Quad
     {
         Quad *pQuad = new Quad();
@@ -44,7 +48,9 @@ const bool Examples::CornellBox(const std::string &fileName)
             Vector<float>( -1,  1, -4),
             Vector<float>( -1, -1, -4),
             Vector<float>(  1, -1, -4) );
-        pQuad->_material.SetColor(0.25f, 0.25f, 1);
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(0.25f, 0.25f, 1);
+        pQuad->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pQuad );
     }
@@ -55,7 +61,7 @@ const bool Examples::CornellBox(const std::string &fileName)
             Vector<float>( -1, -1, -4),
             Vector<float>( -1, -1, 0),
             Vector<float>(  1, -1, 0) );
-        pQuad->_material.SetColor(1, 1, 1);
+        pQuad->_pMaterial = pWhite;
 
         scene.AddPrimitive( pQuad );
     }
@@ -66,7 +72,7 @@ const bool Examples::CornellBox(const std::string &fileName)
             Vector<float>( -1, 1, 0),
             Vector<float>( -1, 1, -4),
             Vector<float>(  1, 1, -4) );
-        pQuad->_material.SetColor(1, 1, 1);
+        pQuad->_pMaterial = pWhite;
 
         scene.AddPrimitive( pQuad );
     }
@@ -77,7 +83,9 @@ const bool Examples::CornellBox(const std::string &fileName)
             Vector<float>( -1,  1, 0),
             Vector<float>( -1, -1, 0),
             Vector<float>( -1, -1, -4) );
-        pQuad->_material.SetColor(1, 0.25f, 0.25f);
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 0.25f, 0.25f);
+        pQuad->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pQuad );
     }
@@ -88,7 +96,9 @@ const bool Examples::CornellBox(const std::string &fileName)
             Vector<float>( 1,  1, -4),
             Vector<float>( 1, -1, -4),
             Vector<float>( 1, -1,  0) );
-        pQuad->_material.SetColor(0.25f, 1, 0.25f);
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(0.25f, 1, 0.25f);
+        pQuad->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pQuad );
     }
@@ -98,9 +108,11 @@ const bool Examples::CornellBox(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(0.5f, -0.75, -3) );
         pSphere->SetRadius( 0.25f );
-        pSphere->_material.SetColor(1, 1, 0.25f);
-        pSphere->_material.SetSpecularity( 1 );
-        pSphere->_material.SetRoughness( 50 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 0.25f);
+        pMaterial->SetSpecularity( 1 );
+        pMaterial->SetRoughness( 50 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
@@ -110,8 +122,10 @@ const bool Examples::CornellBox(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(-0.4f, -0.75f, -3.5f) );
         pSphere->SetRadius( 0.25f );
-        pSphere->_material.SetColor(1, 1, 1);
-        pSphere->_material.SetReflectivity( 1 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 1);
+        pMaterial->SetReflectivity( 1 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
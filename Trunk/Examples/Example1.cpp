@@ -38,7 +38,7 @@ const bool Examples::Example1(const std::string &fileName)
     scene._ambientLight.Set( 0 );
 
     // Create a texture
-    Texture *pTexture = scene.LoadTexture( "Media/Textures/Checks.jpg" );
+    Texture *pTexture = scene.LoadTexture( "Media/Textures/Checks.png" );
     if( !pTexture )
     {
         std::cout << "Error: Failed to create Scene" << std::endl;
@@ -52,9 +52,11 @@ const bool Examples::Example1(const std::string &fileName)
             Vector<float>( -2, -1, -6),
             Vector<float>( -2, -1, -2),
             Vector<float>(  2, -1, -2) );
-        pQuad->_material.SetColor(1, 1, 1);
-        pQuad->_material.SetDiffuseMap( pTexture );
-        pQuad->_material.SetTextureScale( 0.25f );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 1);
+        pMaterial->SetDiffuseMap( pTexture );
+        pMaterial->SetTextureScale( 0.25f );
+        pQuad->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pQuad );
     }
@@ -63,8 +65,10 @@ const bool Examples::Example1(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(0.5f, -0.75f, -3) );
         pSphere->SetRadius( 0.25f );
-        pSphere->_material.SetColor(1, 1, 1);
-        pSphere->_material.SetReflectivity( 1 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 1);
+        pMaterial->SetReflectivity( 1 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
@@ -73,12 +77,14 @@ const bool Examples::Example1(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(-0.4f, -0.6f, -4) );
         pSphere->SetRadius( 0.4f );
-        pSphere->_material.SetColor(1, 0, 0);
-        pSphere->_material.SetReflectivity( 0.25f );
-        pSphere->_material.SetSpecularity( 0.5f );
-        pSphere->_material.SetRoughness( 20 );
-        pSphere->_material.SetFuzzyReflectionRadius( 0.2f );
-        pSphere->_material.SetFuzzyReflectionSamples( 50 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 0, 0);
+        pMaterial->SetReflectivity( 0.25f );
+        pMaterial->SetSpecularity( 0.5f );
+        pMaterial->SetRoughness( 20 );
+        pMaterial->SetFuzzyReflectionRadius( 0.2f );
+        pMaterial->SetFuzzyReflectionSamples( 50 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
@@ -38,7 +38,7 @@ const bool Examples::Example2(const std::string &fileName)
     scene._ambientLight.Set( 0.1f );
 
     // Create textures
-    Texture *pTexture1 = scene.LoadTexture( "Media/Textures/Checks.jpg" );
+    Texture *pTexture1 = scene.LoadTexture( "Media/Textures/Checks.png" );
     Texture *pTexture2 = scene.LoadTexture( "Media/Textures/Strands.png" );
     if( !(pTexture1 && pTexture2) )
     {
@@ -53,9 +53,11 @@ const bool Examples::Example2(const std::string &fileName)
             Vector<float>( -2, -1, -6),
             Vector<float>( -2, -1, -2),
             Vector<float>(  2, -1, -2) );
-        pQuad->_material.SetColor(1, 1, 1);
-        pQuad->_material.SetDiffuseMap( pTexture1 );
-        pQuad->_material.SetTextureScale( 0.25f );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 1);
+        pMaterial->SetDiffuseMap( pTexture1 );
+        pMaterial->SetTextureScale( 0.25f );
+        pQuad->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pQuad );
     }
@@ -64,8 +66,10 @@ const bool Examples::Example2(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(-0.25f, -0.4f, -4) );
         pSphere->SetRadius( 0.6f );
-        pSphere->_material.SetColor(1, 1, 1);
-        pSphere->_material.SetReflectivity( 0.25f );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 1, 1);
+        pMaterial->SetReflectivity( 0.25f );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
@@ -74,14 +78,16 @@ const bool Examples::Example2(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(0.6f, -0.7f, -3.5f) );
         pSphere->SetRadius( 0.3f );
-        pSphere->_material.SetColor(0.5f, 1, 0.5f);
-        pSphere->_material.SetSpecularity( 1 );
-        pSphere->_material.SetRoughness( 50 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(0.5f, 1, 0.5f);
+        pMaterial->SetSpecularity( 1 );
+        pMaterial->SetRoughness( 50 );
 
-        pSphere->_material.SetRefractiveIndex( 1.05f );
-        pSphere->_material.SetAbsorption( 3 );
+        pMaterial->SetRefractiveIndex( 1.05f );
+        pMaterial->SetAbsorption( 3 );
 
-        pSphere->_material.SetDiffuseMap( pTexture2 );
+        pMaterial->SetDiffuseMap( pTexture2 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
@@ -91,14 +97,16 @@ const bool Examples::Example2(const std::string &fileName)
         Sphere* pSphere = new Sphere();
         pSphere->SetCentre( Vector<float>(-0.5f, -0.8f, -3) );
         pSphere->SetRadius( 0.2f );
-        pSphere->_material.SetColor(1, 0.5f, 0.5f);
-        pSphere->_material.SetSpecularity( 1 );
-        pSphere->_material.SetRoughness( 50 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor(1, 0.5f, 0.5f);
+        pMaterial->SetSpecularity( 1 );
+        pMaterial->SetRoughness( 50 );
 
-        pSphere->_material.SetRefractiveIndex( 1.05f );
-        pSphere->_material.SetAbsorption( 3 );
+        pMaterial->SetRefractiveIndex( 1.05f );
+        pMaterial->SetAbsorption( 3 );
 
-        pSphere->_material.SetDiffuseMap( pTexture2 );
+        pMaterial->SetDiffuseMap( pTexture2 );
+        pSphere->_pMaterial = pMaterial;
 
         scene.AddPrimitive( pSphere );
     }
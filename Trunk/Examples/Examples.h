@@ -20,6 +20,9 @@
 
 #include <string>
 
+// Forward Declarations
+class Scene;
+
 class Examples
 {
 // Functions
@@ -27,6 +30,21 @@ public:
     static const bool CornellBox(const std::string &fileName);
     static const bool Example1(const std::string &fileName);
     static const bool Example2(const std::string &fileName);
+
+    // Stress scenes, for benchmarking. Each is generated from a fixed seed, so the same parameters
+    // always give the same scene; they're all in view of a camera at the origin looking down -z.
+    static void RandomSpheres(Scene &scene, const int &numSpheres);
+    static void QuadGrid(Scene &scene, const int &numColumns, const int &numRows);
+    static void TriangleSoup(Scene &scene, const int &numTriangles);
+    static void PointLights(Scene &scene, const int &numLights);
+    static void GlassStack(Scene &scene, const int &numLayers);
+    static void BigAreaLight(Scene &scene, const int &numSamplesPerSide);
+
+    // Generates a stress scene from its name and parameters, given as <name>:<parameter>[,<parameter>]
+    // (such as QuadGrid:32,24). Returns false if there's no such scene, or the parameters are invalid.
+    static const bool GenerateStressScene(Scene &scene, const std::string &specification);
+
+    static const bool SaveScene(const Scene &scene, const std::string &fileName);
 };
 
 #endif
@@ -0,0 +1,323 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RegressionTest.h"
+#include "Examples.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "Deserializer.h"
+#include "Image.h"
+#include "Camera.h"
+#include "SafeDelete.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <limits>
+#include <math.h>
+#include <stdlib.h>
+
+namespace
+{
+    struct ReferenceScene
+    {
+        const char *_name;          // Name of its golden image
+        const char *_scene;         // A sample, or a stress scene (see Examples::GenerateStressScene())
+        const char *_settings;      // Render settings, as <setting>:<value> separated by spaces
+    };
+
+    // The scenes cover the features which are most likely to change with the speed-ups; the noisier
+    // settings (stochastic branching, russian roulette, adaptive sampling) depend on the random sequence.
+    const ReferenceScene Scenes[] =
+    {
+        { "CornellBox",         "CornellBox",           "" },
+        { "Example1",           "Example1",             "" },
+        { "Example2",           "Example2",             "" },
+        { "RandomSpheres",      "RandomSpheres:60",     "" },
+        { "GlassStack",         "GlassStack:3",         "" },
+        { "BigAreaLight",       "BigAreaLight:4",       "" },
+        { "Antialiased",        "RandomSpheres:20",     "samplesPerPixel:4 filter:gaussian" },
+        { "Stochastic",         "GlassStack:3",         "stochasticBranching:true samplesPerPixel:4" },
+        { "RussianRoulette",    "RandomSpheres:60",     "minThroughput:0.2 russianRoulette:true" },
+        { "Adaptive",           "CornellBox",           "adaptiveThreshold:0.05 maxSamplesPerPixel:16" }
+    };
+
+    const int NumScenes = sizeof(Scenes) / sizeof(Scenes[0]);
+
+    // Generates one of the samples, which are written to a scene file and loaded back from it
+    const bool GenerateSample(const std::string &name, const std::string &fileName)
+    {
+        if( name == "CornellBox" )
+            return Examples::CornellBox( fileName );
+        if( name == "Example1" )
+            return Examples::Example1( fileName );
+        if( name == "Example2" )
+            return Examples::Example2( fileName );
+
+        return false;
+    }
+
+    Scene *const LoadScene(const std::string &fileName)
+    {
+        std::fstream stream;
+        stream.open( fileName.c_str(), std::ios_base::in );
+        if( !stream.is_open() )
+        {
+            std::cout << "Error: Failed to open input scene file: " << fileName << std::endl;
+            return 0;
+        }
+
+        Deserializer d;
+        if( !d.Open( stream ) )
+        {
+            std::cout << "Error: Failed to read file: " << fileName << std::endl;
+            return 0;
+        }
+
+        Scene *pScene = d.Deserialize<Scene>( 0 );
+        if( !pScene )
+            std::cout << "Error: Failed to load Scene from file: " << fileName << std::endl;
+
+        return pScene;
+    }
+}
+
+// Constructor
+RegressionTest::RegressionTest() :
+    _settings(),
+    _width( 320 ),
+    _height( 240 ),
+    _maxRmse( 1.0 ),
+    _minPsnr( 40.0 ),
+    _maxDifference( 16 ),
+    _bUpdate( false )
+{
+}
+
+// Destructor
+RegressionTest::~RegressionTest()
+{
+}
+
+// Functions
+const bool RegressionTest::Render(const int &sceneIndex, const std::string &directory, Image &image) const
+{
+    const ReferenceScene &reference = Scenes[ sceneIndex ];
+
+    RayTracer rayTracer;
+    rayTracer._settings = _settings;
+
+    std::istringstream settingsStream( reference._settings );
+    std::string setting;
+    while( settingsStream >> setting )
+    {
+        std::string name, value;
+        RenderSettings::SplitSetting( setting, name, value );
+        if( !rayTracer._settings.Set( name, value ) )
+        {
+            std::cout << "Error: Invalid render setting: " << setting << std::endl;
+            return false;
+        }
+    }
+
+    // The samples are loaded from scene files, which are kept beside the golden images
+    Scene *pScene = 0;
+    const std::string sceneName( reference._scene );
+    if( sceneName.find( ':' ) == std::string::npos )
+    {
+        const std::string sceneFileName = directory + "/" + reference._name + ".txt";
+        if( !GenerateSample( sceneName, sceneFileName ) )
+        {
+            std::cout << "Error: Failed to generate sample: " << sceneName << std::endl;
+            return false;
+        }
+
+        pScene = LoadScene( sceneFileName );
+    }
+    else
+    {
+        pScene = new Scene();
+        if( !Examples::GenerateStressScene( *pScene, sceneName ) )
+        {
+            std::cout << "Error: Failed to generate scene: " << sceneName << std::endl;
+            SafeDeleteScalar( pScene );
+        }
+    }
+
+    if( !pScene )
+        return false;
+
+    Camera camera;
+    camera._position    .Set( 0, 0, 0 );
+    camera._hFov        = 45 * (_width / (float)_height);
+    camera._vFov        = 45;
+
+    // The progress displayed while rendering would garble the report, so it's kept aside
+    std::ostringstream output;
+    std::streambuf *const pOutputBuffer = std::cout.rdbuf( output.rdbuf() );
+
+    // Every scene starts from the same random sequence, so that its noise is the same every time
+    srand( 1 );
+
+    const bool bResult = image.Create( _width, _height ) && rayTracer.Render( camera, *pScene, image );
+
+    std::cout.rdbuf( pOutputBuffer );
+    SafeDeleteScalar( pScene );
+
+    if( !bResult )
+        std::cout << "Error: Failed to render scene: " << sceneName << std::endl;
+
+    return bResult;
+}
+
+void RegressionTest::Measure(const Image &image, const Image &goldenImage, Difference &difference, Image &diffImage)
+{
+    const int width  = image.Width();
+    const int height = image.Height();
+
+    // The differences are those of the images as they're saved (8 bits per channel)
+    std::vector<int> pixelDifferences( width * height, 0 );
+    double sumSquares = 0;
+    difference._maxDifference = 0;
+
+    for(int y=0; y < height; ++y)
+    {
+        for(int x=0; x < width; ++x)
+        {
+            Pixel<> pixel, goldenPixel;
+            image.GetPixel( x, y, pixel );
+            goldenImage.GetPixel( x, y, goldenPixel );
+
+            const int r = abs( pixel._r - goldenPixel._r );
+            const int g = abs( pixel._g - goldenPixel._g );
+            const int b = abs( pixel._b - goldenPixel._b );
+            sumSquares += r * r + g * g + b * b;
+
+            int &pixelDifference = pixelDifferences[ y * width + x ];
+            pixelDifference = (r > g)? r: g;
+            pixelDifference = (b > pixelDifference)? b: pixelDifference;
+
+            if( pixelDifference > difference._maxDifference )
+                difference._maxDifference = pixelDifference;
+        }
+    }
+
+    difference._rmse = sqrt( sumSquares / (3.0 * width * height) );
+    difference._psnr = (difference._rmse > 0)?
+        20 * log10( 255 / difference._rmse ):
+        std::numeric_limits<double>::infinity();
+
+    // Brighten the differences, so that even the smallest ones can be seen
+    if( !diffImage.Create( width, height ) )
+        return;
+
+    for(int y=0; y < height; ++y)
+    {
+        for(int x=0; x < width; ++x)
+        {
+            const int pixelDifference = pixelDifferences[ y * width + x ];
+            const unsigned char value = (unsigned char)((difference._maxDifference > 0)? pixelDifference * 255 / difference._maxDifference: 0);
+            diffImage.SetPixel( x, y, Pixel<>( value, value, value, 255 ) );
+        }
+    }
+}
+
+const bool RegressionTest::Run(const std::string &directory) const
+{
+    int numFailed = 0;
+    for(int i=0; i < NumScenes; ++i)
+    {
+        const std::string name( Scenes[i]._name );
+        const std::string goldenFileName = directory + "/" + name + ".bmp";
+        std::cout << name << ": " << std::flush;
+
+        Image image;
+        if( !Render( i, directory, image ) )
+            return false;
+
+        if( _bUpdate )
+        {
+            if( !image.Save( goldenFileName ) )
+            {
+                std::cout << "Error: Failed while saving image to file: " << goldenFileName << std::endl;
+                return false;
+            }
+
+            std::cout << "golden image written to file: " << goldenFileName << std::endl;
+            continue;
+        }
+
+        const std::string newFileName = directory + "/" + name + ".new.bmp";
+        if( !image.Save( newFileName ) )
+        {
+            std::cout << "Error: Failed while saving image to file: " << newFileName << std::endl;
+            return false;
+        }
+
+        // The rendered image is compared as it was saved
+        Image newImage, goldenImage;
+        if( !newImage.Load( newFileName ) || !goldenImage.Load( goldenFileName ) )
+        {
+            std::cout << "Error: Failed to load golden image: " << goldenFileName << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        if( (newImage.Width() != goldenImage.Width()) || (newImage.Height() != goldenImage.Height()) )
+        {
+            std::cout << "FAILED; the golden image is " << goldenImage.Width() << "x" << goldenImage.Height() << std::endl;
+            ++numFailed;
+            continue;
+        }
+
+        Difference difference;
+        Image diffImage;
+        Measure( newImage, goldenImage, difference, diffImage );
+
+        const std::string diffFileName = directory + "/" + name + ".diff.bmp";
+        if( !diffImage.Save( diffFileName ) )
+        {
+            std::cout << "Error: Failed while saving image to file: " << diffFileName << std::endl;
+            return false;
+        }
+
+        const bool bPassed =
+            (difference._rmse <= _maxRmse) &&
+            (difference._psnr >= _minPsnr) &&
+            (difference._maxDifference <= _maxDifference);
+
+        std::cout << "RMSE " << difference._rmse << ", PSNR " << difference._psnr << " dB, max difference "
+            << difference._maxDifference << (bPassed? "": " FAILED") << std::endl;
+
+        if( !bPassed )
+            ++numFailed;
+    }
+
+    if( _bUpdate )
+        return true;
+
+    if( numFailed > 0 )
+    {
+        std::cout << numFailed << " of " << NumScenes << " scenes differ from their golden images." << std::endl;
+        return false;
+    }
+
+    std::cout << "All " << NumScenes << " scenes match their golden images." << std::endl;
+    return true;
+}
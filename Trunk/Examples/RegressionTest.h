@@ -0,0 +1,83 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef REGRESSIONTEST_HEADER
+#define REGRESSIONTEST_HEADER
+
+#include "RenderSettings.h"
+#include <string>
+
+// Forward Declarations
+class Image;
+
+// Renders a set of reference scenes (the samples, and some of the stress scenes with the noisier
+// render settings), and compares each with its golden image; <name>.bmp in the golden directory.
+// The difference is measured as the RMSE and PSNR of the colour channels (0 to 255), and the
+// largest difference of any channel of any pixel; the render fails if any exceeds its threshold.
+// <name>.new.bmp and <name>.diff.bmp are written beside each golden image, the latter showing
+// where the images differ (brightened, so that the largest difference is white).
+// Every scene is rendered from the same random sequence, so unchanged code gives identical images.
+// Note: Example2 loads its textures from Media/Textures, relative to the current directory.
+class RegressionTest
+{
+// Types
+private:
+    struct Difference
+    {
+        double  _rmse;
+        double  _psnr;              // In decibels; infinite if the images are identical
+        int     _maxDifference;
+    };
+
+// Members
+public:
+    RenderSettings  _settings;      // Each reference scene adds its own settings to these
+    int             _width;
+    int             _height;
+    double          _maxRmse;
+    double          _minPsnr;
+    int             _maxDifference;
+    bool            _bUpdate;       // Replace the golden images with the images rendered, rather than comparing them
+
+public:
+// Constructor
+    explicit RegressionTest();
+// Destructor
+    ~RegressionTest();
+
+private:
+// Copy Constructor / Assignment Operator
+    RegressionTest(const RegressionTest &);
+    const RegressionTest &operator =(const RegressionTest &);
+
+// Functions
+private:
+    // Renders the reference scene into the image
+    const bool Render(const int &sceneIndex, const std::string &directory, Image &image) const;
+
+    // Measures the difference between the images (which are the same size), and draws it in the diff image
+    static void Measure(const Image &image, const Image &goldenImage, Difference &difference, Image &diffImage);
+
+public:
+    // Renders every reference scene, and compares it with its golden image in the directory (or
+    // saves it there, if updating). Returns false if any of them failed.
+    const bool Run(const std::string &directory) const;
+};
+
+#endif
@@ -0,0 +1,358 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Examples.h"
+
+#include "Scene.h"
+#include "Quad.h"
+#include "Sphere.h"
+#include "Triangle.h"
+#include "PointLight.h"
+#include "AreaLight.h"
+#include "Serializer.h"
+#include "Utility.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Generates the same values on every platform (unlike rand()), from a fixed seed
+    class RandomSequence
+    {
+    // Members
+    private:
+        unsigned int _state;
+
+    public:
+    // Constructor
+        explicit RandomSequence() :
+            _state( 12345 )
+        {
+        }
+
+    // Functions
+    public:
+        // Returns a value from min to max
+        const float Next(const float &min, const float &max)
+        {
+            _state = _state * 1664525u + 1013904223u;
+            return min + (max - min) * ((_state >> 8) / 16777216.0f);
+        }
+
+        const Vector<float> Next(const Vector<float> &min, const Vector<float> &max)
+        {
+            const float x = Next( min.x, max.x );
+            const float y = Next( min.y, max.y );
+            const float z = Next( min.z, max.z );
+            return Vector<float>( x, y, z );
+        }
+    };
+
+    // The stress scenes are laid out within this box
+    const Vector<float> BoxMin( -2.0f, -1.5f, -8.0f );
+    const Vector<float> BoxMax(  2.0f,  1.5f, -3.0f );
+
+    void AddFloor(Scene &scene)
+    {
+        Quad *pQuad = new Quad();
+        pQuad->SetVertices(
+            Vector<float>( -4, BoxMin.y, -10 ),
+            Vector<float>( -4, BoxMin.y,   0 ),
+            Vector<float>(  4, BoxMin.y,   0 ) );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor( 1, 1, 1 );
+        pQuad->_pMaterial = pMaterial;
+
+        scene.AddPrimitive( pQuad );
+    }
+
+    void AddPointLight(Scene &scene, const Vector<float> &position, const float &intensity, const float &range)
+    {
+        PointLight *pLight = new PointLight();
+        pLight->_position = position;
+        pLight->SetColor( Color( 1, 1, 1 ) );
+        pLight->SetIntensity( intensity );
+        pLight->SetRange( range );
+
+        scene.AddLight( pLight );
+    }
+
+    void AddRandomSpheres(Scene &scene, RandomSequence &random, const int &numSpheres, const float &maxRadius)
+    {
+        for(int i=0; i < numSpheres; ++i)
+        {
+            Sphere *pSphere = new Sphere();
+            pSphere->SetCentre( random.Next( BoxMin, BoxMax ) );
+            pSphere->SetRadius( random.Next( maxRadius * 0.25f, maxRadius ) );
+            Material *pMaterial = scene.CreateMaterial();
+            pMaterial->SetColor( random.Next( 0, 1 ), random.Next( 0, 1 ), random.Next( 0, 1 ) );
+            pMaterial->SetSpecularity( 0.5f );
+
+            // Every fifth one is reflective
+            if( i % 5 == 0 )
+                pMaterial->SetReflectivity( 0.5f );
+            pSphere->_pMaterial = pMaterial;
+
+            scene.AddPrimitive( pSphere );
+        }
+    }
+}
+
+void Examples::RandomSpheres(Scene &scene, const int &numSpheres)
+{
+    RandomSequence random;
+    scene._maxRayGenerations = 3;
+    scene._ambientLight.Set( 0.1f );
+
+    AddFloor( scene );
+    AddRandomSpheres( scene, random, numSpheres, 0.3f );
+    AddPointLight( scene, Vector<float>( 0, 3, -2 ), 1, 20 );
+}
+
+void Examples::QuadGrid(Scene &scene, const int &numColumns, const int &numRows)
+{
+    RandomSequence random;
+    scene._maxRayGenerations = 3;
+    scene._ambientLight.Set( 0.1f );
+
+    // A wall of quads facing the camera, with gaps between them
+    const float width  = (BoxMax.x - BoxMin.x) / numColumns;
+    const float height = (BoxMax.y - BoxMin.y) / numRows;
+    for(int row=0; row < numRows; ++row)
+    {
+        for(int column=0; column < numColumns; ++column)
+        {
+            const float x = BoxMin.x + column * width;
+            const float y = BoxMin.y + row * height;
+            const float z = BoxMin.z + random.Next( 0, 0.5f );
+
+            Quad *pQuad = new Quad();
+            pQuad->SetVertices(
+                Vector<float>( x,                 y + height * 0.9f, z ),
+                Vector<float>( x,                 y,                 z ),
+                Vector<float>( x + width * 0.9f,  y,                 z ) );
+            Material *pMaterial = scene.CreateMaterial();
+            pMaterial->SetColor( random.Next( 0, 1 ), random.Next( 0, 1 ), random.Next( 0, 1 ) );
+            pQuad->_pMaterial = pMaterial;
+
+            scene.AddPrimitive( pQuad );
+        }
+    }
+
+    AddFloor( scene );
+    AddPointLight( scene, Vector<float>( 0, 1, -2 ), 1, 20 );
+}
+
+void Examples::TriangleSoup(Scene &scene, const int &numTriangles)
+{
+    RandomSequence random;
+    scene._maxRayGenerations = 3;
+    scene._ambientLight.Set( 0.1f );
+
+    const Vector<float> spread( 0.3f, 0.3f, 0.3f );
+    for(int i=0; i < numTriangles; ++i)
+    {
+        const Vector<float> centre = random.Next( BoxMin, BoxMax );
+        const Vector<float> v1 = centre + random.Next( -spread, spread );
+        const Vector<float> v2 = centre + random.Next( -spread, spread );
+        const Vector<float> v3 = centre + random.Next( -spread, spread );
+
+        Triangle *pTriangle = new Triangle();
+        pTriangle->SetVertices( v1, v2, v3 );
+        Material *pMaterial = scene.CreateMaterial();
+        pMaterial->SetColor( random.Next( 0, 1 ), random.Next( 0, 1 ), random.Next( 0, 1 ) );
+        pTriangle->_pMaterial = pMaterial;
+
+        scene.AddPrimitive( pTriangle );
+    }
+
+    AddFloor( scene );
+    AddPointLight( scene, Vector<float>( 0, 3, -2 ), 1, 20 );
+}
+
+void Examples::PointLights(Scene &scene, const int &numLights)
+{
+    RandomSequence random;
+    scene._maxRayGenerations = 3;
+    scene._ambientLight.Set( 0.1f );
+
+    AddFloor( scene );
+    AddRandomSpheres( scene, random, 10, 0.5f );
+
+    // The lights share out the illumination of a single light
+    for(int i=0; i < numLights; ++i)
+    {
+        const Vector<float> position = random.Next( Vector<float>( BoxMin.x, 1, BoxMin.z ), Vector<float>( BoxMax.x, 2.5f, BoxMax.z ) );
+        AddPointLight( scene, position, 4.0f / numLights, 6 );
+    }
+}
+
+void Examples::GlassStack(Scene &scene, const int &numLayers)
+{
+    RandomSequence random;
+
+    // Every layer has two surfaces for the rays to pass through.
+    // Note: The glass doesn't reflect, otherwise the no. of rays would double at every surface.
+    scene._maxRayGenerations = numLayers * 2 + 2;
+    scene._ambientLight.Set( 0.1f );
+
+    // The stripes alternate between two Materials, and the glass shares one
+    Material *pStripes[2] = { scene.CreateMaterial(), scene.CreateMaterial() };
+    pStripes[0]->SetColor( 0.2f, 0.5f, 1.0f );
+    pStripes[1]->SetColor( 1.0f, 0.5f, 0.2f );
+
+    Material *pGlass = scene.CreateMaterial();
+    pGlass->SetColor( 0.9f, 1, 0.9f );
+    pGlass->SetOpacity( 0.2f );
+    pGlass->SetRefractiveIndex( 1.5f );
+    pGlass->SetSpecularity( 0.5f );
+
+    // A striped wall behind the glass
+    for(int i=0; i < 8; ++i)
+    {
+        const float x = BoxMin.x + i * 0.5f;
+
+        Quad *pQuad = new Quad();
+        pQuad->SetVertices(
+            Vector<float>( x,        BoxMax.y, BoxMin.z ),
+            Vector<float>( x,        BoxMin.y, BoxMin.z ),
+            Vector<float>( x + 0.5f, BoxMin.y, BoxMin.z ) );
+        pQuad->_pMaterial = pStripes[i % 2];
+
+        scene.AddPrimitive( pQuad );
+    }
+
+    // Layers of glass, each a thin slab facing the camera
+    for(int layer=0; layer < numLayers; ++layer)
+    {
+        const float z = BoxMax.z - layer * ((BoxMax.z - BoxMin.z - 0.5f) / numLayers);
+        const float tilt = random.Next( -0.2f, 0.2f );
+
+        for(int side=0; side < 2; ++side)
+        {
+            const float sideZ = z - side * 0.1f;
+
+            Quad *pQuad = new Quad();
+            pQuad->SetVertices(
+                Vector<float>( -1.5f, 1.2f,  sideZ + tilt ),
+                Vector<float>( -1.5f, -1.2f, sideZ - tilt ),
+                Vector<float>(  1.5f, -1.2f, sideZ - tilt ) );
+            pQuad->_pMaterial = pGlass;
+
+            scene.AddPrimitive( pQuad );
+        }
+    }
+
+    AddFloor( scene );
+    AddPointLight( scene, Vector<float>( 0, 3, -2 ), 1, 20 );
+}
+
+void Examples::BigAreaLight(Scene &scene, const int &numSamplesPerSide)
+{
+    RandomSequence random;
+    scene._maxRayGenerations = 3;
+    scene._ambientLight.Set( 0.1f );
+
+    AddFloor( scene );
+    AddRandomSpheres( scene, random, 20, 0.4f );
+
+    // A light covering most of the ceiling, which casts wide penumbrae
+    const Vector<float> v1( -2, 2.5f, -3 );
+    const Vector<float> v2( -2, 2.5f, -8 );
+    const Vector<float> v3(  2, 2.5f, -8 );
+
+    ::AreaLight *pLight = new ::AreaLight();
+    pLight->SetColor( Color( 1, 1, 1 ) );
+    pLight->SetIntensity( 1 );
+    pLight->SetRange( 10 );
+    pLight->SetRectangularArea( v1, v2, v3, numSamplesPerSide, numSamplesPerSide );
+
+    scene.AddLight( pLight );
+
+    Quad *pQuad = new Quad();
+    pQuad->SetVertices( v1, v2, v3 );
+    pQuad->_pLight = pLight;
+
+    scene.AddPrimitive( pQuad );
+}
+
+const bool Examples::GenerateStressScene(Scene &scene, const std::string &specification)
+{
+    using Utility::String::CaseInsensitiveCompare;
+
+    const std::string::size_type separator = specification.find( ':' );
+    const std::string name = specification.substr( 0, separator );
+
+    std::vector<int> parameters;
+    if( (separator == std::string::npos) || !Utility::String::FromString( parameters, specification.substr( separator + 1 ) ) )
+        return false;
+
+    for(std::size_t i=0; i < parameters.size(); ++i)
+    {
+        if( parameters[i] < 1 )
+            return false;
+    }
+
+    if( parameters.size() == 1 )
+    {
+        if( CaseInsensitiveCompare( name, "RandomSpheres" ) == 0 )
+            RandomSpheres( scene, parameters[0] );
+        else if( CaseInsensitiveCompare( name, "TriangleSoup" ) == 0 )
+            TriangleSoup( scene, parameters[0] );
+        else if( CaseInsensitiveCompare( name, "PointLights" ) == 0 )
+            PointLights( scene, parameters[0] );
+        else if( CaseInsensitiveCompare( name, "GlassStack" ) == 0 )
+            GlassStack( scene, parameters[0] );
+        else if( CaseInsensitiveCompare( name, "BigAreaLight" ) == 0 )
+            BigAreaLight( scene, parameters[0] );
+        else
+            return false;
+    }
+    else if( (parameters.size() == 2) && (CaseInsensitiveCompare( name, "QuadGrid" ) == 0) )
+        QuadGrid( scene, parameters[0], parameters[1] );
+    else
+        return false;
+
+    // All the Lights have been added
+    scene.BuildLightTree();
+    return true;
+}
+
+const bool Examples::SaveScene(const Scene &scene, const std::string &fileName)
+{
+    // Create the file
+    std::fstream stream;
+    stream.open( fileName.c_str(), std::ios_base::out | std::ios_base::trunc );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to create file: " << fileName << std::endl;
+        return false;
+    }
+
+    // Serialize the scene
+    Serializer s( stream );
+    if( !scene.Write( s ) )
+    {
+        std::cout << "Error: Failed to write Scene" << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -21,15 +21,185 @@
 #include "Utility.h"
 #include "Maths.h"
 #include "Vector.h"
-#include <SDL_image.h>
+#include "Inflate.h"
 #include <iostream>
+#include <vector>
+#include <limits>
+#include <string.h>
+#include <ctype.h>
+#include <algorithm>
+
+#ifdef _SDL_IMAGE
+    #include <SDL_image.h>
+#endif
+
+namespace
+{
+    typedef unsigned char           Byte;
+    typedef Image::FileData         ByteBuffer;
+
+    const unsigned int ReadBigEndian32(const Byte *const p)
+    {
+        return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | (unsigned int)p[3];
+    }
+
+    const unsigned int ReadLittleEndian32(const Byte *const p)
+    {
+        return ((unsigned int)p[3] << 24) | ((unsigned int)p[2] << 16) | ((unsigned int)p[1] << 8) | (unsigned int)p[0];
+    }
+
+    const unsigned int ReadLittleEndian16(const Byte *const p)
+    {
+        return ((unsigned int)p[1] << 8) | (unsigned int)p[0];
+    }
+
+    // Row converters
+    // Note: These convert a whole row at a time with the channel layout known at
+    //       compile time, so that the compiler is able to vectorize the loops.
+    //       A negative channel offset for alpha means the pixels are opaque.
+    template <int Stride, int R, int G, int B, int A>
+    void ConvertRow8(const Byte *const pSrc, Pixel<float> *const pDst, const int &width, const float &scale)
+    {
+        float *const pOut = &pDst->_r;
+        for(int x=0; x < width; ++x)
+        {
+            const Byte *const p = pSrc + x * Stride;
+            pOut[x*4 + 0] = p[R] * scale;
+            pOut[x*4 + 1] = p[G] * scale;
+            pOut[x*4 + 2] = p[B] * scale;
+            pOut[x*4 + 3] = (A < 0)? 1.0f: p[A] * scale;
+        }
+    }
+
+    // Same as above, for 16 bit big-endian samples (PNG, PNM)
+    template <int Stride, int R, int G, int B, int A>
+    void ConvertRow16(const Byte *const pSrc, Pixel<float> *const pDst, const int &width, const float &scale)
+    {
+        float *const pOut = &pDst->_r;
+        for(int x=0; x < width; ++x)
+        {
+            const Byte *const p = pSrc + x * Stride * 2;
+            pOut[x*4 + 0] = ((p[R*2] << 8) | p[R*2 + 1]) * scale;
+            pOut[x*4 + 1] = ((p[G*2] << 8) | p[G*2 + 1]) * scale;
+            pOut[x*4 + 2] = ((p[B*2] << 8) | p[B*2 + 1]) * scale;
+            pOut[x*4 + 3] = (A < 0)? 1.0f: ((p[A*2] << 8) | p[A*2 + 1]) * scale;
+        }
+    }
+
+    void ConvertRowIndexed(const Byte *const pSrc, Pixel<float> *const pDst, const int &width, const Pixel<float> *const pPalette)
+    {
+        for(int x=0; x < width; ++x)
+            pDst[x] = pPalette[ pSrc[x] ];
+    }
+
+    // Unpacks 1, 2 or 4 bit samples into one byte each; the samples are
+    // multiplied by the given factor (to stretch gray levels to 0..255).
+    void UnpackRow(const Byte *const pSrc, Byte *const pDst, const int &numSamples, const int &bitDepth, const int &factor)
+    {
+        const int samplesPerByte = 8 / bitDepth;
+        const int mask = (1 << bitDepth) - 1;
+        for(int i=0; i < numSamples; ++i)
+        {
+            const int shift = 8 - bitDepth * (1 + i % samplesPerByte);
+            pDst[i] = (Byte)(((pSrc[ i / samplesPerByte ] >> shift) & mask) * factor);
+        }
+    }
+
+    const int PaethPredictor(const int &a, const int &b, const int &c)
+    {
+        const int p  = a + b - c;
+        const int pa = Maths::Abs( p - a );
+        const int pb = Maths::Abs( p - b );
+        const int pc = Maths::Abs( p - c );
+
+        if( pa <= pb && pa <= pc )
+            return a;
+        if( pb <= pc )
+            return b;
+        return c;
+    }
+
+    // Reverses a PNG scanline filter in place; pPrev is the previous (already unfiltered) scanline.
+    const bool UnfilterRow(const int &filter, Byte *const pRow, const Byte *const pPrev, const std::size_t &rowBytes, const int &bytesPerPixel)
+    {
+        switch( filter )
+        {
+        case 0: // None
+            break;
+
+        case 1: // Sub
+            for(std::size_t i=bytesPerPixel; i < rowBytes; ++i)
+                pRow[i] = (Byte)(pRow[i] + pRow[i - bytesPerPixel]);
+            break;
+
+        case 2: // Up
+            for(std::size_t i=0; i < rowBytes; ++i)
+                pRow[i] = (Byte)(pRow[i] + pPrev[i]);
+            break;
+
+        case 3: // Average
+            for(int i=0; i < bytesPerPixel; ++i)
+                pRow[i] = (Byte)(pRow[i] + (pPrev[i] >> 1));
+            for(std::size_t i=bytesPerPixel; i < rowBytes; ++i)
+                pRow[i] = (Byte)(pRow[i] + ((pRow[i - bytesPerPixel] + pPrev[i]) >> 1));
+            break;
+
+        case 4: // Paeth
+            for(int i=0; i < bytesPerPixel; ++i)
+                pRow[i] = (Byte)(pRow[i] + pPrev[i]);
+            for(std::size_t i=bytesPerPixel; i < rowBytes; ++i)
+                pRow[i] = (Byte)(pRow[i] + PaethPredictor( pRow[i - bytesPerPixel], pPrev[i], pPrev[i - bytesPerPixel] ));
+            break;
+
+        default:
+            return false;
+        }
+
+        return true;
+    }
+
+    // Skips whitespace and comments in a PNM header
+    void SkipPNMWhitespace(const ByteBuffer &file, std::size_t &pos)
+    {
+        while( pos < file.size() )
+        {
+            if( file[pos] == '#' )
+            {
+                while( pos < file.size() && file[pos] != '\n' )
+                    ++pos;
+            }
+            else if( isspace( file[pos] ) )
+                ++pos;
+            else
+                break;
+        }
+    }
+
+    const bool ReadPNMToken(const ByteBuffer &file, std::size_t &pos, std::string &token)
+    {
+        SkipPNMWhitespace( file, pos );
+
+        token.clear();
+        while( pos < file.size() && !isspace( file[pos] ) && file[pos] != '#' )
+            token += (char)file[ pos++ ];
+
+        return !token.empty();
+    }
+
+    // The largest image we're willing to allocate
+    const bool IsValidSize(const int &width, const int &height)
+    {
+        return (width > 0) && (height > 0) && ((double)width * height <= (1 << 28));
+    }
+}
 
 // Constructor
-Image::Image() :
+Image::Image(const MemoryAccount::Subsystem &subsystem) :
     _width(0),
     _height(0),
     _numTotalPixels(0),
-    _pPixelData(0)
+    _pPixelData(0),
+    _memory( subsystem )
 {
 }
 
@@ -42,10 +212,107 @@ Image::~Image()
 
 // Functions
 
-const bool Image::SDL_Load(const std::string &fileName)
+const bool Image::Load(const std::string &fileName)
+{
+    FileData file;
+    if( !ReadFile( fileName, file ) )
+    {
+        std::cout << "Error: Failed to read image file: " << fileName << std::endl;
+        return false;
+    }
+
+    return Load( file, fileName );
+}
+
+const bool Image::Load(const FileData &file, const std::string &fileName)
+{
+    // Identify the format from the file's signature
+    Byte signature[8] = { 0 };
+    const std::size_t signatureSize = Maths::Min<std::size_t>( file.size(), sizeof(signature) );
+    if( signatureSize > 0 )
+        memcpy( signature, &file[0], signatureSize );
+
+    // The return value
+    bool bRetVal = false;
+    bool bHandled = false;
+
+    // Process the file according to the signature
+    BEGIN_CODE_BLOCK
+    {
+        // PNG
+        const Byte pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        if( signatureSize == 8 && memcmp( signature, pngSignature, 8 ) == 0 )
+        {
+            bHandled = true;
+            bRetVal = LoadPNG( file );
+            EXIT_CODE_BLOCK;
+        }
+
+        // Bitmap
+        if( signatureSize >= 2 && signature[0] == 'B' && signature[1] == 'M' )
+        {
+            bHandled = true;
+            bRetVal = LoadBMP( file );
+            EXIT_CODE_BLOCK;
+        }
+
+        // PGM, PPM and PFM
+        if( signatureSize >= 2 && signature[0] == 'P' &&
+            (signature[1] == '5' || signature[1] == '6' || signature[1] == 'f' || signature[1] == 'F') )
+        {
+            bHandled = true;
+            bRetVal = LoadPNM( file );
+            EXIT_CODE_BLOCK;
+        }
+
+        // Insert support for additional file formats just above this line.
+    }
+    END_CODE_BLOCK;
+
+    if( !bHandled )
+    {
+#ifdef _SDL_IMAGE
+        return SDL_Load( file );
+#else
+        std::cout << "Error: Unsupported image format: " << fileName << std::endl;
+        return false;
+#endif
+    }
+
+    // If the load was not successful, then
+    // clean up anything partially loaded
+    if( !bRetVal )
+        Release();
+
+    return bRetVal;
+}
+
+const bool Image::ReadFile(const std::string &fileName, FileData &file)
+{
+    FILE *const inF = fopen( fileName.c_str(), "rb" );
+    if( inF == (FILE *)NULL )
+        return false;
+
+    bool bRead = false;
+    if( fseek( inF, 0, SEEK_END ) == 0 )
+    {
+        const long fileSize = ftell( inF );
+        if( (fileSize > 0) && (fseek( inF, 0, SEEK_SET ) == 0) )
+        {
+            file.resize( fileSize );
+            bRead = (fread( &file[0], 1, file.size(), inF ) == file.size());
+        }
+    }
+
+    fclose( inF );
+    return bRead;
+}
+
+#ifdef _SDL_IMAGE
+const bool Image::SDL_Load(const FileData &file)
 {
     // Load the image using SDL_Image
-    SDL_Surface *pSurface = IMG_Load( fileName.c_str() );
+    SDL_Surface *pSurface = file.empty()? 0: IMG_Load_RW( SDL_RWFromConstMem( &file[0], (int)file.size() ), 1 );
     if( !pSurface )
     {
         // Get the SDL Error
@@ -70,6 +337,7 @@ const bool Image::SDL_Load(const std::string &fileName)
         _numTotalPixels = _width * _height;
 
         // Allocate memory to hold the pixel data
+        _memory.SetSize( _numTotalPixels * sizeof(Pixel<float>) );
         _pPixelData = new Pixel<float> [_numTotalPixels];
         if( !_pPixelData )
             EXIT_CODE_BLOCK;
@@ -115,6 +383,7 @@ const bool Image::SDL_Load(const std::string &fileName)
 
     return bRetVal;
 }
+#endif
 
 const bool Image::Create(const int &width, const int &height)
 {
@@ -132,6 +401,7 @@ const bool Image::Create(const int &width, const int &height)
         _numTotalPixels = _width * _height;
 
         // Allocate memory to hold the pixel data
+        _memory.SetSize( _numTotalPixels * sizeof(Pixel<float>) );
         _pPixelData = new Pixel<float> [_numTotalPixels];
         if( !_pPixelData )
             EXIT_CODE_BLOCK;
@@ -172,6 +442,13 @@ const bool Image::Save(const std::string &fileName) const
             EXIT_CODE_BLOCK;
         }
 
+        // Portable float map
+        if( Utility::String::CaseInsensitiveCompare( fileNameExt, "pfm" ) == 0 )
+        {
+            bRetVal = SavePFM( outF );
+            EXIT_CODE_BLOCK;
+        }
+
         // Insert support for additional file formats just above this line.
     }
     END_CODE_BLOCK;
@@ -189,6 +466,7 @@ void Image::Release()
     _numTotalPixels = 0;
 
     SafeDeleteArray( _pPixelData );
+    _memory.SetSize( 0 );
 }
 
 const int &Image::Width() const
@@ -409,3 +687,498 @@ const bool Image::SaveBMP(FILE *const outF) const
 
     return true;
 }
+
+const bool Image::SavePFM(FILE *const outF) const
+{
+    // The sign of the scale gives the byte order of the samples
+    fprintf( outF, "PF\n%d %d\n%s\n", _width, _height, Utility::ByteOrder::IsHostLittleEndian()? "-1.0": "1.0" );
+
+    // The rows are stored bottom-to-top
+    std::vector<float> row( _width * 3 );
+    for(int y = _height - 1; y >= 0; --y)
+    {
+        const Pixel<float> *const pSrc = _pPixelData + y * _width;
+        for(int x=0; x < _width; ++x)
+        {
+            row[x * 3 + 0] = pSrc[x]._r;
+            row[x * 3 + 1] = pSrc[x]._g;
+            row[x * 3 + 2] = pSrc[x]._b;
+        }
+
+        if( fwrite( &row[0], sizeof(float), row.size(), outF ) != row.size() )
+            return false;
+    }
+
+    return true;
+}
+
+const bool Image::LoadBMP(const FileData &file)
+{
+    if( file.size() < 14 + 40 )
+    {
+        std::cout << "Error: Truncated BMP file" << std::endl;
+        return false;
+    }
+
+    // File header and info header
+    const std::size_t pixelDataOffset   = ReadLittleEndian32( &file[10] );
+    const std::size_t infoHeaderSize    = ReadLittleEndian32( &file[14] );
+    const int width                     = (int)ReadLittleEndian32( &file[18] );
+    const int signedHeight              = (int)ReadLittleEndian32( &file[22] );
+    const int bitCount                  = ReadLittleEndian16( &file[28] );
+    const unsigned int compression      = ReadLittleEndian32( &file[30] );
+    const unsigned int numColorsUsed    = ReadLittleEndian32( &file[46] );
+
+    // Negative heights denote top-down bitmaps. The most negative height can't be negated;
+    // it's taken as 0, which is rejected as an invalid size below.
+    const bool bTopDown = (signedHeight < 0);
+    const int height    = !bTopDown? signedHeight: (signedHeight == std::numeric_limits<int>::min())? 0: -signedHeight;
+
+    if( infoHeaderSize < 40 || !IsValidSize( width, height ) )
+    {
+        std::cout << "Error: Unsupported BMP header" << std::endl;
+        return false;
+    }
+
+    // Channel masks; these follow the info header for BI_BITFIELDS (3)
+    unsigned int masks[4] = { 0, 0, 0, 0 };
+    if( compression == 3 )
+    {
+        const std::size_t maskOffset = 14 + 40;
+        const int numMasks = (infoHeaderSize >= 56)? 4: 3;
+        if( file.size() < maskOffset + numMasks * 4 )
+            return false;
+
+        for(int i=0; i < numMasks; ++i)
+            masks[i] = ReadLittleEndian32( &file[ maskOffset + i * 4 ] );
+    }
+    else if( compression != 0 )
+    {
+        std::cout << "Error: Compressed BMP files are not supported" << std::endl;
+        return false;
+    }
+
+    if( bitCount != 1 && bitCount != 4 && bitCount != 8 && bitCount != 16 && bitCount != 24 && bitCount != 32 )
+    {
+        std::cout << "Error: Unsupported BMP bit count: " << bitCount << std::endl;
+        return false;
+    }
+
+    // Palette (stored as BGRX) for the indexed formats
+    Pixel<float> palette[256];
+    if( bitCount <= 8 )
+    {
+        const std::size_t paletteOffset = 14 + infoHeaderSize + ((compression == 3 && infoHeaderSize == 40)? 12: 0);
+        const unsigned int numColors = (numColorsUsed > 0 && numColorsUsed <= 256)? numColorsUsed: (1u << bitCount);
+        if( file.size() < paletteOffset + numColors * 4 )
+            return false;
+
+        for(int i=0; i < 256; ++i)
+            palette[i].Set( 0, 0, 0, 1 );
+        ConvertRow8<4, 2, 1, 0, -1>( &file[ paletteOffset ], palette, numColors, 1.0f / 255.0f );
+    }
+
+    // Every scanline is dword aligned
+    const std::size_t rowBytes = (((std::size_t)width * bitCount + 31) / 32) * 4;
+    if( pixelDataOffset > file.size() || file.size() - pixelDataOffset < rowBytes * height )
+    {
+        std::cout << "Error: Truncated BMP file" << std::endl;
+        return false;
+    }
+
+    if( !Create( width, height ) )
+        return false;
+
+    // Derive the bit shifts and scales for bitfield formats
+    if( bitCount == 16 && compression == 0 )
+    {
+        masks[0] = 0x7C00; masks[1] = 0x03E0; masks[2] = 0x001F;
+    }
+    int maskShifts[4] = { 0, 0, 0, 0 };
+    float maskScales[4] = { 0, 0, 0, 0 };
+    for(int i=0; i < 4; ++i)
+    {
+        if( !masks[i] )
+            continue;
+
+        while( !((masks[i] >> maskShifts[i]) & 1) )
+            ++maskShifts[i];
+        maskScales[i] = 1.0f / (masks[i] >> maskShifts[i]);
+    }
+
+    // Use the straight row converters for the common layouts
+    const bool bStraightBGRA =
+        (bitCount == 32) && (compression == 0 ||
+        (masks[0] == 0x00FF0000 && masks[1] == 0x0000FF00 && masks[2] == 0x000000FF && (masks[3] == 0 || masks[3] == 0xFF000000)));
+    const bool bHasAlpha = (compression == 3) && (masks[3] != 0);
+
+    ByteBuffer unpacked( width );
+    for(int y=0; y < _height; ++y)
+    {
+        const Byte *const pSrc = &file[ pixelDataOffset + rowBytes * (bTopDown? y: (_height - 1 - y)) ];
+        Pixel<float> *const pDst = _pPixelData + y * _width;
+
+        if( bitCount == 24 )
+            ConvertRow8<3, 2, 1, 0, -1>( pSrc, pDst, _width, 1.0f / 255.0f );
+        else if( bStraightBGRA && bHasAlpha )
+            ConvertRow8<4, 2, 1, 0, 3>( pSrc, pDst, _width, 1.0f / 255.0f );
+        else if( bStraightBGRA )
+            ConvertRow8<4, 2, 1, 0, -1>( pSrc, pDst, _width, 1.0f / 255.0f );
+        else if( bitCount == 8 )
+            ConvertRowIndexed( pSrc, pDst, _width, palette );
+        else if( bitCount < 8 )
+        {
+            UnpackRow( pSrc, &unpacked[0], _width, bitCount, 1 );
+            ConvertRowIndexed( &unpacked[0], pDst, _width, palette );
+        }
+        else
+        {
+            // Generic bitfields (16 and 32 bit)
+            for(int x=0; x < _width; ++x)
+            {
+                const unsigned int value = (bitCount == 16)?
+                    ReadLittleEndian16( pSrc + x * 2 ):
+                    ReadLittleEndian32( pSrc + x * 4 );
+
+                pDst[x].Set(
+                    ((value & masks[0]) >> maskShifts[0]) * maskScales[0],
+                    ((value & masks[1]) >> maskShifts[1]) * maskScales[1],
+                    ((value & masks[2]) >> maskShifts[2]) * maskScales[2],
+                    masks[3]? ((value & masks[3]) >> maskShifts[3]) * maskScales[3]: 1.0f );
+            }
+        }
+    }
+
+    return true;
+}
+
+const bool Image::LoadPNG(const FileData &file)
+{
+    int width = 0, height = 0, bitDepth = 0, colorType = -1, interlace = 0;
+    bool bHeader = false;
+
+    Pixel<float> palette[256];
+    for(int i=0; i < 256; ++i)
+        palette[i].Set( 0, 0, 0, 1 );
+
+    bool bColorKey = false;
+    unsigned int colorKey[3] = { 0, 0, 0 };
+
+    ByteBuffer compressed;
+
+    // Go through all the chunks
+    // Note: Chunk CRCs are not verified.
+    std::size_t pos = 8;
+    while( pos + 12 <= file.size() )
+    {
+        const std::size_t length = ReadBigEndian32( &file[pos] );
+        const Byte *const pType  = &file[pos + 4];
+        const Byte *const pData  = &file[pos + 8];
+        if( length > file.size() - pos - 12 )
+        {
+            std::cout << "Error: Truncated PNG file" << std::endl;
+            return false;
+        }
+
+        if( memcmp( pType, "IHDR", 4 ) == 0 && length >= 13 )
+        {
+            width       = (int)ReadBigEndian32( pData );
+            height      = (int)ReadBigEndian32( pData + 4 );
+            bitDepth    = pData[8];
+            colorType   = pData[9];
+            interlace   = pData[12];
+            bHeader     = true;
+
+            if( pData[10] != 0 || pData[11] != 0 || interlace > 1 )
+            {
+                std::cout << "Error: Unsupported PNG compression, filter or interlace method" << std::endl;
+                return false;
+            }
+        }
+        else if( memcmp( pType, "PLTE", 4 ) == 0 )
+        {
+            const int numColors = Maths::Min<int>( (int)length / 3, 256 );
+            ConvertRow8<3, 0, 1, 2, -1>( pData, palette, numColors, 1.0f / 255.0f );
+        }
+        else if( memcmp( pType, "tRNS", 4 ) == 0 )
+        {
+            if( colorType == 3 )
+            {
+                for(std::size_t i=0; i < length && i < 256; ++i)
+                    palette[i]._a = pData[i] * (1.0f / 255.0f);
+            }
+            else if( colorType == 0 && length >= 2 )
+            {
+                bColorKey = true;
+                colorKey[0] = colorKey[1] = colorKey[2] = (pData[0] << 8) | pData[1];
+            }
+            else if( colorType == 2 && length >= 6 )
+            {
+                bColorKey = true;
+                for(int i=0; i < 3; ++i)
+                    colorKey[i] = (pData[i*2] << 8) | pData[i*2 + 1];
+            }
+        }
+        else if( memcmp( pType, "IDAT", 4 ) == 0 )
+        {
+            compressed.insert( compressed.end(), pData, pData + length );
+        }
+        else if( memcmp( pType, "IEND", 4 ) == 0 )
+            break;
+
+        pos += 12 + length;
+    }
+
+    // Validate the header
+    int numChannels = 0;
+    switch( colorType )
+    {
+    case 0: numChannels = 1; break; // Gray
+    case 2: numChannels = 3; break; // RGB
+    case 3: numChannels = 1; break; // Indexed
+    case 4: numChannels = 2; break; // Gray + Alpha
+    case 6: numChannels = 4; break; // RGBA
+    }
+
+    const bool bValidDepth =
+        (bitDepth == 8) ||
+        (bitDepth == 16 && colorType != 3) ||
+        ((bitDepth == 1 || bitDepth == 2 || bitDepth == 4) && (colorType == 0 || colorType == 3));
+
+    if( !bHeader || !numChannels || !bValidDepth || !IsValidSize( width, height ) )
+    {
+        std::cout << "Error: Invalid or unsupported PNG header" << std::endl;
+        return false;
+    }
+
+    const int bitsPerPixel  = numChannels * bitDepth;
+    const int bytesPerPixel = Maths::Max<int>( 1, bitsPerPixel / 8 );
+
+    // The Adam7 passes; a non-interlaced image is a single pass covering every pixel.
+    const int numPasses = interlace? 7: 1;
+    const int passStartX[7] = { 0, 4, 0, 2, 0, 1, 0 };
+    const int passStartY[7] = { 0, 0, 4, 0, 2, 0, 1 };
+    const int passStepX[7]  = { 8, 8, 4, 4, 2, 2, 1 };
+    const int passStepY[7]  = { 8, 8, 8, 4, 4, 2, 2 };
+
+    // Work out the size of the decompressed data
+    std::size_t expectedSize = 0;
+    for(int pass=0; pass < numPasses; ++pass)
+    {
+        const int stepX = interlace? passStepX[pass]: 1;
+        const int stepY = interlace? passStepY[pass]: 1;
+        const int passWidth  = (width  - (interlace? passStartX[pass]: 0) + stepX - 1) / stepX;
+        const int passHeight = (height - (interlace? passStartY[pass]: 0) + stepY - 1) / stepY;
+        if( passWidth > 0 && passHeight > 0 )
+            expectedSize += passHeight * (1 + ((std::size_t)passWidth * bitsPerPixel + 7) / 8);
+    }
+
+    // Decompress the image data
+    ByteBuffer data;
+    data.reserve( expectedSize );
+    {
+        Inflate inflate;
+        if( compressed.empty()                                                  ||
+            !inflate.DecompressZlib( &compressed[0], compressed.size(), data )  ||
+            data.size() < expectedSize                                          )
+        {
+            std::cout << "Error: Corrupt PNG image data" << std::endl;
+            return false;
+        }
+    }
+    ByteBuffer().swap( compressed );
+
+    if( !Create( width, height ) )
+        return false;
+
+    // Scratch rows
+    const std::size_t maxRowBytes = ((std::size_t)width * bitsPerPixel + 7) / 8;
+    ByteBuffer previousRow( maxRowBytes + bytesPerPixel, 0 );
+    ByteBuffer unpacked( width );
+    std::vector< Pixel<float> > passRow( interlace? width: 0, Pixel<float>( 0, 0, 0, 0 ) );
+
+    const float scale8  = 1.0f / 255.0f;
+    const float scale16 = 1.0f / 65535.0f;
+    const int grayFactor = 255 / ((1 << bitDepth) - 1);
+
+    // Colour key in our pixel format
+    Pixel<float> keyPixel( 0, 0, 0, 0 );
+    if( bColorKey )
+    {
+        const float keyScale = (bitDepth == 16)? scale16: (grayFactor * scale8);
+        keyPixel.Set( colorKey[0] * keyScale, colorKey[1] * keyScale, colorKey[2] * keyScale, 1 );
+    }
+
+    std::size_t dataPos = 0;
+    for(int pass=0; pass < numPasses; ++pass)
+    {
+        const int startX = interlace? passStartX[pass]: 0;
+        const int startY = interlace? passStartY[pass]: 0;
+        const int stepX  = interlace? passStepX[pass]: 1;
+        const int stepY  = interlace? passStepY[pass]: 1;
+        const int passWidth  = (width  - startX + stepX - 1) / stepX;
+        const int passHeight = (height - startY + stepY - 1) / stepY;
+        if( passWidth <= 0 || passHeight <= 0 )
+            continue;
+
+        const std::size_t rowBytes = ((std::size_t)passWidth * bitsPerPixel + 7) / 8;
+        std::fill( previousRow.begin(), previousRow.end(), 0 );
+
+        for(int py=0; py < passHeight; ++py)
+        {
+            const int filter = data[ dataPos ];
+            Byte *const pRow = &data[ dataPos + 1 ];
+            dataPos += 1 + rowBytes;
+
+            if( !UnfilterRow( filter, pRow, &previousRow[0], rowBytes, bytesPerPixel ) )
+            {
+                std::cout << "Error: Invalid PNG filter type: " << filter << std::endl;
+                return false;
+            }
+
+            // Non-interlaced rows are converted straight into the image
+            const int y = startY + py * stepY;
+            Pixel<float> *const pDst = interlace? &passRow[0]: (_pPixelData + y * _width);
+
+            if( bitDepth < 8 )
+            {
+                UnpackRow( pRow, &unpacked[0], passWidth, bitDepth, (colorType == 3)? 1: grayFactor );
+                if( colorType == 3 )
+                    ConvertRowIndexed( &unpacked[0], pDst, passWidth, palette );
+                else
+                    ConvertRow8<1, 0, 0, 0, -1>( &unpacked[0], pDst, passWidth, scale8 );
+            }
+            else if( bitDepth == 8 )
+            {
+                switch( colorType )
+                {
+                case 0: ConvertRow8<1, 0, 0, 0, -1>( pRow, pDst, passWidth, scale8 );   break;
+                case 2: ConvertRow8<3, 0, 1, 2, -1>( pRow, pDst, passWidth, scale8 );   break;
+                case 3: ConvertRowIndexed( pRow, pDst, passWidth, palette );            break;
+                case 4: ConvertRow8<2, 0, 0, 0, 1>( pRow, pDst, passWidth, scale8 );    break;
+                case 6: ConvertRow8<4, 0, 1, 2, 3>( pRow, pDst, passWidth, scale8 );    break;
+                }
+            }
+            else
+            {
+                switch( colorType )
+                {
+                case 0: ConvertRow16<1, 0, 0, 0, -1>( pRow, pDst, passWidth, scale16 ); break;
+                case 2: ConvertRow16<3, 0, 1, 2, -1>( pRow, pDst, passWidth, scale16 ); break;
+                case 4: ConvertRow16<2, 0, 0, 0, 1>( pRow, pDst, passWidth, scale16 );  break;
+                case 6: ConvertRow16<4, 0, 1, 2, 3>( pRow, pDst, passWidth, scale16 );  break;
+                }
+            }
+
+            // Pixels matching the colour key are transparent
+            if( bColorKey )
+            {
+                for(int x=0; x < passWidth; ++x)
+                {
+                    if( pDst[x]._r == keyPixel._r && pDst[x]._g == keyPixel._g && pDst[x]._b == keyPixel._b )
+                        pDst[x]._a = 0;
+                }
+            }
+
+            // Scatter interlaced rows into the image
+            if( interlace )
+            {
+                for(int px=0; px < passWidth; ++px)
+                    _pPixelData[ y * _width + startX + px * stepX ] = passRow[px];
+            }
+
+            memcpy( &previousRow[0], pRow, rowBytes );
+        }
+    }
+
+    return true;
+}
+
+const bool Image::LoadPNM(const FileData &file)
+{
+    // Read the header
+    std::string magic, widthStr, heightStr, maxValueStr;
+    std::size_t pos = 0;
+    int width = 0, height = 0;
+    float maxValue = 0;
+    if( !ReadPNMToken( file, pos, magic )                           ||
+        !ReadPNMToken( file, pos, widthStr )                        ||
+        !ReadPNMToken( file, pos, heightStr )                       ||
+        !ReadPNMToken( file, pos, maxValueStr )                     ||
+        !Utility::String::FromString( width, widthStr )             ||
+        !Utility::String::FromString( height, heightStr )           ||
+        !Utility::String::FromString( maxValue, maxValueStr )       ||
+        !IsValidSize( width, height )                               ||
+        maxValue == 0                                               ||
+        pos >= file.size()                                          )
+    {
+        std::cout << "Error: Invalid PNM header" << std::endl;
+        return false;
+    }
+
+    // A single whitespace character separates the header from the data
+    ++pos;
+
+    const bool bFloat = (magic == "PF" || magic == "Pf");
+    const int numChannels = (magic == "P6" || magic == "PF")? 3: 1;
+    const int bytesPerSample = bFloat? 4: ((maxValue < 256)? 1: 2);
+    const std::size_t rowBytes = (std::size_t)width * numChannels * bytesPerSample;
+
+    if( file.size() - pos < rowBytes * height )
+    {
+        std::cout << "Error: Truncated PNM file" << std::endl;
+        return false;
+    }
+
+    if( !Create( width, height ) )
+        return false;
+
+    // PFM stores the byte order in the sign of the scale, and its rows bottom-to-top
+    const bool bSwapBytes = bFloat && ((maxValue < 0) != Utility::ByteOrder::IsHostLittleEndian());
+    const float scale = 1.0f / Maths::Abs( maxValue );
+
+    std::vector<float> floatRow( bFloat? (width * numChannels): 0 );
+    for(int y=0; y < _height; ++y)
+    {
+        const Byte *const pSrc = &file[ pos + rowBytes * (bFloat? (_height - 1 - y): y) ];
+        Pixel<float> *const pDst = _pPixelData + y * _width;
+
+        if( bFloat )
+        {
+            // Note: The PFM scale only gives the byte order and an absolute
+            //       luminance hint; the samples are used as they are.
+            memcpy( &floatRow[0], pSrc, rowBytes );
+            if( bSwapBytes )
+            {
+                Byte *const pBytes = reinterpret_cast<Byte *>( &floatRow[0] );
+                for(std::size_t i=0; i < rowBytes; i += 4)
+                {
+                    std::swap( pBytes[i + 0], pBytes[i + 3] );
+                    std::swap( pBytes[i + 1], pBytes[i + 2] );
+                }
+            }
+
+            for(int x=0; x < _width; ++x)
+            {
+                const float *const p = &floatRow[ x * numChannels ];
+                pDst[x].Set( p[0], p[(numChannels == 3)? 1: 0], p[(numChannels == 3)? 2: 0], 1 );
+            }
+        }
+        else if( bytesPerSample == 1 )
+        {
+            if( numChannels == 3 )
+                ConvertRow8<3, 0, 1, 2, -1>( pSrc, pDst, _width, scale );
+            else
+                ConvertRow8<1, 0, 0, 0, -1>( pSrc, pDst, _width, scale );
+        }
+        else
+        {
+            if( numChannels == 3 )
+                ConvertRow16<3, 0, 1, 2, -1>( pSrc, pDst, _width, scale );
+            else
+                ConvertRow16<1, 0, 0, 0, -1>( pSrc, pDst, _width, scale );
+        }
+    }
+
+    return true;
+}
@@ -19,21 +19,28 @@
 #define IMAGE_HEADER
 
 #include "Pixel.h"
+#include "MemoryAccount.h"
 #include <string>
+#include <vector>
 #include <stdio.h>
 
 class Image
 {
+// Types
+public:
+    typedef std::vector<unsigned char>  FileData;   // The contents of an image file, as it's stored
+
 // Members
 private:
     int              _width;
 	int              _height;
 	int              _numTotalPixels;
 	Pixel<float>    *_pPixelData;
+    MemoryAccount::Allocation _memory;
 
 public:
     // Constructor
-    explicit Image();
+    explicit Image(const MemoryAccount::Subsystem &subsystem = MemoryAccount::Subsystem_Images);
     // Destructor
     ~Image();
 
@@ -45,10 +52,29 @@ private:
     // Functions
 private:
     const bool SaveBMP(FILE *const outF) const;
+    const bool SavePFM(FILE *const outF) const;   // Colour PFM, which keeps the pixels as they are (unbounded)
+
+    // Native decoders; these decode whole rows straight into our pixel format.
+    const bool LoadBMP(const FileData &file);
+    const bool LoadPNG(const FileData &file);
+    const bool LoadPNM(const FileData &file);   // Binary PGM/PPM (P5/P6) and PFM (Pf/PF)
 
 public:
-    // Load using SDL_Image's IMG_Load() function.
-    const bool SDL_Load(const std::string &fileName);
+    // Load using the native decoders; other formats are handed
+    // over to SDL_Load() if SDL_Image support has been compiled in.
+    const bool Load(const std::string &fileName);
+
+    // As above, from the contents of an image file (see ReadFile()) rather than the file itself.
+    // The file name is only used in messages.
+    const bool Load(const FileData &file, const std::string &fileName);
+
+    // Reads the whole of an image file with a single read, without decoding it.
+    static const bool ReadFile(const std::string &fileName, FileData &file);
+
+#ifdef _SDL_IMAGE
+    // Load using SDL_Image's IMG_Load_RW() function.
+    const bool SDL_Load(const FileData &file);
+#endif
 
     // Create a new empty image with the specified dimensions.
     const bool Create(const int &width, const int &height);
@@ -16,18 +16,21 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Texture.h"
+#include "Scene.h"
 #include "ObjectFactory.h"
 #include "Deserializer.h"
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
 #include "Utility.h"
+#include "Statistics.h"
+#include "Trace.h"
 
 // Register with the ObjectFactory
 ObjectFactory_Register(Serializable, Texture);
 
 // Constructor
 Texture::Texture() :
-    _image(),
+    _image( MemoryAccount::Subsystem_Textures ),
     _fileName()
 {
 }
@@ -47,13 +50,44 @@ const std::string &Texture::FileName() const
     return _fileName;
 }
 
+const Image &Texture::GetImage() const
+{
+    return _image;
+}
+
 const bool Texture::Load(const std::string &fileName)
 {
     // Release the previous one
     _image.Release();
     _fileName.clear();
 
-    if( !_image.SDL_Load( fileName ) )
+    STATISTICS_START_PHASE( Phase_TextureLoad );
+    Trace::Scope traceScope( "Load texture", fileName );
+    const bool bLoaded = _image.Load( fileName );
+    traceScope.End();
+    STATISTICS_END_PHASE( Phase_TextureLoad );
+
+    if( !bLoaded )
+        return false;
+
+    _fileName = fileName;
+
+    return true;
+}
+
+const bool Texture::Load(const Image::FileData &file, const std::string &fileName)
+{
+    // Release the previous one
+    _image.Release();
+    _fileName.clear();
+
+    STATISTICS_START_PHASE( Phase_TextureLoad );
+    Trace::Scope traceScope( "Load texture", fileName );
+    const bool bLoaded = _image.Load( file, fileName );
+    traceScope.End();
+    STATISTICS_END_PHASE( Phase_TextureLoad );
+
+    if( !bLoaded )
         return false;
 
     _fileName = fileName;
@@ -68,7 +102,7 @@ const Pixel<float> Texture::GetPixel(const float &tu, const float &tv) const
 
 // Serializable's functions
 
-const bool Texture::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Texture::Read(Deserializer &d, void *const pUserData)
 {
     DESERIALIZE_CLASS( object, d, Texture )
     {
@@ -89,7 +123,26 @@ const bool Texture::Read(Deserializer &d, void *const /*pUserData*/)
                 break;
             }
 
-            if( !Load( fileName ) )
+            // A Scene may be read along with the contents of its texture files (see Scene::Read()), which
+            // are used instead of the files on this machine
+            const Scene *const pScene = static_cast<const Scene *>( pUserData );
+            const Scene::TextureFileMap *const pTextureFiles = pScene? pScene->TextureFiles(): 0;
+            if( pTextureFiles )
+            {
+                const Scene::TextureFileMap::const_iterator itr = pTextureFiles->find( fileName );
+                if( itr == pTextureFiles->end() )
+                {
+                    d.Log << "Error: The contents of the texture file weren't given: " << fileName << endl;
+                    break;
+                }
+
+                if( !Load( itr->second, fileName ) )
+                {
+                    d.Log << "Error: Failed to load image from the contents of file: " << fileName << endl;
+                    break;
+                }
+            }
+            else if( !Load( fileName ) )
             {
                 d.Log << "Error: Failed to load image from file: " << fileName << endl;
                 break;
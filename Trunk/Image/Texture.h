@@ -44,8 +44,12 @@ private:
 public:
     // Accessors
     const std::string &FileName() const;
+    const Image &GetImage() const;
 
     const bool Load(const std::string &fileName);
+
+    // Loads the texture from the contents of its file (see Image::ReadFile()), rather than the file itself
+    const bool Load(const Image::FileData &file, const std::string &fileName);
     const Pixel<float> GetPixel(const float &tu, const float &tv) const;
 
     // Serializable's functions
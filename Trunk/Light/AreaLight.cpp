@@ -32,7 +32,12 @@ ObjectFactory_Register(Serializable, AreaLight);
 
 // Constructor
 AreaLight::AreaLight() :
-    _positions()
+    _positions(),
+    _sampleOffsets(),
+    _horizontalEdge( 0 ),
+    _verticalEdge( 0 ),
+    _bStratifiedSampling( false ),
+    _numProbeSamples( 0 )
 {
 }
 
@@ -42,6 +47,110 @@ AreaLight::~AreaLight()
 }
 
 // Functions
+const Vector<float> AreaLight::GetSamplePosition(const int &sampleIndex, const Vector<float> &rotation) const
+{
+    if( !_bStratifiedSampling )
+        return _positions[sampleIndex];
+
+    // Rotate the sample offset (wrapping around the unit square)
+    const Vector<float> &offset = _sampleOffsets[sampleIndex];
+
+    float u = offset.x + rotation.x;
+    float v = offset.y + rotation.y;
+    if( u >= 1 ) u -= 1;
+    if( v >= 1 ) v -= 1;
+
+    return _v1 + _horizontalEdge * u + _verticalEdge * v;
+}
+
+void AreaLight::AccumulateIllumination(
+    const Ray           &ray,
+    const Vector<float> &surfaceNormal,
+    const float         &surfaceRoughness,
+    const Vector<float> &lightRayDirection,
+    const float         &lightRayLength,
+    const Color         &illuminationFromLight,
+    Color &diffuse,
+    Color &specular ) const
+{
+    // Calculate the illumination at the point on the surface
+    const Color illumination = illuminationFromLight * ( 1 - lightRayLength * _oneOverRange );
+
+    // Accumulate the diffuse
+    diffuse += illumination * Maths::Max<float>(0, surfaceNormal.Dot( lightRayDirection ));
+
+    // Accumulate the specular
+    specular += illuminationFromLight * powf( Maths::Max<float>(0, ray.Direction().Dot( lightRayDirection.Reflect( surfaceNormal ) ) ), surfaceRoughness );
+}
+
+void AreaLight::AccumulateSamples(
+    const Ray           &ray,
+    const Vector<float> &surfaceNormal,
+    const float         &surfaceRoughness,
+    const Scene         &scene,
+    const Vector<float> &rotation,
+    const int           &beginSample,
+    const int           &endSample,
+    const bool          &bTestOcclusion,
+    int &numInRange,
+    int &numVisible,
+    int &numOccluded,
+    Color &diffuse,
+    Color &specular ) const
+{
+    Vector<float>   lightRayDirections[MaxPacketSize];
+    float           lightRayLengths[MaxPacketSize];
+    Color           illuminations[MaxPacketSize];
+
+    // Go through the samples, a packet at a time
+    for(int packetBegin = beginSample; packetBegin < endSample; packetBegin += MaxPacketSize)
+    {
+        const int packetEnd = Maths::Min<int>( packetBegin + MaxPacketSize, endSample );
+
+        // Gather the light rays which are in range
+        int numLightRays = 0;
+        for(int i = packetBegin; i < packetEnd; ++i)
+        {
+            Vector<float> &lightRayDirection = lightRayDirections[numLightRays];
+            lightRayDirection = GetSamplePosition( i, rotation ) - ray.Origin();
+            lightRayLengths[numLightRays] = lightRayDirection.Normalize();
+
+            // If the light is out of range of the surface
+            if( lightRayLengths[numLightRays] > _range )
+                continue;
+
+            ++numLightRays;
+        }
+
+        // The illumination from this light along each light ray
+        if( bTestOcclusion )
+        {
+            Illumination( ray, lightRayDirections, lightRayLengths, numLightRays, scene, illuminations );
+        }
+        else
+        {
+            for(int i=0; i < numLightRays; ++i)
+                illuminations[i] = Illumination();
+        }
+
+        for(int i=0; i < numLightRays; ++i)
+        {
+            const Color &illuminationFromLight = illuminations[i];
+
+            // Keep track of how many light rays could see the light
+            ++numInRange;
+            if( illuminationFromLight.Magnitude2() < Maths::Tolerance )
+            {
+                ++numOccluded;
+                continue;
+            }
+            if( (illuminationFromLight - Illumination()).Magnitude2() < Maths::Tolerance )
+                ++numVisible;
+
+            AccumulateIllumination( ray, surfaceNormal, surfaceRoughness, lightRayDirections[i], lightRayLengths[i], illuminationFromLight, diffuse, specular );
+        }
+    }
+}
 
 void AreaLight::SetRectangularArea(
     const Vector<float> &v1,
@@ -56,10 +165,13 @@ void AreaLight::SetRectangularArea(
     _numHorizontalSamples   = numHorizontalSamples; // Only for Serializing later
     _numVerticalSamples     = numVerticalSamples;   // Only for Serializing later
 
-    Vector<float> nx = v3 - v2;
+    _horizontalEdge = v3 - v2;
+    _verticalEdge   = v2 - v1;
+
+    Vector<float> nx = _horizontalEdge;
     const float width = nx.Normalize();
 
-    Vector<float> ny = v2 - v1;
+    Vector<float> ny = _verticalEdge;
     const float height = ny.Normalize();
 
     // Clear any existing positions
@@ -74,6 +186,23 @@ void AreaLight::SetRectangularArea(
             nx * ((x + 0.25f + Maths::GenerateRandomValue() * 0.5f) * width / numHorizontalSamples) +
             ny * ((y + 0.25f + Maths::GenerateRandomValue() * 0.5f) * height / numVerticalSamples) );
     }
+
+    // Create the offsets for stratified sampling; these are rotated differently for each point on a surface
+    _sampleOffsets.clear();
+
+    const int numSamples = numHorizontalSamples * numVerticalSamples;
+    for(int i=0; i < numSamples; ++i)
+        _sampleOffsets.push_back( Vector<float>( Maths::RadicalInverse( i, 2 ), Maths::RadicalInverse( i, 3 ), 0 ) );
+}
+
+void AreaLight::SetStratifiedSampling(const bool &bStratifiedSampling)
+{
+    _bStratifiedSampling = bStratifiedSampling;
+}
+
+void AreaLight::SetAdaptiveSampling(const int &numProbeSamples)
+{
+    _numProbeSamples = Maths::Max( 0, numProbeSamples );
 }
 
 // Note: This functionality should be moved into another class (could be SphericalAreaLight)
@@ -111,40 +240,71 @@ void AreaLight::AccumulateIlluminationAtSurface(
     if( _positions.empty() )
         return;
 
+    const int numSamples = (int)_positions.size();
+
+    // A random rotation of the sample offsets, for this point on the surface
+    Vector<float> rotation( 0 );
+    if( _bStratifiedSampling )
+        rotation.Set( Maths::GenerateRandomValue(), Maths::GenerateRandomValue(), 0 );
+
+    // The no. of samples which are definitely tested for occlusion
+    const int numProbeSamples = (_bStratifiedSampling && (_numProbeSamples > 0))? Maths::Min( _numProbeSamples, numSamples ): numSamples;
+
     Color areaLightDiffuse( 0 );
     Color areaLightSpecular( 0 );
 
-    // Accumulate the illumination from all the positions
-    FOR_EACH( itr, VectorList, _positions )
-    {
-        const Vector<float> &lightPosition = (*itr);
+    int numInRange  = 0;
+    int numVisible  = 0;
+    int numOccluded = 0;
 
-        Vector<float> lightRayDirection = lightPosition - ray.Origin();
-        const float lightRayLength = lightRayDirection.Normalize();
+    // Accumulate the illumination from the probes
+    AccumulateSamples( ray, surfaceNormal, surfaceRoughness, scene, rotation, 0, numProbeSamples, true, numInRange, numVisible, numOccluded, areaLightDiffuse, areaLightSpecular );
 
-        // If the light is out of range of the surface
-        if( lightRayLength > _range )
-            continue;
+    if( numProbeSamples < numSamples )
+    {
+        const bool bAllVisible  = (numInRange > 0) && (numVisible == numInRange);
+        const bool bAllOccluded = (numInRange > 0) && (numOccluded == numInRange);
 
-        // The illumination from this light
-        const Ray lightRay( ray.Origin(), lightRayDirection, ray );
-        const Color illuminationFromLight = Illumination( lightRay, lightRayLength, scene );
+        // If none of the probes could see the light, then assume that the rest of the samples can't either.
+        // If all of them could, then assume that the rest can too, and don't test them for occlusion.
+        // Otherwise we're in the penumbra, so test the rest of the samples too.
+        if( !bAllOccluded )
+            AccumulateSamples( ray, surfaceNormal, surfaceRoughness, scene, rotation, numProbeSamples, numSamples, !bAllVisible, numInRange, numVisible, numOccluded, areaLightDiffuse, areaLightSpecular );
+    }
+
+    diffuse += areaLightDiffuse * (1.0f / numSamples);
+    specular += areaLightSpecular * (1.0f / numSamples);
+}
 
-        if( illuminationFromLight.Magnitude2() < Maths::Tolerance )
-            continue;
+const int AreaLight::NumSamples() const
+{
+    return (int)_positions.size();
+}
 
-        // Calculate the illumination at the point on the surface
-        const Color illumination = illuminationFromLight * ( 1 - lightRayLength * _oneOverRange );
+void AreaLight::GetBounds(Vector<float> &min, Vector<float> &max) const
+{
+    // The four corners of the rectangle
+    const Vector<float> v4 = _v1 + (_v3 - _v2);
 
-        // Accumulate the diffuse
-        areaLightDiffuse += illumination * Maths::Max<float>(0, surfaceNormal.Dot( lightRayDirection ));
+    min = _v1;
+    max = _v1;
 
-        // Accumulate the specular
-        areaLightSpecular += illuminationFromLight * powf( Maths::Max<float>(0, ray.Direction().Dot( lightRayDirection.Reflect( surfaceNormal ) ) ), surfaceRoughness );
+    for(int i=0; i < 3; ++i)
+    {
+        min.v[i] = Maths::Min( Maths::Min( min.v[i], _v2.v[i] ), Maths::Min( _v3.v[i], v4.v[i] ) );
+        max.v[i] = Maths::Max( Maths::Max( max.v[i], _v2.v[i] ), Maths::Max( _v3.v[i], v4.v[i] ) );
     }
+}
+
+void AreaLight::Translate(const Vector<float> &offset)
+{
+    // The fixed positions move along, rather than being chosen again (as SetRectangularArea() would)
+    _v1 += offset;
+    _v2 += offset;
+    _v3 += offset;
 
-    diffuse += areaLightDiffuse * (1.0f / _positions.size());
-    specular += areaLightSpecular * (1.0f / _positions.size());
+    for(std::size_t i=0; i < _positions.size(); ++i)
+        _positions[i] += offset;
 }
 
 // Serializable's functions
@@ -158,14 +318,20 @@ const bool AreaLight::Read(Deserializer &d, void *const /*pUserData*/)
 
         Vector<float> vertex1, vertex2, vertex3;
         int numHorizontalSamples, numVerticalSamples;
-        if( !d.ReadObject( "vertex1", vertex1 )                             ||
-            !d.ReadObject( "vertex2", vertex2 )                             ||
-            !d.ReadObject( "vertex3", vertex3 )                             ||
-            !d.ReadObject( "numHorizontalSamples", numHorizontalSamples )   ||
-            !d.ReadObject( "numVerticalSamples", numVerticalSamples )       )
+        bool bStratifiedSampling;
+        int numProbeSamples;
+        if( !d.ReadObject( "vertex1", vertex1 )                               ||
+            !d.ReadObject( "vertex2", vertex2 )                               ||
+            !d.ReadObject( "vertex3", vertex3 )                               ||
+            !d.ReadObject( "numHorizontalSamples", numHorizontalSamples )     ||
+            !d.ReadObject( "numVerticalSamples", numVerticalSamples )         ||
+            !d.ReadObject( "stratifiedSampling", bStratifiedSampling, false ) ||
+            !d.ReadObject( "numProbeSamples", numProbeSamples, 0 )            )
             break;
 
         SetRectangularArea( vertex1, vertex2, vertex3, numHorizontalSamples, numVerticalSamples );
+        SetStratifiedSampling( bStratifiedSampling );
+        SetAdaptiveSampling( numProbeSamples );
     }
 
     return object.ReadResult();
@@ -179,11 +345,13 @@ const bool AreaLight::Write(Serializer &s) const
         if( !Light::Write( s ) )
             break;
 
-        if( !s.WriteObject( "vertex1", _v1 )                                ||
-            !s.WriteObject( "vertex2", _v2 )                                ||
-            !s.WriteObject( "vertex3", _v3 )                                ||
-            !s.WriteObject( "numHorizontalSamples", _numHorizontalSamples ) ||
-            !s.WriteObject( "numVerticalSamples", _numVerticalSamples )     )
+        if( !s.WriteObject( "vertex1", _v1 )                                    ||
+            !s.WriteObject( "vertex2", _v2 )                                    ||
+            !s.WriteObject( "vertex3", _v3 )                                    ||
+            !s.WriteObject( "numHorizontalSamples", _numHorizontalSamples )     ||
+            !s.WriteObject( "numVerticalSamples", _numVerticalSamples )         ||
+            !s.WriteObject( "stratifiedSampling", _bStratifiedSampling, false ) ||
+            !s.WriteObject( "numProbeSamples", _numProbeSamples, 0 )            )
             break;
     }
 
@@ -28,7 +28,14 @@ class AreaLight : public Light
 // Members
 private:
     typedef std::vector<Vector<float> >  VectorList;
-    VectorList  _positions;
+    VectorList  _positions;         // Fixed positions, shared by all points on surfaces
+    VectorList  _sampleOffsets;     // Halton sequence in the unit square, used for stratified sampling
+
+    Vector<float>   _horizontalEdge;
+    Vector<float>   _verticalEdge;
+
+    bool            _bStratifiedSampling;   // Choose new positions for every point on a surface
+    int             _numProbeSamples;       // Adaptive sampling: No. of samples taken before deciding whether to take the rest
 
     // For Serializing
     Vector<float>   _v1;
@@ -44,6 +51,37 @@ public:
     virtual ~AreaLight();
 
 // Functions
+private:
+    const Vector<float> GetSamplePosition(const int &sampleIndex, const Vector<float> &rotation) const;
+
+    // Accumulates the illumination from a single position on the light, given its unoccluded illumination
+    void AccumulateIllumination(
+        const Ray           &ray,
+        const Vector<float> &surfaceNormal,
+        const float         &surfaceRoughness,
+        const Vector<float> &lightRayDirection,
+        const float         &lightRayLength,
+        const Color         &illuminationFromLight,
+        Color &diffuse,
+        Color &specular ) const;
+
+    // Accumulates the illumination from the samples in the range [beginSample, endSample), testing them for
+    // occlusion a packet at a time, and counts how many of them are in range, visible and occluded.
+    void AccumulateSamples(
+        const Ray           &ray,
+        const Vector<float> &surfaceNormal,
+        const float         &surfaceRoughness,
+        const Scene         &scene,
+        const Vector<float> &rotation,
+        const int           &beginSample,
+        const int           &endSample,
+        const bool          &bTestOcclusion,
+        int &numInRange,
+        int &numVisible,
+        int &numOccluded,
+        Color &diffuse,
+        Color &specular ) const;
+
 public:
     void SetRectangularArea(
         const Vector<float> &v1,
@@ -52,6 +90,15 @@ public:
         const int           &numHorizontalSamples,
         const int           &numVerticalSamples );
 
+    // Choose a new set of stratified positions for every point on a surface, rather than
+    // using the same fixed positions everywhere. This turns banding into noise.
+    void SetStratifiedSampling(const bool &bStratifiedSampling);
+
+    // Take the full no. of samples only in the penumbra. numProbeSamples samples are taken first;
+    // if all of them agree that the light is visible (or occluded), the rest are not tested for occlusion.
+    // Only used with stratified sampling; 0 disables it.
+    void SetAdaptiveSampling(const int &numProbeSamples);
+
     // Note: This functionality should be moved into another class (could be SphericalAreaLight)
     //       Right now, it's not completely clear how to serialize two types of functionalities
     //void SetSphericalArea(
@@ -68,6 +115,10 @@ public:
         Color &diffuse,
         Color &specular ) const;
 
+    virtual const int NumSamples() const;
+    virtual void GetBounds(Vector<float> &min, Vector<float> &max) const;
+    virtual void Translate(const Vector<float> &offset);
+
     // Serializable's functions
     virtual const bool Read(Deserializer &d, void *const pUserData);
     virtual const bool Write(Serializer &s) const;
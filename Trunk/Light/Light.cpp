@@ -19,10 +19,12 @@
 
 #include "Light.h"
 #include "RayTracer.h"
+#include "Ray.h"
 #include "Scene.h"
 #include "Deserializer.h"
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
+#include "Statistics.h"
 
 // Constructor
 Light::Light() :
@@ -43,6 +45,8 @@ Light::~Light()
 
 const Color Light::Illumination(const Ray &lightRay, const float &lightRayLength, const Scene &scene ) const
 {
+    STATISTICS_INCREMENT( Counter_ShadowRays );
+
     if( RayTracer::_bRayTraceShadows )
         return RayTracer::GetIllumination( lightRay, scene );
 
@@ -52,12 +56,55 @@ const Color Light::Illumination(const Ray &lightRay, const float &lightRayLength
     return _illumination;
 }
 
+void Light::Illumination(
+    const Ray                   &currentGeneration,
+    const Vector<float> *const   pLightRayDirections,
+    const float         *const   pLightRayLengths,
+    const int                   &numLightRays,
+    const Scene                 &scene,
+    Color               *const   pIlluminations ) const
+{
+    STATISTICS_ADD( Counter_ShadowRays, numLightRays );
+
+    if( RayTracer::_bRayTraceShadows )
+    {
+        // Each light ray has to be traced on its own
+        for(int i=0; i < numLightRays; ++i)
+        {
+            const Ray lightRay( currentGeneration.Origin(), pLightRayDirections[i], currentGeneration );
+            pIlluminations[i] = RayTracer::GetIllumination( lightRay, scene );
+        }
+        return;
+    }
+
+    bool occluded[MaxPacketSize];
+    scene.IsOccluded( currentGeneration.Origin(), pLightRayDirections, pLightRayLengths, numLightRays, occluded );
+
+    for(int i=0; i < numLightRays; ++i)
+    {
+        if( occluded[i] )
+            pIlluminations[i].Set( 0 );
+        else
+            pIlluminations[i] = _illumination;
+    }
+}
+
 // Accessors
 const Color &Light::Illumination() const
 {
     return _illumination;
 }
 
+const float &Light::Range() const
+{
+    return _range;
+}
+
+const int Light::NumSamples() const
+{
+    return 1;
+}
+
 void Light::SetColor(const Color &color)
 {
     _color = color;
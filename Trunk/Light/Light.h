@@ -39,6 +39,11 @@ protected:
     float   _range;
     float   _oneOverRange;  // (Auxiliary)
 
+    enum
+    {
+        MaxPacketSize = 32  // Maximum no. of light rays in a packet
+    };
+
 protected:
 // Constructor
     explicit Light();
@@ -50,9 +55,20 @@ public:
 protected:
     const Color Illumination(const Ray &lightRay, const float &lightRayLength, const Scene &scene ) const;
 
+    // Gets the illumination along a set of light rays starting at the origin of the current ray (Packet version of the above)
+    // Note: numLightRays should not be more than MaxPacketSize.
+    void Illumination(
+        const Ray                   &currentGeneration,
+        const Vector<float> *const   pLightRayDirections,
+        const float         *const   pLightRayLengths,
+        const int                   &numLightRays,
+        const Scene                 &scene,
+        Color               *const   pIlluminations ) const;
+
 public:
     // Accessors
     const Color &Illumination() const;  // Get
+    const float &Range() const;         // Get
 
     void SetColor(const Color &color);
     void SetIntensity(const float &intensity);
@@ -66,6 +82,16 @@ public:
         Color &diffuse,
         Color &specular ) const = 0;
 
+    // Returns the no. of positions on the light that a point on a surface is illuminated from,
+    // each of which traces a shadow ray.
+    virtual const int NumSamples() const;
+
+    // Gets the bounds of the area from which the light is emitted.
+    virtual void GetBounds(Vector<float> &min, Vector<float> &max) const = 0;
+
+    // Moves the light by the offset.
+    virtual void Translate(const Vector<float> &offset) = 0;
+
     // Serializable's functions
     virtual const bool Read(Deserializer &d, void *const pUserData);
     virtual const bool Write(Serializer &s) const;
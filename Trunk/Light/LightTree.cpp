@@ -0,0 +1,372 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "LightTree.h"
+#include "Light.h"
+#include "Ray.h"
+#include "Maths.h"
+#include "ForEach.h"
+#include <algorithm>
+
+// Orders BuildEntries by their centre along an axis
+class LightTree::CompareCentre
+{
+private:
+    int _axis;
+
+public:
+    explicit CompareCentre(const int &axis) :
+        _axis( axis )
+    {
+    }
+
+    const bool operator ()(const BuildEntry &a, const BuildEntry &b) const
+    {
+        return a._centre.v[_axis] < b._centre.v[_axis];
+    }
+};
+
+LightTree::LightTree() :
+    _nodes(),
+    _lights(),
+    _memory( MemoryAccount::Subsystem_LightTree )
+{
+}
+
+LightTree::~LightTree()
+{
+}
+
+
+const float LightTree::Power(const Light &light)
+{
+    const Color &illumination = light.Illumination();
+    return (illumination.x + illumination.y + illumination.z) * (1.0f / 3.0f);
+}
+
+const float LightTree::Distance(const Node &node, const Vector<float> &position)
+{
+    // Distance from the position to the closest point in the node's bounds
+    Vector<float> delta( 0 );
+    for(int i=0; i < 3; ++i)
+    {
+        if( position.v[i] < node._min.v[i] )
+            delta.v[i] = node._min.v[i] - position.v[i];
+        else if( position.v[i] > node._max.v[i] )
+            delta.v[i] = position.v[i] - node._max.v[i];
+    }
+
+    return delta.Magnitude();
+}
+
+const float LightTree::Importance(const Node &node, const Vector<float> &position)
+{
+    const float distance = Distance( node, position );
+
+    // No Light in the node reaches this far; this is exact, not an estimate,
+    // since the Lights contribute nothing beyond their range.
+    if( distance >= node._maxRange )
+        return 0;
+
+    // The Lights fall off linearly with distance
+    return node._power * (1 - distance / node._maxRange);
+}
+
+void LightTree::BuildNode(BuildEntryList &entries, const int &begin, const int &end, const int &nodeIndex)
+{
+    // Bound the entries
+    Node node;
+    node._min           = entries[begin]._min;
+    node._max           = entries[begin]._max;
+    node._power         = 0;
+    node._maxRange      = 0;
+    node._child         = -1;
+    node._lightIndex    = -1;
+
+    Vector<float> centreMin( entries[begin]._centre );
+    Vector<float> centreMax( entries[begin]._centre );
+
+    for(int i=begin; i < end; ++i)
+    {
+        const BuildEntry &entry = entries[i];
+
+        for(int j=0; j < 3; ++j)
+        {
+            node._min.v[j]  = Maths::Min( node._min.v[j], entry._min.v[j] );
+            node._max.v[j]  = Maths::Max( node._max.v[j], entry._max.v[j] );
+            centreMin.v[j]  = Maths::Min( centreMin.v[j], entry._centre.v[j] );
+            centreMax.v[j]  = Maths::Max( centreMax.v[j], entry._centre.v[j] );
+        }
+
+        node._power     += entry._power;
+        node._maxRange  = Maths::Max( node._maxRange, entry._pLight->Range() );
+    }
+
+    if( (end - begin) == 1 )
+    {
+        // Leaf
+        node._lightIndex = (int)_lights.size();
+        _lights.push_back( entries[begin]._pLight );
+
+        _nodes[nodeIndex] = node;
+        return;
+    }
+
+    // Split at the median along the axis in which the centres are spread the most
+    const Vector<float> extent = centreMax - centreMin;
+    int axis = 0;
+    if( extent.y > extent.v[axis] ) axis = 1;
+    if( extent.z > extent.v[axis] ) axis = 2;
+
+    const int middle = begin + (end - begin) / 2;
+    std::nth_element( entries.begin() + begin, entries.begin() + middle, entries.begin() + end, CompareCentre( axis ) );
+
+    // Allocate both the children together, so that they're next to each other
+    node._child = (int)_nodes.size();
+    _nodes.resize( _nodes.size() + 2 );
+    _nodes[nodeIndex] = node;
+
+    BuildNode( entries, begin, middle, node._child );
+    BuildNode( entries, middle, end, node._child + 1 );
+}
+
+void LightTree::Build(const LightList &lightList)
+{
+    Clear();
+
+    // Collect the Lights
+    BuildEntryList entries;
+    entries.reserve( lightList.size() );
+
+    FOR_EACH( itr, LightList, lightList )
+    {
+        const Light *const pLight = *itr;
+
+        BuildEntry entry;
+        entry._pLight   = pLight;
+        entry._power    = Maths::Max<float>( 0, Power( *pLight ) );
+
+        pLight->GetBounds( entry._min, entry._max );
+        entry._centre = (entry._min + entry._max) * 0.5f;
+
+        entries.push_back( entry );
+    }
+
+    if( entries.empty() )
+        return;
+
+    _nodes.reserve( entries.size() * 2 - 1 );
+    _lights.reserve( entries.size() );
+
+    _nodes.resize( 1 );
+    BuildNode( entries, 0, (int)entries.size(), 0 );
+
+    _memory.SetSize( _nodes.capacity() * sizeof(Node) + _lights.capacity() * sizeof(const Light *) );
+}
+
+void LightTree::Refit()
+{
+    // Children are always stored after their parent, so going backwards
+    // refits both the children of a node before the node itself.
+    for(int i = (int)_nodes.size() - 1; i >= 0; --i)
+    {
+        Node &node = _nodes[i];
+
+        if( node._lightIndex >= 0 )
+        {
+            // Leaf
+            const Light &light = *_lights[ node._lightIndex ];
+
+            light.GetBounds( node._min, node._max );
+            node._power     = Maths::Max<float>( 0, Power( light ) );
+            node._maxRange  = light.Range();
+            continue;
+        }
+
+        const Node &child1 = _nodes[ node._child ];
+        const Node &child2 = _nodes[ node._child + 1 ];
+
+        for(int j=0; j < 3; ++j)
+        {
+            node._min.v[j] = Maths::Min( child1._min.v[j], child2._min.v[j] );
+            node._max.v[j] = Maths::Max( child1._max.v[j], child2._max.v[j] );
+        }
+
+        node._power     = child1._power + child2._power;
+        node._maxRange  = Maths::Max( child1._maxRange, child2._maxRange );
+    }
+}
+
+void LightTree::Clear()
+{
+    NodeList().swap( _nodes );
+    LightArray().swap( _lights );
+    _memory.SetSize( 0 );
+}
+
+const bool LightTree::IsEmpty() const
+{
+    return _nodes.empty();
+}
+
+const int LightTree::NumNodes() const
+{
+    return (int)_nodes.size();
+}
+
+const float LightTree::SahCost() const
+{
+    if( _nodes.empty() )
+        return 0;
+
+    float rootArea = 0;
+    float cost = 0;
+    for(std::size_t i=0; i < _nodes.size(); ++i)
+    {
+        const Node &node = _nodes[i];
+        const Vector<float> extent = (node._max - node._min) + Vector<float>( node._maxRange * 2 );
+        const float area = 2 * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+
+        // The root is the first node
+        if( i == 0 )
+            rootArea = area;
+
+        cost += (rootArea > 0)? area / rootArea: 1;
+    }
+
+    return cost;
+}
+
+void LightTree::AccumulateIlluminationAtSurface(
+    const Ray           &ray,
+    const Vector<float> &surfaceNormal,
+    const float         &surfaceRoughness,
+    const Scene         &scene,
+    Color &diffuse,
+    Color &specular ) const
+{
+    if( _nodes.empty() )
+        return;
+
+    const Vector<float> &position = ray.Origin();
+
+    // Visit the nodes whose range contains the point
+    int nodeStack[MaxDepth];
+    int stackSize = 0;
+
+    nodeStack[stackSize++] = 0;
+    while( stackSize > 0 )
+    {
+        const Node &node = _nodes[ nodeStack[--stackSize] ];
+
+        // None of the Lights in this node reach the point
+        if( Distance( node, position ) > node._maxRange )
+            continue;
+
+        if( node._lightIndex >= 0 )
+        {
+            _lights[node._lightIndex]->AccumulateIlluminationAtSurface( ray, surfaceNormal, surfaceRoughness, scene, diffuse, specular );
+            continue;
+        }
+
+        // Push the second child first, so that the Lights are visited in the order of the leaves
+        nodeStack[stackSize++] = node._child + 1;
+        nodeStack[stackSize++] = node._child;
+    }
+}
+
+void LightTree::SampleIlluminationAtSurface(
+    const Ray           &ray,
+    const Vector<float> &surfaceNormal,
+    const float         &surfaceRoughness,
+    const Scene         &scene,
+    const int           &numSamples,
+    Color &diffuse,
+    Color &specular ) const
+{
+    if( _nodes.empty() || (numSamples < 1) )
+        return;
+
+    const Vector<float> &position = ray.Origin();
+
+    // If no Light reaches this point, then there's nothing to do
+    if( Importance( _nodes[0], position ) <= 0 )
+        return;
+
+    Color sampledDiffuse( 0 );
+    Color sampledSpecular( 0 );
+
+    for(int sample=0; sample < numSamples; ++sample)
+    {
+        // Stratify the random values across the samples
+        float u = (sample + Maths::GenerateRandomValue()) / numSamples;
+        float probability = 1;
+
+        // Walk down the tree, choosing a child in proportion to its importance
+        int nodeIndex = 0;
+        while( _nodes[nodeIndex]._lightIndex < 0 )
+        {
+            const Node &node = _nodes[nodeIndex];
+
+            const float leftImportance  = Importance( _nodes[node._child], position );
+            const float rightImportance = Importance( _nodes[node._child + 1], position );
+            const float totalImportance = leftImportance + rightImportance;
+
+            // Neither child reaches this point, so this sample contributes nothing
+            if( totalImportance <= 0 )
+            {
+                nodeIndex = -1;
+                break;
+            }
+
+            const float leftProbability = leftImportance / totalImportance;
+
+            // Reuse the random value for the next level by rescaling it to [0, 1)
+            if( (u < leftProbability) || (rightImportance <= 0) )
+            {
+                u = Maths::Min( u / leftProbability, 0.99999f );
+                probability *= leftProbability;
+                nodeIndex = node._child;
+            }
+            else
+            {
+                u = Maths::Min( (u - leftProbability) / (1 - leftProbability), 0.99999f );
+                probability *= (1 - leftProbability);
+                nodeIndex = node._child + 1;
+            }
+        }
+
+        if( nodeIndex < 0 )
+            continue;
+
+        // Accumulate the chosen Light's contribution, weighted by the inverse of the probability of choosing it
+        const Light *const pLight = _lights[ _nodes[nodeIndex]._lightIndex ];
+
+        Color lightDiffuse( 0 );
+        Color lightSpecular( 0 );
+        pLight->AccumulateIlluminationAtSurface( ray, surfaceNormal, surfaceRoughness, scene, lightDiffuse, lightSpecular );
+
+        const float weight = 1 / probability;
+        sampledDiffuse  += lightDiffuse * weight;
+        sampledSpecular += lightSpecular * weight;
+    }
+
+    diffuse     += sampledDiffuse * (1.0f / numSamples);
+    specular    += sampledSpecular * (1.0f / numSamples);
+}
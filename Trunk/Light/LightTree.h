@@ -0,0 +1,139 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LIGHTTREE_HEADER
+#define LIGHTTREE_HEADER
+
+#include "Color.h"
+#include "MemoryAccount.h"
+#include <vector>
+
+// Forward Declarations
+class Ray;
+class Scene;
+class Light;
+
+// A bounding volume hierarchy over the Lights of a Scene.
+// Each node bounds the emitting area of its Lights, along with their total
+// power and largest range, which gives a cheap conservative estimate of how
+// much the node can contribute at a point on a surface.
+class LightTree
+{
+// Types
+public:
+    typedef std::vector<Light *>    LightList;
+
+private:
+    enum
+    {
+        MaxDepth = 64   // Maximum depth of the tree (It's balanced, so this is never reached)
+    };
+
+    struct Node
+    {
+        Vector<float>   _min;           // Bounds of the emitting area of the Lights
+        Vector<float>   _max;
+        float           _power;         // Sum of the power of the Lights
+        float           _maxRange;      // Largest range of the Lights
+        int             _child;         // Index of the first child; the second follows it (Interior nodes)
+        int             _lightIndex;    // Index of the Light; -1 for interior nodes (Leaf nodes)
+    };
+
+    struct BuildEntry
+    {
+        const Light    *_pLight;
+        Vector<float>   _min;
+        Vector<float>   _max;
+        Vector<float>   _centre;
+        float           _power;
+    };
+
+    class CompareCentre;
+
+    typedef std::vector<Node>           NodeList;
+    typedef std::vector<const Light *>  LightArray;
+    typedef std::vector<BuildEntry>     BuildEntryList;
+
+// Members
+private:
+    NodeList    _nodes;
+    LightArray  _lights;
+    MemoryAccount::Allocation _memory;  // Of the nodes and the Lights
+
+public:
+// Constructor
+    explicit LightTree();
+// Destructor
+    ~LightTree();
+
+private:
+// Copy Constructor / Assignment Operator
+    LightTree(const LightTree &);
+    const LightTree &operator =(const LightTree &);
+
+// Functions
+private:
+    void BuildNode(BuildEntryList &entries, const int &begin, const int &end, const int &nodeIndex);
+
+    static const float Power(const Light &light);
+    static const float Distance(const Node &node, const Vector<float> &position);
+    static const float Importance(const Node &node, const Vector<float> &position);
+
+public:
+    void Build(const LightList &lightList);
+
+    // Updates the bounds, power and range of the nodes from their Lights (after they've been moved,
+    // for instance), keeping the structure of the tree. This is much cheaper than building it again,
+    // though the tree gets less effective the further the Lights move from where they were.
+    void Refit();
+    void Clear();
+
+    const bool IsEmpty() const;
+    const int NumNodes() const;
+
+    // Returns the cost of the tree by the surface area heuristic: the no. of nodes expected to be visited
+    // (interior and leaf nodes alike costing 1), weighting each node by the surface area of its bounds
+    // (grown by its range, which is where it's visited) relative to that of the root.
+    const float SahCost() const;
+
+    // Accumulates the illumination from all the Lights whose range contains the point on the surface.
+    // Subtrees that are out of range are skipped, without looking at their Lights.
+    void AccumulateIlluminationAtSurface(
+        const Ray           &ray,
+        const Vector<float> &surfaceNormal,
+        const float         &surfaceRoughness,
+        const Scene         &scene,
+        Color &diffuse,
+        Color &specular ) const;
+
+    // Estimates the illumination from all the Lights using numSamples Lights, each chosen
+    // with a probability proportional to its estimated contribution at the surface.
+    // The contribution of each chosen Light is divided by the probability of choosing it,
+    // so the expected result is the same as accumulating the illumination from every Light.
+    void SampleIlluminationAtSurface(
+        const Ray           &ray,
+        const Vector<float> &surfaceNormal,
+        const float         &surfaceRoughness,
+        const Scene         &scene,
+        const int           &numSamples,
+        Color &diffuse,
+        Color &specular ) const;
+};
+
+#endif
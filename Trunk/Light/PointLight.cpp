@@ -75,6 +75,17 @@ void PointLight::AccumulateIlluminationAtSurface(
     specular += illuminationFromLight * powf( Maths::Max<float>(0, ray.Direction().Dot( lightRayDirection.Reflect( surfaceNormal ) ) ), surfaceRoughness );
 }
 
+void PointLight::GetBounds(Vector<float> &min, Vector<float> &max) const
+{
+    min = _position;
+    max = _position;
+}
+
+void PointLight::Translate(const Vector<float> &offset)
+{
+    _position += offset;
+}
+
 // Serializable's functions
 const bool PointLight::Read(Deserializer &d, void *const /*pUserData*/)
 {
@@ -45,6 +45,9 @@ public:
         Color &diffuse,
         Color &specular ) const;
 
+    virtual void GetBounds(Vector<float> &min, Vector<float> &max) const;
+    virtual void Translate(const Vector<float> &offset);
+
     // Serializable's functions
     virtual const bool Read(Deserializer &d, void *const pUserData);
     virtual const bool Write(Serializer &s) const;
@@ -29,14 +29,102 @@
 #include "Camera.h"
 #include "Image.h"
 #include "RayTracer.h"
+#include "RenderWorker.h"
+#include "RenderServer.h"
+#include "RenderSequence.h"
+#include "Heatmap.h"
+#include "RayTree.h"
+#include "SceneReport.h"
+#include "Statistics.h"
+#include "Trace.h"
+#include "MemoryAccount.h"
 #include "SafeDelete.h"
 #include "Utility.h"
 #include "Examples.h"
+#include "Benchmark.h"
+#include "RegressionTest.h"
 #include "ForEach.h"
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <string>
+#include <iterator>
 //#include <time.h>
 
+void DisplaySyntax(const char *const programName)
+{
+    std::cout << "Syntax (to render a Scene file):" << std::endl << programName << " <input scene filename> <output bitmap filename> [width] [height] [--<setting>:<value> ...]" << std::endl << std::endl;
+    std::cout << "Syntax (to generate a sample file): " << std::endl << programName << " --gen:<sample name> <output scene filename>" << std::endl << std::endl;
+    std::cout << "Syntax (to benchmark the renderer): " << std::endl << programName << " --benchmark:<results filename> [--baseline:<filename>] [--tolerance:<fraction>] [--runs:<count>] [--<setting>:<value> ...]" << std::endl;
+    std::cout << "The stress scenes are rendered, and the results compared with the baseline (results of an earlier run)." << std::endl << std::endl;
+    std::cout << "Syntax (to check the renderer against golden images): " << std::endl << programName << " --regression:<golden image directory> [--update] [--maxRmse:<value>] [--minPsnr:<dB>] [--maxDifference:<value>] [--<setting>:<value> ...]" << std::endl;
+    std::cout << "The reference scenes are rendered, and compared with (or, if updating, saved as) the golden images." << std::endl << std::endl;
+    std::cout << "Syntax (to render tiles for a distributed render): " << std::endl << programName << " --worker:<address>" << std::endl << std::endl;
+    std::cout << "Syntax (to render jobs, keeping their scenes loaded): " << std::endl << programName << " --daemon[:<address>] [--jobs:<count>] [--cachedScenes:<count>] [--<setting>:<value> ...]" << std::endl;
+    std::cout << "Jobs are read from the address, or the standard input; one per line, as the arguments to render a Scene file" << std::endl;
+    std::cout << "(along with --camera:<x>,<y>,<z> and --fov:<degrees>). The settings given here are the defaults of every job." << std::endl << std::endl;
+    std::cout << "Addresses are unix:<path> for a Unix-domain socket, or [host:]port for TCP" << std::endl << std::endl;
+    std::cout << "Currently supported samples are CornellBox, Example1, Example2" << std::endl;
+    std::cout << "and the stress scenes RandomSpheres:<count>, QuadGrid:<columns>,<rows>, TriangleSoup:<count>," << std::endl;
+    std::cout << "PointLights:<count>, GlassStack:<layers>, BigAreaLight:<samples per side>" << std::endl << std::endl;
+    std::cout << "Render settings:" << std::endl;
+    std::cout << "  --minThroughput:<value>       Terminate rays contributing less than this to a pixel (0 to disable)" << std::endl;
+    std::cout << "  --russianRoulette:<bool>      Terminate such rays randomly, keeping the result unbiased" << std::endl;
+    std::cout << "  --maxRaysPerPixel:<count>     Maximum no. of rays traced for each pixel (0 for no limit)" << std::endl;
+    std::cout << "  --stochasticBranching:<bool>  Follow a single randomly chosen ray from each surface" << std::endl;
+    std::cout << "  --samplesPerPixel:<count>     No. of samples taken for each pixel (antialiased if > 1)" << std::endl;
+    std::cout << "  --filter:<box|tent|gaussian>  Filter with which the pixels are reconstructed from the samples" << std::endl;
+    std::cout << "  --adaptiveThreshold:<value>   Refine pixels whose contrast or noise exceeds this (0 to disable)" << std::endl;
+    std::cout << "  --maxSamplesPerPixel:<count>  Maximum no. of samples taken for a refined (or progressive) pixel" << std::endl;
+    std::cout << "  --progressive:<bool>          Render coarse to fine, then keep adding samples" << std::endl;
+    std::cout << "  --timeLimit:<seconds>         Stop a progressive render after this long (0 for no limit)" << std::endl;
+    std::cout << "  --saveInterval:<seconds>      Save the image every so often while rendering progressively" << std::endl;
+    std::cout << "  --tileSize:<pixels>           Render in square tiles of this size (0 for a single tile)" << std::endl;
+    std::cout << "  --tileOrder:<order>           Order of the tiles; scanline, morton or hilbert" << std::endl;
+    std::cout << "  --pixelOrder:<order>          Order of the pixels within a tile; scanline, morton or hilbert" << std::endl;
+    std::cout << "  --crop:<x>,<y>,<w>,<h>        Only render this window of the image" << std::endl;
+    std::cout << "  --checkpoint:<filename>       Record the progress of the render in this file (not for progressive renders)" << std::endl;
+    std::cout << "  --checkpointInterval:<secs>   Seconds between writes of the checkpoint file" << std::endl;
+    std::cout << "  --resume:<bool>               Resume the render recorded in the checkpoint file" << std::endl;
+    std::cout << "  --statistics:<filename>       Write the counters and timings of the render to this file, as JSON" << std::endl;
+    std::cout << "                                (only available if compiled with _STATISTICS)" << std::endl;
+    std::cout << "  --trace:<filename>            Write a timeline of the render to this file, as a Chrome trace (for chrome://tracing)" << std::endl;
+    std::cout << "  --heatmap:<cost>              Record the cost of each pixel beside the image (as <name>.heat.pfm and" << std::endl;
+    std::cout << "                                <name>.heat.bmp); time, rays or tests (ray-primitive tests, with _STATISTICS)" << std::endl;
+    std::cout << "  --memoryLimit:<MiB>           Fail as soon as the memory used by the scene, textures, images, etc. exceeds this" << std::endl;
+    std::cout << "  --serve:<address>             Distribute the render among workers connecting to this address" << std::endl;
+    std::cout << "  --sequence                    The output filename is a frames file; render a frame for each of its lines:" << std::endl;
+    std::cout << "                                <output bitmap filename> [--camera:<x>,<y>,<z>] [--fov:<degrees>]" << std::endl;
+    std::cout << "                                [--moveLight:<index>,<x>,<y>,<z> ...] [--movePrimitive:<index>,<x>,<y>,<z> ...]" << std::endl;
+    std::cout << "  --stats                       Only load the scene (no output filename is needed), and report what it will cost" << std::endl;
+    std::cout << "                                to render; its primitives, lights, textures and worst case rays per pixel" << std::endl;
+    std::cout << "  --rayTree:<x>,<y>             The output filename is a ray tree file; only sample this pixel, recording every" << std::endl;
+    std::cout << "                                ray traced for it (as JSON, or as a Graphviz graph if the filename ends with .dot)" << std::endl;
+}
+
+// Saves the statistics and the trace of the render, if they were asked for
+const bool SaveReports(const RenderSettings &settings)
+{
+    if( !settings._statisticsFileName.empty() )
+    {
+        if( !Statistics::Save( settings._statisticsFileName ) )
+            return false;
+
+        std::cout << "Statistics written to file: " << settings._statisticsFileName << std::endl;
+    }
+
+    if( !settings._traceFileName.empty() )
+    {
+        Trace::Stop();
+        if( !Trace::Save( settings._traceFileName ) )
+            return false;
+
+        std::cout << "Trace written to file: " << settings._traceFileName << std::endl;
+    }
+
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
 // For detecting memory leaks
@@ -58,12 +146,141 @@ int main(int argc, char *argv[])
         << "This is free software, and you are welcome to redistribute it"  << std::endl
         << "under certain conditions; see <http://www.gnu.org/licenses/>."  << std::endl << std::endl;
 
+    // If we're supposed to render tiles for a coordinator
+    if( (argc > 1) && (Utility::String::CaseInsensitiveCompare( std::string( argv[1] ).substr(0, 9), "--worker:" ) == 0) )
+    {
+        RenderWorker worker;
+        return worker.Run( std::string( argv[1] ).substr( 9 ) )? 0: -1;
+    }
+
+    // If we're supposed to render jobs as they come in
+    if( (argc > 1) && (Utility::String::CaseInsensitiveCompare( std::string( argv[1] ).substr(0, 8), "--daemon" ) == 0) )
+    {
+        const std::string daemon( argv[1] );
+        if( (daemon.size() > 8) && (daemon[8] != ':') )
+        {
+            std::cout << "Error: Invalid argument: " << daemon << std::endl;
+            return -1;
+        }
+
+        RenderServer server;
+        for(int i=2; i < argc; ++i)
+        {
+            const std::string argument( argv[i] );
+            std::string name, value;
+
+            bool bValid = false;
+            if( RenderSettings::SplitArgument( argument, name, value ) )
+            {
+                if( Utility::String::CaseInsensitiveCompare( name, "jobs" ) == 0 )
+                    bValid = Utility::String::FromString( server._maxJobs, value ) && (server._maxJobs > 0);
+                else if( Utility::String::CaseInsensitiveCompare( name, "cachedScenes" ) == 0 )
+                    bValid = Utility::String::FromString( server._maxScenes, value ) && (server._maxScenes > 0);
+                else
+                    bValid = server._settings.Set( name, value );
+            }
+
+            if( !bValid )
+            {
+                std::cout << "Error: Invalid argument: " << argument << std::endl;
+                return -1;
+            }
+        }
+
+        const bool bResult = (daemon.size() > 8)? server.Run( daemon.substr( 9 ) ): server.Run();
+        return bResult? 0: -1;
+    }
+
+    // If we're supposed to benchmark the renderer
+    if( (argc > 1) && (Utility::String::CaseInsensitiveCompare( std::string( argv[1] ).substr(0, 12), "--benchmark:" ) == 0) )
+    {
+        const std::string resultsFileName = std::string( argv[1] ).substr( 12 );
+        std::string baselineFileName;
+
+        Benchmark benchmark;
+        for(int i=2; i < argc; ++i)
+        {
+            const std::string argument( argv[i] );
+            std::string name, value;
+
+            bool bValid = false;
+            if( RenderSettings::SplitArgument( argument, name, value ) )
+            {
+                if( Utility::String::CaseInsensitiveCompare( name, "baseline" ) == 0 )
+                {
+                    baselineFileName = value;
+                    bValid = !value.empty();
+                }
+                else if( Utility::String::CaseInsensitiveCompare( name, "runs" ) == 0 )
+                    bValid = Utility::String::FromString( benchmark._numRuns, value ) && (benchmark._numRuns > 0);
+                else if( Utility::String::CaseInsensitiveCompare( name, "tolerance" ) == 0 )
+                    bValid = Utility::String::FromString( benchmark._tolerance, value ) && (benchmark._tolerance >= 0);
+                else
+                    bValid = benchmark._settings.Set( name, value );
+            }
+
+            if( !bValid )
+            {
+                std::cout << "Error: Invalid argument: " << argument << std::endl;
+                return -1;
+            }
+        }
+
+        if( resultsFileName.empty() )
+        {
+            std::cout << "Error: No file given for the benchmark results" << std::endl;
+            return -1;
+        }
+
+        return benchmark.Run( resultsFileName, baselineFileName )? 0: -1;
+    }
+
+    // If we're supposed to check the renderer against the golden images
+    if( (argc > 1) && (Utility::String::CaseInsensitiveCompare( std::string( argv[1] ).substr(0, 13), "--regression:" ) == 0) )
+    {
+        const std::string directory = std::string( argv[1] ).substr( 13 );
+
+        RegressionTest regressionTest;
+        for(int i=2; i < argc; ++i)
+        {
+            const std::string argument( argv[i] );
+            std::string name, value;
+
+            bool bValid = false;
+            if( RenderSettings::SplitArgument( argument, name, value ) )
+            {
+                if( Utility::String::CaseInsensitiveCompare( name, "update" ) == 0 )
+                    bValid = RenderSettings::ReadBool( regressionTest._bUpdate, value );
+                else if( Utility::String::CaseInsensitiveCompare( name, "maxRmse" ) == 0 )
+                    bValid = Utility::String::FromString( regressionTest._maxRmse, value ) && (regressionTest._maxRmse >= 0);
+                else if( Utility::String::CaseInsensitiveCompare( name, "minPsnr" ) == 0 )
+                    bValid = Utility::String::FromString( regressionTest._minPsnr, value );
+                else if( Utility::String::CaseInsensitiveCompare( name, "maxDifference" ) == 0 )
+                    bValid = Utility::String::FromString( regressionTest._maxDifference, value ) && (regressionTest._maxDifference >= 0);
+                else
+                    bValid = regressionTest._settings.Set( name, value );
+            }
+
+            if( !bValid )
+            {
+                std::cout << "Error: Invalid argument: " << argument << std::endl;
+                return -1;
+            }
+        }
+
+        if( directory.empty() )
+        {
+            std::cout << "Error: No directory given for the golden images" << std::endl;
+            return -1;
+        }
+
+        return regressionTest.Run( directory )? 0: -1;
+    }
+
     if( argc < 3 )
     {
         std::cout << "Insufficient arguments" << std::endl << std::endl;
-        std::cout << "Syntax (to render a Scene file):" << std::endl << argv[0] << " <input scene filename> <output bitmap filename> [width] [height]" << std::endl << std::endl;
-        std::cout << "Syntax (to generate a sample file): " << std::endl << argv[0] << " --gen:<sample name> <output scene filename>" << std::endl << std::endl;
-        std::cout << "Currently supported samples are CornellBox, Example1, Example2" << std::endl;
+        DisplaySyntax( argv[0] );
         return -1;
     }
 
@@ -85,6 +302,14 @@ int main(int argc, char *argv[])
         {
             bResult = Examples::Example2( argv[2] );
         }
+        else if( sampleName.find( ':' ) != std::string::npos )
+        {
+            Scene scene;
+            if( Examples::GenerateStressScene( scene, sampleName ) )
+                bResult = Examples::SaveScene( scene, argv[2] );
+            else
+                std::cout << "Error: Unknown stress scene, or invalid parameters: " << sampleName << std::endl;
+        }
         else  // We don't have this sample
             std::cout << "Error: Unknown sample name: " << sampleName << std::endl;
 
@@ -95,24 +320,118 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    // Create a RayTracer
+    RayTracer rayTracer;
+
+    // Separate the render settings (--<setting>:<value>) from the rest of the arguments.
+    // The settings are also kept as they were given, to be passed on to the workers of a distributed render.
+    std::vector<std::string> arguments, settings;
+    std::string serveAddress;
+    bool bSequence = false;
+    bool bStats = false;
+    std::vector<int> rayTreePixel;
+    for(int i=1; i < argc; ++i)
+    {
+        const std::string argument( argv[i] );
+        std::string name, value;
+        if( !RenderSettings::SplitArgument( argument, name, value ) )
+        {
+            arguments.push_back( argument );
+            continue;
+        }
+
+        if( Utility::String::CaseInsensitiveCompare( name, "serve" ) == 0 )
+        {
+            serveAddress = value;
+            continue;
+        }
+
+        if( Utility::String::CaseInsensitiveCompare( name, "sequence" ) == 0 )
+        {
+            if( !RenderSettings::ReadBool( bSequence, value ) )
+            {
+                std::cout << "Error: Invalid render setting: " << argument << std::endl;
+                return -1;
+            }
+            continue;
+        }
+
+        if( Utility::String::CaseInsensitiveCompare( name, "stats" ) == 0 )
+        {
+            if( !RenderSettings::ReadBool( bStats, value ) )
+            {
+                std::cout << "Error: Invalid render setting: " << argument << std::endl;
+                return -1;
+            }
+            continue;
+        }
+
+        if( Utility::String::CaseInsensitiveCompare( name, "rayTree" ) == 0 )
+        {
+            if( !Utility::String::FromString( rayTreePixel, value ) || (rayTreePixel.size() != 2) )
+            {
+                std::cout << "Error: Invalid pixel for the ray tree: " << argument << std::endl;
+                return -1;
+            }
+            continue;
+        }
+
+        if( !rayTracer._settings.Set( name, value ) )
+        {
+            std::cout << "Error: Invalid render setting: " << argument << std::endl;
+            return -1;
+        }
+
+        settings.push_back( name + ":" + value );
+    }
+
+    if( arguments.size() < (bStats? 1u: 2u) )
+    {
+        std::cout << "Insufficient arguments" << std::endl << std::endl;
+        DisplaySyntax( argv[0] );
+        return -1;
+    }
+
+    if( bStats && (bSequence || !serveAddress.empty() || !rayTreePixel.empty()) )
+    {
+        std::cout << "Error: --stats can't be combined with sequences, distributed renders or ray trees" << std::endl;
+        return -1;
+    }
+
+#ifndef _STATISTICS
+    if( !rayTracer._settings._statisticsFileName.empty() )
+    {
+        std::cout << "Error: Statistics are not available; compile with _STATISTICS defined to gather them." << std::endl;
+        return -1;
+    }
+#endif
+
+    if( !rayTracer._settings._traceFileName.empty() )
+        Trace::Start();
+
+    MemoryAccount::SetLimit( (std::size_t)rayTracer._settings._memoryLimit * 1024 * 1024 );
+
+    const std::string &sceneFileName = arguments[0];
+    const std::string imageFileName = (arguments.size() > 1)? arguments[1]: std::string();
+
     // Get the required width
     int width = 500;
-    if( argc > 3 )
+    if( arguments.size() > 2 )
     {
-        if( !Utility::String::FromString(width, argv[3]) || (width < 1) )
+        if( !Utility::String::FromString(width, arguments[2]) || (width < 1) )
         {
-            std::cout << "Error: Invalid integer specified for width: " << argv[3] << std::endl;
+            std::cout << "Error: Invalid integer specified for width: " << arguments[2] << std::endl;
             return -1;
         }
     }
 
     // Get the required height
     int height = 500;
-    if( argc > 4 )
+    if( arguments.size() > 3 )
     {
-        if( !Utility::String::FromString(height, argv[4]) || (height < 1) )
+        if( !Utility::String::FromString(height, arguments[3]) || (height < 1) )
         {
-            std::cout << "Error: Invalid integer specified for height: " << argv[4] << std::endl;
+            std::cout << "Error: Invalid integer specified for height: " << arguments[3] << std::endl;
             return -1;
         }
     }
@@ -123,6 +442,27 @@ int main(int argc, char *argv[])
     camera._hFov        = 45 * (width / (float)height);
     camera._vFov        = 45;
 
+    // Read the frames of a sequence
+    RenderSequence sequence;
+    if( bSequence && !sequence.Load( imageFileName, camera, width / (float)height ) )
+        return -1;
+
+    // Create a Heatmap, to record the cost of the pixels
+    Heatmap heatmap;
+    if( rayTracer._settings._heatmapCost != RenderSettings::Cost_None )
+    {
+        if( bSequence || !serveAddress.empty() )
+        {
+            std::cout << "Error: Heatmaps can't be recorded for sequences or distributed renders" << std::endl;
+            return -1;
+        }
+
+        if( !heatmap.Create( width, height, rayTracer._settings._heatmapCost ) )
+            return -1;
+
+        rayTracer._pHeatmap = &heatmap;
+    }
+
     // Create an Image
     Image image;
     if( !image.Create( width, height ) )
@@ -133,35 +473,85 @@ int main(int argc, char *argv[])
 
     // Open the input scene file
     std::fstream stream;
-    stream.open( argv[1], std::ios_base::in );
+    stream.open( sceneFileName.c_str(), std::ios_base::in );
     if( !stream.is_open() )
     {
-        std::cout << "Error: Failed to open input scene file: " << argv[1] << std::endl;
+        std::cout << "Error: Failed to open input scene file: " << sceneFileName << std::endl;
         return -1;
     }
 
+    // Checkpoints are validated against the contents of the scene file, which are also sent to the
+    // workers of a distributed render
+    const std::string sceneText( (std::istreambuf_iterator<char>( stream )), std::istreambuf_iterator<char>() );
+    rayTracer._sceneCrc = Utility::String::CalculateCrc( sceneText );
+    stream.clear();
+    stream.seekg( 0 );
+
     // Create a Deserializer for the stream
     Deserializer d;
     if( !d.Open( stream ) )
     {
-        std::cout << "Error: Failed to read file: " << argv[1] << std::endl;
+        std::cout << "Error: Failed to read file: " << sceneFileName << std::endl;
         return -1;
     }
 
     // Load the scene from the stream
+    STATISTICS_START_PHASE( Phase_Parse );
+    Trace::Scope parseTraceScope( "Parse scene", sceneFileName );
     Scene *pScene = d.Deserialize<Scene>( 0 );
+    d.Close();  // The text of the scene isn't needed any more
+    parseTraceScope.End();
+    STATISTICS_END_PHASE( Phase_Parse );
     if( !pScene )
     {
-        std::cout << "Error: Failed to load Scene from file: " << argv[1] << std::endl;
+        std::cout << "Error: Failed to load Scene from file: " << sceneFileName << std::endl;
         return -1;
     }
 
-    // Create a RayTracer and ray trace the scene
-    RayTracer rayTracer;
+    // Report what the scene will cost to render, rather than rendering it
+    if( bStats )
+    {
+        std::cout << "Scene: " << sceneFileName << std::endl;
+        SceneReport::Write( std::cout, *pScene, rayTracer._settings );
+        SafeDeleteScalar( pScene );
+        return 0;
+    }
+
+    // Record the rays of a single pixel, rather than rendering the image
+    if( !rayTreePixel.empty() )
+    {
+        RayTree rayTree;
+        const bool bResult =
+            rayTracer.TracePixel( camera, *pScene, width, height, rayTreePixel[0], rayTreePixel[1], rayTree ) &&
+            rayTree.Save( imageFileName, *pScene );
+
+        SafeDeleteScalar( pScene );
+
+        if( !bResult )
+            return -1;
+
+        std::cout << "Ray tree written to file: " << imageFileName << std::endl;
+        return 0;
+    }
+
+    // Ray trace the scene
     std::cout << "RayTracing";
-    const bool bRTResult = rayTracer.Render( camera, *pScene, image );
+    STATISTICS_START_PHASE( Phase_Render );
+    Trace::Scope renderTraceScope( "Render" );
+    const bool bRTResult = bSequence?
+        sequence.Render( rayTracer, *pScene, image ):
+        !serveAddress.empty()?
+        rayTracer.RenderDistributed( camera, *pScene, sceneText, settings, image, serveAddress ):
+        rayTracer._settings._bProgressive?
+        rayTracer.RenderProgressive( camera, *pScene, image, imageFileName ):
+        rayTracer.Render( camera, *pScene, image );
+    renderTraceScope.End();
+    STATISTICS_END_PHASE( Phase_Render );
     std::cout << "Done" << std::endl;
 
+    // The memory in use at the end of the render (with the scene still loaded), and the most that was used
+    MemoryAccount::Write( std::cout );
+
     // We're done with the scene, delete it
     SafeDeleteScalar( pScene );
 
@@ -171,12 +561,25 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // The frames of a sequence have been saved already
+    if( bSequence )
+        return SaveReports( rayTracer._settings )? 0: -1;
+
     // Save the image to the required output file
-    if( !image.Save( argv[2] ) )
+    STATISTICS_START_PHASE( Phase_Save );
+    Trace::Scope saveTraceScope( "Save image", imageFileName );
+    const bool bSaved = image.Save( imageFileName );
+    saveTraceScope.End();
+    STATISTICS_END_PHASE( Phase_Save );
+
+    if( !bSaved )
     {
-        std::cout << "Error: Failed while saving image to file: " << argv[2] << std::endl;
+        std::cout << "Error: Failed while saving image to file: " << imageFileName << std::endl;
         return -1;
     }
 
-    return 0;
+    if( rayTracer._pHeatmap && !rayTracer._pHeatmap->Save( imageFileName ) )
+        return -1;
+
+    return SaveReports( rayTracer._settings )? 0: -1;
 }
@@ -21,12 +21,16 @@
 #include "Ray.h"
 #include "Maths.h"
 #include "Scene.h"
-#include "RayTracer.h"
 #include "Texture.h"
+#include "Statistics.h"
+#include "ObjectFactory.h"
 #include "Deserializer.h"
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
 
+// Register with the ObjectFactory
+ObjectFactory_Register(Serializable, Material);
+
 // Constructor
 Material::Material() :
     _color( 1 ),
@@ -51,6 +55,12 @@ Material::~Material()
 }
 
 // Functions
+const Material &Material::Default()
+{
+    static const Material defaultMaterial;
+    return defaultMaterial;
+}
+
 void Material::SetColor(const float &r, const float &g, const float &b)
 {
     // The _color is the amount of illumination reflected by this material;
@@ -117,99 +127,136 @@ void Material::SetTextureScale(const float &scale)
     _oneOverTextureScale = 1 / scale;
 }
 
-const Color Material::GetTransmittedIllumination(
-    const Ray           &incidentRay,
-    const Vector<float> &surfaceNormal,
-    const Scene         &scene,
-    const bool          &bOnEntry,
-    const float         &pathLength ) const
+const bool Material::IsFuzzy(const Ray &incidentRay) const
 {
-    const Vector<float> &V = incidentRay.Direction();
-    const Vector<float> N = bOnEntry? surfaceNormal: -surfaceNormal;
+    return(
+        _fuzzyReflectionRadius > 0      &&  // If there's come fuzziness in the reflection
+        incidentRay.Generation() <= 2   );  // TODO: Make this hard-coded cap on the generation configurable.
+}
 
-    const float n = bOnEntry?
-        1 / _refractiveIndex:   // Entering into this material
-        _refractiveIndex / 1;   // Exiting from this material
+const Pixel<float> Material::GetDiffuseTexel(const float &u, const float &v) const
+{
+    if( !_pDiffuseMap )
+        return Pixel<float>( 1, 1, 1, 1 );
 
-    const float cosI  = -N.Dot( V );
-    const float cosT2 = 1 - n * n * (1 - cosI * cosI);
+    STATISTICS_INCREMENT( Counter_TextureSamples );
+    return _pDiffuseMap->GetPixel( u * _oneOverTextureScale, v * _oneOverTextureScale );
+}
 
-    const Vector<float> T = (cosT2 > 0)?
-        V * n + N * (n * cosI - sqrt(cosT2)):
-        incidentRay.Direction();
+void Material::GetLocalIllumination(
+    const Ray               &incidentRay,
+    const Vector<float>     &surfaceNormal,
+    const Scene             &scene,
+    const IntersectionInfo  &intersectionInfo,
+    Color &diffuse,
+    Color &specular,
+    Color &texelColor,
+    float &opacity ) const
+{
+    const Pixel<float> texel = GetDiffuseTexel( intersectionInfo._tU, intersectionInfo._tV );
+    texelColor.Set( texel._r, texel._g, texel._b );
+    opacity = texel._a * _opacity;
 
-    const float beersIntensity = bOnEntry? 1: exp( -_absorption * _concentration * pathLength );
+    scene.GetSurfaceIllumination( incidentRay, surfaceNormal, _roughness, diffuse, specular );
+}
 
-    return RayTracer::GetIllumination( Ray( incidentRay.Origin(), T, incidentRay ), scene ) * beersIntensity;
+const bool Material::IsReflective() const
+{
+    return (_reflectivity > 0);
+}
+
+const int Material::GetMaxNumReflectedRays() const
+{
+    if( !IsReflective() )
+        return 0;
+
+    return (_fuzzyReflectionRadius > 0)? _fuzzyReflectionSamples: 1;
+}
+
+const bool Material::IsTransmissive() const
+{
+    return (_opacity < 1) || (_pDiffuseMap != 0);
+}
+
+const int Material::GetNumReflectedRays(const Ray &incidentRay) const
+{
+    return IsFuzzy( incidentRay )? _fuzzyReflectionSamples: 1;
 }
 
-const Color Material::GetReflectedIllumination(
-    const Ray           &incidentRay,
-    const Vector<float> &surfaceNormal,
-    const Scene         &scene) const
+const Vector<float> Material::GetReflectedDirection(const Ray &incidentRay, const Vector<float> &surfaceNormal) const
 {
     const Vector<float> r = incidentRay.Direction().Reflect( surfaceNormal );
 
-    if( _fuzzyReflectionRadius > 0      &&  // If there's come fuzziness in the reflection
-        incidentRay.Generation() <= 2   )   // TODO: Make this hard-coded cap on the generation configurable.
+    if( !IsFuzzy( incidentRay ) )
     {
-        Color color( 0 );
-        for(int i=0; i < _fuzzyReflectionSamples; ++i)
-        {
-            const Vector<float> rndVec(
-                Maths::GenerateRandomValue() - 0.5f,
-                Maths::GenerateRandomValue() - 0.5f,
-                Maths::GenerateRandomValue() - 0.5f );
+        STATISTICS_INCREMENT( Counter_ReflectionRays );
+        return r;
+    }
 
-            Vector<float> rVec = rndVec - r * rndVec.Dot( r );
-            rVec.Normalize();
-            rVec *= _fuzzyReflectionRadius * Maths::GenerateRandomValue();
+    STATISTICS_INCREMENT( Counter_FuzzyRays );
 
-            Vector<float> fuzzyR = r + rVec;
-            fuzzyR.Normalize();
+    const Vector<float> rndVec(
+        Maths::GenerateRandomValue() - 0.5f,
+        Maths::GenerateRandomValue() - 0.5f,
+        Maths::GenerateRandomValue() - 0.5f );
 
-            color += RayTracer::GetIllumination( Ray( incidentRay.Origin(), fuzzyR, incidentRay ), scene );
-        }
+    Vector<float> rVec = rndVec - r * rndVec.Dot( r );
+    rVec.Normalize();
+    rVec *= _fuzzyReflectionRadius * Maths::GenerateRandomValue();
 
-        return color * (1.0f / _fuzzyReflectionSamples);
-    }
+    Vector<float> fuzzyR = r + rVec;
+    fuzzyR.Normalize();
 
-    return RayTracer::GetIllumination( Ray( incidentRay.Origin(), r, incidentRay ), scene );
+    return fuzzyR;
 }
 
-const Pixel<float> Material::GetDiffuseTexel(const float &u, const float &v) const
+const Color Material::GetReflectedWeight(const Color &texelColor, const float &opacity) const
 {
-    if( !_pDiffuseMap )
-        return Pixel<float>( 1, 1, 1, 1 );
+    return _color * texelColor * (_reflectivity * opacity);
+}
 
-    return _pDiffuseMap->GetPixel( u * _oneOverTextureScale, v * _oneOverTextureScale );
+void Material::AddReflectedIllumination(Color &diffuse, const Color &reflectedIllumination) const
+{
+    diffuse = Maths::InterpolateLinear(diffuse, reflectedIllumination, _reflectivity );
 }
 
-const Color Material::GetIllumination(
-    const Ray               &incidentRay,
-    const Vector<float>     &surfaceNormal,
-    const Scene             &scene,
-    const IntersectionInfo  &intersectionInfo ) const
+const Vector<float> Material::GetTransmittedDirection(const Ray &incidentRay, const Vector<float> &surfaceNormal, const bool &bOnEntry) const
 {
-    const Pixel<float> texel = GetDiffuseTexel( intersectionInfo._tU, intersectionInfo._tV );
-    const Color texelColor( texel._r, texel._g, texel._b );
-    const float effectiveOpacity = texel._a * _opacity;
+    STATISTICS_INCREMENT( Counter_RefractionRays );
 
-    Color diffuse, specular;
-    scene.GetSurfaceIllumination( incidentRay, surfaceNormal, _roughness, diffuse, specular );
+    const Vector<float> &V = incidentRay.Direction();
+    const Vector<float> N = bOnEntry? surfaceNormal: -surfaceNormal;
 
-    if( _reflectivity > 0 )
-    {
-        const Color reflectedIllumination = GetReflectedIllumination( incidentRay, surfaceNormal, scene );
-        diffuse = Maths::InterpolateLinear(diffuse, reflectedIllumination, _reflectivity );
-    }
+    const float n = bOnEntry?
+        1 / _refractiveIndex:   // Entering into this material
+        _refractiveIndex / 1;   // Exiting from this material
 
-    if( effectiveOpacity < 1 )
-    {
-        const Color transmittedIllumination = GetTransmittedIllumination( incidentRay, surfaceNormal, scene, intersectionInfo._bOnEntry, intersectionInfo._dist );
-        diffuse = Maths::InterpolateLinear(transmittedIllumination, diffuse, effectiveOpacity );
-    }
+    const float cosI  = -N.Dot( V );
+    const float cosT2 = 1 - n * n * (1 - cosI * cosI);
 
+    return (cosT2 > 0)?
+        V * n + N * (n * cosI - sqrt(cosT2)):
+        incidentRay.Direction();
+}
+
+const float Material::GetTransmittance(const bool &bOnEntry, const float &pathLength) const
+{
+    // Beer's law
+    return bOnEntry? 1: exp( -_absorption * _concentration * pathLength );
+}
+
+const Color Material::GetTransmittedWeight(const Color &texelColor, const float &opacity, const float &transmittance) const
+{
+    return _color * texelColor * ((1 - opacity) * transmittance);
+}
+
+void Material::AddTransmittedIllumination(Color &diffuse, const Color &transmittedIllumination, const float &opacity) const
+{
+    diffuse = Maths::InterpolateLinear(transmittedIllumination, diffuse, opacity );
+}
+
+const Color Material::CombineIllumination(const Color &diffuse, const Color &specular, const Color &texelColor) const
+{
     // return the illumination not absorbed by this material
     return diffuse * _color * texelColor + specular * _specularity;
 }
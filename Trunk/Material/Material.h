@@ -30,6 +30,8 @@ class Ray;
 class Scene;
 class Texture;
 
+// Materials are shared by the Primitives which have them (see Primitive::_pMaterial), and are
+// owned by the Scene, which writes each of them out once.
 class Material : public Serializable
 {
 // Members
@@ -66,21 +68,14 @@ private:
 
 // Functions
 private:
-    const Color GetTransmittedIllumination(
-        const Ray           &incidentRay,
-        const Vector<float> &surfaceNormal,
-        const Scene         &scene,
-        const bool          &bOnEntry,
-        const float         &pathLength ) const;
-
-    const Color GetReflectedIllumination(
-        const Ray           &incidentRay,
-        const Vector<float> &surfaceNormal,
-        const Scene         &scene) const;
+    const bool IsFuzzy(const Ray &incidentRay) const;
 
     const Pixel<float> GetDiffuseTexel(const float &u, const float &v) const;
 
 public:
+    // The Material of the Primitives which haven't been given one
+    static const Material &Default();
+
     void SetColor(const float &r, const float &g, const float &b);
     void SetOpacity(const float &opacity);
     void SetReflectivity(const float &reflectivity);
@@ -94,11 +89,43 @@ public:
     void SetDiffuseMap(const Texture *const pDiffuseMap);
     void SetTextureScale(const float &scale);
 
-    const Color GetIllumination(
+    // The illumination at a point on the surface is calculated in parts, so that the reflected
+    // and transmitted rays can be traced by the caller (see Integrator):
+    //  1. GetLocalIllumination() gets the illumination from the lights.
+    //  2. If IsReflective(), GetNumReflectedRays() rays are traced along GetReflectedDirection(),
+    //     and their average is passed to AddReflectedIllumination().
+    //  3. If the opacity is < 1, a ray is traced along GetTransmittedDirection(), and its
+    //     illumination (scaled by GetTransmittance()) is passed to AddTransmittedIllumination().
+    //  4. CombineIllumination() returns the illumination not absorbed by this material.
+    // The weights give how much of the traced illumination makes it into the final result.
+    void GetLocalIllumination(
         const Ray               &incidentRay,
         const Vector<float>     &surfaceNormal,
         const Scene             &scene,
-        const IntersectionInfo  &intersectionInfo ) const;
+        const IntersectionInfo  &intersectionInfo,
+        Color &diffuse,
+        Color &specular,
+        Color &texelColor,
+        float &opacity ) const;
+
+    const bool IsReflective() const;
+
+    // Upper bounds on the rays traced from a point on the surface, for estimating the cost of a render.
+    // The transmitted ray may also be traced if the material isn't transmissive, through the alpha of its diffuse map.
+    const int GetMaxNumReflectedRays() const;
+    const bool IsTransmissive() const;
+
+    const int GetNumReflectedRays(const Ray &incidentRay) const;
+    const Vector<float> GetReflectedDirection(const Ray &incidentRay, const Vector<float> &surfaceNormal) const;
+    const Color GetReflectedWeight(const Color &texelColor, const float &opacity) const;
+    void AddReflectedIllumination(Color &diffuse, const Color &reflectedIllumination) const;
+
+    const Vector<float> GetTransmittedDirection(const Ray &incidentRay, const Vector<float> &surfaceNormal, const bool &bOnEntry) const;
+    const float GetTransmittance(const bool &bOnEntry, const float &pathLength) const;
+    const Color GetTransmittedWeight(const Color &texelColor, const float &opacity, const float &transmittance) const;
+    void AddTransmittedIllumination(Color &diffuse, const Color &transmittedIllumination, const float &opacity) const;
+
+    const Color CombineIllumination(const Color &diffuse, const Color &specular, const Color &texelColor) const;
 
     // Serializable's functions
     virtual const bool Read(Deserializer &d, void *const pUserData);
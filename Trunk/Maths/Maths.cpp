@@ -45,4 +45,20 @@ namespace Maths
         return (rand() / (float)RAND_MAX);
     }
 
+    const float RadicalInverse(const unsigned int &index, const unsigned int &base)
+    {
+        // Mirror the digits of the index about the decimal point
+        const float oneOverBase = 1.0f / base;
+
+        float result    = 0;
+        float digitValue= oneOverBase;
+        for(unsigned int i = index; i > 0; i /= base)
+        {
+            result      += (i % base) * digitValue;
+            digitValue  *= oneOverBase;
+        }
+
+        return result;
+    }
+
 } // namespace Maths
@@ -106,6 +106,10 @@ namespace Maths
 
     const float GenerateRandomValue();  // Returns a random value in the range 0.0f to 1.0f
 
+    // Returns the index'th value of the van der Corput sequence in the specified base (in the range 0.0f to 1.0f)
+    // Using a different prime base for each dimension gives the Halton sequence.
+    const float RadicalInverse(const unsigned int &index, const unsigned int &base);
+
 } // namespace Maths
 
 #endif
@@ -0,0 +1,101 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Arena.h"
+#include <new>
+
+// Members
+Arena *Arena::_pCurrent = 0;
+
+// Scope's Constructor
+Arena::Scope::Scope(Arena &arena) :
+    _pPrevious( Arena::_pCurrent )
+{
+    Arena::_pCurrent = &arena;
+}
+
+// Scope's Destructor
+Arena::Scope::~Scope()
+{
+    Arena::_pCurrent = _pPrevious;
+}
+
+// Constructor
+Arena::Arena(const MemoryAccount::Subsystem &subsystem, const std::size_t &blockSize) :
+    _blocks(),
+    _pNext( 0 ),
+    _numFreeBytes( 0 ),
+    _blockSize( blockSize ),
+    _size( 0 ),
+    _memory( subsystem )
+{
+}
+
+// Destructor
+Arena::~Arena()
+{
+    Release();
+}
+
+// Functions
+void *const Arena::Allocate(const std::size_t &size)
+{
+    const std::size_t alignedSize = (size + (Alignment - 1)) & ~(std::size_t)(Alignment - 1);
+
+    if( alignedSize > _numFreeBytes )
+    {
+        // Large allocations get a block of their own, and the last block carries on after them
+        const bool bOwnBlock = (alignedSize > _blockSize);
+        const std::size_t blockSize = bOwnBlock? alignedSize: _blockSize;
+
+        _size += blockSize;
+        _memory.SetSize( _size );
+
+        void *const pBlock = ::operator new( blockSize );
+        _blocks.push_back( pBlock );
+
+        if( bOwnBlock )
+            return pBlock;
+
+        _pNext          = static_cast<char *>( pBlock );
+        _numFreeBytes   = _blockSize;
+    }
+
+    void *const p = _pNext;
+    _pNext          += alignedSize;
+    _numFreeBytes   -= alignedSize;
+    return p;
+}
+
+void Arena::Release()
+{
+    for(std::size_t i=0; i < _blocks.size(); ++i)
+        ::operator delete( _blocks[i] );
+
+    BlockList().swap( _blocks );
+    _pNext          = 0;
+    _numFreeBytes   = 0;
+    _size           = 0;
+    _memory.SetSize( 0 );
+}
+
+Arena *const Arena::Current()
+{
+    return _pCurrent;
+}
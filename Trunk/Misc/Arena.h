@@ -0,0 +1,96 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include "MemoryAccount.h"
+#include <cstddef>
+#include <vector>
+
+// Hands out memory from large blocks, one allocation after the other, so that objects allocated
+// together are laid out together. The memory can't be freed an allocation at a time; it's all
+// released at once, along with the blocks.
+// An Arena can be made the current one (see Scope), which Serializables are then allocated from.
+class Arena
+{
+// Types
+public:
+    enum
+    {
+        Alignment           = 16,           // Of every allocation
+        DefaultBlockSize    = 64 * 1024     // Allocations larger than the block size get a block of their own
+    };
+
+    // Makes the Arena the current one, until the Scope ends
+    class Scope
+    {
+    // Members
+    private:
+        Arena  *_pPrevious;
+
+    public:
+    // Constructor
+        explicit Scope(Arena &arena);
+    // Destructor
+        ~Scope();
+
+    private:
+    // Copy Constructor / Assignment Operator
+        Scope(const Scope &);
+        const Scope &operator =(const Scope &);
+    };
+
+private:
+    typedef std::vector<void *> BlockList;
+
+// Members
+private:
+    BlockList                   _blocks;
+    char                       *_pNext;         // Next free byte of the last block
+    std::size_t                 _numFreeBytes;  // Left in the last block
+    std::size_t                 _blockSize;
+    std::size_t                 _size;          // Of all the blocks
+    MemoryAccount::Allocation   _memory;        // Of the blocks
+
+    static Arena               *_pCurrent;
+
+public:
+// Constructor
+    explicit Arena(const MemoryAccount::Subsystem &subsystem, const std::size_t &blockSize = DefaultBlockSize);
+// Destructor
+    ~Arena();
+
+private:
+// Copy Constructor / Assignment Operator
+    Arena(const Arena &);
+    const Arena &operator =(const Arena &);
+
+// Functions
+public:
+    void *const Allocate(const std::size_t &size);
+
+    // Releases all the memory allocated; anything still in it must have been destructed already.
+    void Release();
+
+    // Returns the current Arena; 0 if there's none
+    static Arena *const Current();
+};
+
+#endif
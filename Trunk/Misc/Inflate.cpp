@@ -0,0 +1,430 @@
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Inflate.h"
+#include <string.h>
+
+namespace
+{
+    // Base lengths and extra bits for the length symbols 257..285
+    const unsigned short lengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const unsigned char lengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+    // Base distances and extra bits for the distance symbols 0..29
+    const unsigned short distanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    const unsigned char distanceExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // The order in which the code length code lengths are stored
+    const unsigned char codeLengthOrder[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+}
+
+// Constructor
+Inflate::Inflate() :
+    _pInput( 0 ),
+    _inputSize( 0 ),
+    _inputPos( 0 ),
+    _bitBuffer( 0 ),
+    _bitCount( 0 ),
+    _pOutput( 0 ),
+    _outputPos( 0 )
+{
+}
+
+// Destructor
+Inflate::~Inflate()
+{
+}
+
+// Functions
+
+void Inflate::FillBits()
+{
+    // Note: Past the end of the input we shift in zeros; IsOverrun()
+    //       tells us if any of those were actually consumed.
+    while( _bitCount <= 24 )
+    {
+        const unsigned int byte = (_inputPos < _inputSize)? _pInput[ _inputPos ]: 0;
+        ++_inputPos;
+
+        _bitBuffer |= byte << _bitCount;
+        _bitCount += 8;
+    }
+}
+
+const unsigned int Inflate::GetBits(const int &numBits)
+{
+    if( numBits == 0 )
+        return 0;
+
+    if( _bitCount < numBits )
+        FillBits();
+
+    const unsigned int bits = _bitBuffer & ((1u << numBits) - 1);
+    _bitBuffer >>= numBits;
+    _bitCount   -= numBits;
+
+    return bits;
+}
+
+const bool Inflate::IsOverrun() const
+{
+    // The no. of bytes we've actually consumed from the input
+    return (_inputPos - (_bitCount / 8)) > _inputSize;
+}
+
+const bool Inflate::BuildTable(HuffmanTable &table, const Byte *const pLengths, const int &numSymbols)
+{
+    memset( table._fast, 0, sizeof(table._fast) );
+    memset( table._counts, 0, sizeof(table._counts) );
+
+    // Count the no. of codes of each length
+    for(int i=0; i < numSymbols; ++i)
+        ++table._counts[ pLengths[i] ];
+    table._counts[0] = 0;
+
+    // Make sure the code lengths aren't over-subscribed
+    // Note: Incomplete codes are allowed (e.g. a single distance code).
+    int left = 1;
+    for(int len=1; len <= MaxBits; ++len)
+    {
+        left <<= 1;
+        left -= table._counts[len];
+        if( left < 0 )
+            return false;
+    }
+
+    // Sort the symbols by their code lengths
+    unsigned short offsets[MaxBits + 1];
+    offsets[1] = 0;
+    for(int len=1; len < MaxBits; ++len)
+        offsets[len + 1] = offsets[len] + table._counts[len];
+
+    for(int i=0; i < numSymbols; ++i)
+    {
+        if( pLengths[i] )
+            table._symbols[ offsets[ pLengths[i] ]++ ] = (unsigned short)i;
+    }
+
+    // Fill the fast lookup table with all the codes short enough for it.
+    // Note: Huffman codes are packed starting from their most significant bit,
+    //       so the codes are reversed to match the order in which bits are read.
+    int code  = 0;
+    int index = 0;
+    for(int len=1; len <= MaxBits; ++len)
+    {
+        for(int i=0; i < table._counts[len]; ++i, ++code, ++index)
+        {
+            if( len > FastBits )
+                continue;
+
+            int reversed = 0;
+            for(int b=0; b < len; ++b)
+                reversed |= ((code >> b) & 1) << (len - 1 - b);
+
+            const unsigned short entry = (unsigned short)((table._symbols[index] << 4) | len);
+            for(int j = reversed; j < (1 << FastBits); j += (1 << len))
+                table._fast[j] = entry;
+        }
+
+        code <<= 1;
+    }
+
+    return true;
+}
+
+const int Inflate::DecodeSymbol(const HuffmanTable &table)
+{
+    if( _bitCount < MaxBits )
+        FillBits();
+
+    // Try the fast lookup first
+    const unsigned short entry = table._fast[ _bitBuffer & ((1 << FastBits) - 1) ];
+    if( entry )
+    {
+        const int len = entry & 0xF;
+        _bitBuffer >>= len;
+        _bitCount   -= len;
+        return (entry >> 4);
+    }
+
+    // The code is longer than FastBits; decode it one bit at a time
+    int code  = 0;
+    int first = 0;
+    int index = 0;
+    for(int len=1; len <= MaxBits; ++len)
+    {
+        code |= (_bitBuffer >> (len - 1)) & 1;
+
+        const int count = table._counts[len];
+        if( code - first < count )
+        {
+            _bitBuffer >>= len;
+            _bitCount   -= len;
+            return table._symbols[ index + (code - first) ];
+        }
+
+        index += count;
+        first += count;
+        first <<= 1;
+        code  <<= 1;
+    }
+
+    // Invalid code
+    return -1;
+}
+
+void Inflate::ReserveOutput(const std::size_t &numBytes)
+{
+    // Grow the output geometrically so that we don't reallocate for every write
+    const std::size_t required = _outputPos + numBytes;
+    if( required > _pOutput->size() )
+        _pOutput->resize( (required > _pOutput->size() * 2)? required: _pOutput->size() * 2 );
+}
+
+const bool Inflate::InflateStoredBlock()
+{
+    // Discard the remaining bits of the current byte
+    GetBits( _bitCount % 8 );
+
+    const unsigned int len  = GetBits( 16 );
+    const unsigned int nlen = GetBits( 16 );
+    if( len != (~nlen & 0xFFFF) )
+        return false;
+
+    // Copy whatever is still in the bit buffer first
+    ReserveOutput( len );
+    unsigned int i = 0;
+    for( ; (i < len) && (_bitCount >= 8); ++i )
+        (*_pOutput)[ _outputPos++ ] = (Byte)GetBits( 8 );
+
+    // Copy the rest straight from the input
+    const std::size_t remaining = len - i;
+    if( _inputPos + remaining > _inputSize )
+        return false;
+
+    if( remaining )
+    {
+        memcpy( &(*_pOutput)[ _outputPos ], _pInput + _inputPos, remaining );
+        _outputPos += remaining;
+        _inputPos  += remaining;
+    }
+
+    return true;
+}
+
+const bool Inflate::InflateFixedBlock()
+{
+    Byte lengths[ MaxSymbols + 32 ];
+
+    // Literal/Length codes
+    int i = 0;
+    for( ; i < 144; ++i ) lengths[i] = 8;
+    for( ; i < 256; ++i ) lengths[i] = 9;
+    for( ; i < 280; ++i ) lengths[i] = 7;
+    for( ; i < 288; ++i ) lengths[i] = 8;
+    if( !BuildTable( _lengthTable, lengths, 288 ) )
+        return false;
+
+    // Distance codes
+    for( i=0; i < 30; ++i ) lengths[i] = 5;
+    if( !BuildTable( _distanceTable, lengths, 30 ) )
+        return false;
+
+    return InflateCodes();
+}
+
+const bool Inflate::InflateDynamicBlock()
+{
+    const int numLengthCodes    = GetBits( 5 ) + 257;
+    const int numDistanceCodes  = GetBits( 5 ) + 1;
+    const int numCodeLengths    = GetBits( 4 ) + 4;
+    if( numLengthCodes > 286 || numDistanceCodes > 30 )
+        return false;
+
+    // Read the code length code lengths and build a table for them
+    Byte lengths[ 286 + 30 ];
+    memset( lengths, 0, sizeof(lengths) );
+    for(int i=0; i < numCodeLengths; ++i)
+        lengths[ codeLengthOrder[i] ] = (Byte)GetBits( 3 );
+
+    if( !BuildTable( _lengthTable, lengths, 19 ) )
+        return false;
+
+    // Read the literal/length and distance code lengths
+    int index = 0;
+    while( index < numLengthCodes + numDistanceCodes )
+    {
+        const int symbol = DecodeSymbol( _lengthTable );
+        if( symbol < 0 )
+            return false;
+
+        if( symbol < 16 )
+        {
+            lengths[ index++ ] = (Byte)symbol;
+            continue;
+        }
+
+        Byte repeatLength = 0;
+        int repeatCount;
+        if( symbol == 16 )
+        {
+            if( index == 0 )
+                return false;
+
+            repeatLength = lengths[ index - 1 ];
+            repeatCount  = 3 + GetBits( 2 );
+        }
+        else if( symbol == 17 )
+            repeatCount = 3 + GetBits( 3 );
+        else
+            repeatCount = 11 + GetBits( 7 );
+
+        if( index + repeatCount > numLengthCodes + numDistanceCodes )
+            return false;
+
+        while( repeatCount-- )
+            lengths[ index++ ] = repeatLength;
+    }
+
+    // There must be a code for the end-of-block symbol
+    if( lengths[256] == 0 )
+        return false;
+
+    if( !BuildTable( _lengthTable, lengths, numLengthCodes )                        ||
+        !BuildTable( _distanceTable, lengths + numLengthCodes, numDistanceCodes )   )
+        return false;
+
+    return InflateCodes();
+}
+
+const bool Inflate::InflateCodes()
+{
+    for(;;)
+    {
+        // Don't run past the input with corrupt data
+        if( IsOverrun() )
+            return false;
+
+        const int symbol = DecodeSymbol( _lengthTable );
+        if( symbol < 0 )
+            return false;
+
+        // Literal
+        if( symbol < 256 )
+        {
+            ReserveOutput( 1 );
+            (*_pOutput)[ _outputPos++ ] = (Byte)symbol;
+            continue;
+        }
+
+        // End of block
+        if( symbol == 256 )
+            return true;
+
+        // Length/Distance pair
+        const int lengthSymbol = symbol - 257;
+        if( lengthSymbol >= 29 )
+            return false;
+
+        const std::size_t length = lengthBase[ lengthSymbol ] + GetBits( lengthExtra[ lengthSymbol ] );
+
+        const int distanceSymbol = DecodeSymbol( _distanceTable );
+        if( distanceSymbol < 0 || distanceSymbol >= 30 )
+            return false;
+
+        const std::size_t distance = distanceBase[ distanceSymbol ] + GetBits( distanceExtra[ distanceSymbol ] );
+        if( distance > _outputPos )
+            return false;
+
+        // Copy the match; it may overlap the bytes being written.
+        ReserveOutput( length );
+        Byte *const pOut = &(*_pOutput)[0];
+        const std::size_t from = _outputPos - distance;
+        for(std::size_t i=0; i < length; ++i)
+            pOut[ _outputPos + i ] = pOut[ from + i ];
+        _outputPos += length;
+    }
+}
+
+const bool Inflate::Decompress(const Byte *const pInput, const std::size_t &inputSize, Buffer &output)
+{
+    _pInput     = pInput;
+    _inputSize  = inputSize;
+    _inputPos   = 0;
+    _bitBuffer  = 0;
+    _bitCount   = 0;
+    _pOutput    = &output;
+    _outputPos  = output.size();
+
+    bool bRetVal = false;
+    for(;;)
+    {
+        const unsigned int bFinal   = GetBits( 1 );
+        const unsigned int type     = GetBits( 2 );
+
+        bool bBlockResult = false;
+        switch( type )
+        {
+        case 0: bBlockResult = InflateStoredBlock();    break;
+        case 1: bBlockResult = InflateFixedBlock();     break;
+        case 2: bBlockResult = InflateDynamicBlock();   break;
+        default:                                        break;
+        }
+
+        if( !bBlockResult || IsOverrun() )
+            break;
+
+        if( bFinal )
+        {
+            bRetVal = true;
+            break;
+        }
+    }
+
+    // Trim the output to the bytes actually written
+    output.resize( _outputPos );
+    _pOutput = 0;
+
+    return bRetVal;
+}
+
+const bool Inflate::DecompressZlib(const Byte *const pInput, const std::size_t &inputSize, Buffer &output)
+{
+    // zlib header (2 bytes) + Adler-32 (4 bytes)
+    if( inputSize < 6 )
+        return false;
+
+    const unsigned int cmf = pInput[0];
+    const unsigned int flg = pInput[1];
+
+    if( ((cmf << 8) | flg) % 31 != 0    ||  // Header check
+        (cmf & 0x0F) != 8               ||  // Compression method must be DEFLATE
+        (flg & 0x20)                    )   // Preset dictionaries are not supported
+        return false;
+
+    return Decompress( pInput + 2, inputSize - 2, output );
+}
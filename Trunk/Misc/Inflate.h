@@ -0,0 +1,98 @@
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef INFLATE_HEADER
+#define INFLATE_HEADER
+
+#include <vector>
+#include <cstddef>
+
+// Decompresses DEFLATE (RFC 1951) streams, optionally wrapped in a zlib (RFC 1950) header.
+// Note: The Adler-32 checksum of zlib streams is not verified.
+class Inflate
+{
+// Types
+public:
+    typedef unsigned char       Byte;
+    typedef std::vector<Byte>   Buffer;
+
+private:
+    enum
+    {
+        FastBits    = 9,    // No. of bits looked up at once while decoding a Huffman code
+        MaxBits     = 15,   // Maximum length of a Huffman code
+        MaxSymbols  = 288   // Maximum no. of symbols in a Huffman table
+    };
+
+    struct HuffmanTable
+    {
+        unsigned short  _fast[1 << FastBits];   // (symbol << 4) | length; 0 if the code is longer than FastBits
+        unsigned short  _counts[MaxBits + 1];   // No. of codes of each length
+        unsigned short  _symbols[MaxSymbols];   // Symbols ordered by their canonical codes
+    };
+
+// Members
+private:
+    const Byte     *_pInput;
+    std::size_t     _inputSize;
+    std::size_t     _inputPos;
+    unsigned int    _bitBuffer;
+    int             _bitCount;
+
+    Buffer         *_pOutput;
+    std::size_t     _outputPos;
+
+    HuffmanTable    _lengthTable;
+    HuffmanTable    _distanceTable;
+
+public:
+// Constructor
+    explicit Inflate();
+// Destructor
+    ~Inflate();
+
+private:
+// Copy Constructor / Assignment Operator
+    Inflate(const Inflate &);
+    const Inflate &operator =(const Inflate &);
+
+// Functions
+private:
+    void FillBits();
+    const unsigned int GetBits(const int &numBits);
+    const bool IsOverrun() const;
+
+    static const bool BuildTable(HuffmanTable &table, const Byte *const pLengths, const int &numSymbols);
+    const int DecodeSymbol(const HuffmanTable &table);
+
+    void ReserveOutput(const std::size_t &numBytes);
+
+    const bool InflateStoredBlock();
+    const bool InflateFixedBlock();
+    const bool InflateDynamicBlock();
+    const bool InflateCodes();
+
+public:
+    // Decompresses a raw DEFLATE stream, appending to the output buffer.
+    const bool Decompress(const Byte *const pInput, const std::size_t &inputSize, Buffer &output);
+
+    // Decompresses a zlib wrapped DEFLATE stream, appending to the output buffer.
+    const bool DecompressZlib(const Byte *const pInput, const std::size_t &inputSize, Buffer &output);
+};
+
+#endif
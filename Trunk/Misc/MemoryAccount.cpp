@@ -0,0 +1,136 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "MemoryAccount.h"
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+
+namespace
+{
+    const char *const SubsystemNames[MemoryAccount::NumSubsystems] =
+    {
+        "Scene objects",
+        "Textures",
+        "Images",
+        "Film",
+        "Parse",
+        "Light tree"
+    };
+
+    // Writes a size in KiB
+    void WriteSize(std::ostream &stream, const std::size_t &size)
+    {
+        stream << std::setw( 12 ) << size / 1024.0 << " KiB";
+    }
+}
+
+// Members
+std::size_t MemoryAccount::_live[MemoryAccount::NumSubsystems]   = { 0 };
+std::size_t MemoryAccount::_peak[MemoryAccount::NumSubsystems]   = { 0 };
+std::size_t MemoryAccount::_totalLive                           = 0;
+std::size_t MemoryAccount::_totalPeak                           = 0;
+std::size_t MemoryAccount::_limit                               = 0;
+
+// Allocation's Constructor
+MemoryAccount::Allocation::Allocation(const Subsystem &subsystem) :
+    _subsystem( subsystem ),
+    _size( 0 )
+{
+}
+
+// Allocation's Destructor
+MemoryAccount::Allocation::~Allocation()
+{
+    SetSize( 0 );
+}
+
+// Allocation's Functions
+void MemoryAccount::Allocation::SetSubsystem(const Subsystem &subsystem)
+{
+    const std::size_t size = _size;
+    SetSize( 0 );
+    _subsystem = subsystem;
+    SetSize( size );
+}
+
+void MemoryAccount::Allocation::SetSize(const std::size_t &size)
+{
+    if( size > _size )
+        MemoryAccount::Add( _subsystem, size - _size );
+    else
+        MemoryAccount::Remove( _subsystem, _size - size );
+
+    _size = size;
+}
+
+// Functions
+void MemoryAccount::Add(const Subsystem &subsystem, const std::size_t &size)
+{
+    _live[subsystem] += size;
+    _totalLive += size;
+
+    if( _live[subsystem] > _peak[subsystem] )
+        _peak[subsystem] = _live[subsystem];
+    if( _totalLive > _totalPeak )
+        _totalPeak = _totalLive;
+
+    if( (_limit > 0) && (_totalLive > _limit) )
+    {
+        std::cout << std::endl << "Error: Memory limit of " << _limit / (1024.0 * 1024.0) << " MiB exceeded, while allocating "
+            << size << " bytes for: " << SubsystemNames[subsystem] << std::endl;
+        Write( std::cout );
+        exit( -1 );
+    }
+}
+
+void MemoryAccount::Remove(const Subsystem &subsystem, const std::size_t &size)
+{
+    _live[subsystem] -= size;
+    _totalLive -= size;
+}
+
+void MemoryAccount::SetLimit(const std::size_t &limit)
+{
+    _limit = limit;
+}
+
+void MemoryAccount::Write(std::ostream &stream)
+{
+    const std::ios_base::fmtflags flags = stream.flags();
+    const std::streamsize precision = stream.precision( 1 );
+    stream.setf( std::ios::fixed );
+
+    stream << "Memory" << std::setw( 25 ) << "Live" << std::setw( 17 ) << "Peak" << std::endl;
+    for(int i=0; i < NumSubsystems; ++i)
+    {
+        stream << "  " << std::left << std::setw( 15 ) << SubsystemNames[i] << std::right;
+        WriteSize( stream, _live[i] );
+        WriteSize( stream, _peak[i] );
+        stream << std::endl;
+    }
+
+    stream << "  " << std::left << std::setw( 15 ) << "Total" << std::right;
+    WriteSize( stream, _totalLive );
+    WriteSize( stream, _totalPeak );
+    stream << std::endl;
+
+    stream.flags( flags );
+    stream.precision( precision );
+}
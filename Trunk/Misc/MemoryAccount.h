@@ -0,0 +1,103 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MEMORYACCOUNT_HEADER
+#define MEMORYACCOUNT_HEADER
+
+#include <cstddef>
+#include <ostream>
+
+// Attributes the memory in use (live) and the most that was ever in use (peak) to the subsystems
+// which hold most of it. Memory is accounted for by its owners as they allocate and release it,
+// either directly, or through an Allocation which they keep up to date with the size of their buffers.
+// If a limit is set, the process exits (with a report of the memory in use) as soon as it's exceeded,
+// rather than carrying on until it runs out of memory.
+// Note: The renderer is single threaded (renders are spread over processes instead), so there's
+//       a single account for the process.
+class MemoryAccount
+{
+// Types
+public:
+    enum Subsystem
+    {
+        Subsystem_SceneObjects,     // Serializables: Primitives, Materials, Lights, Textures and Scenes
+        Subsystem_Textures,         // Pixels of the Textures
+        Subsystem_Images,           // Pixels of the other Images; mostly the framebuffer
+        Subsystem_Film,             // Samples accumulated for the pixels
+        Subsystem_Parse,            // Text of the scene file, while it's being parsed
+        Subsystem_LightTree,
+        NumSubsystems
+    };
+
+    // Accounts for a buffer of an owner, which sets its size whenever it changes
+    class Allocation
+    {
+    // Members
+    private:
+        Subsystem   _subsystem;
+        std::size_t _size;
+
+    public:
+    // Constructor
+        explicit Allocation(const Subsystem &subsystem);
+    // Destructor
+        ~Allocation();
+
+    private:
+    // Copy Constructor / Assignment Operator
+        Allocation(const Allocation &);
+        const Allocation &operator =(const Allocation &);
+
+    // Functions
+    public:
+        void SetSubsystem(const Subsystem &subsystem);
+        void SetSize(const std::size_t &size);
+    };
+
+// Members
+private:
+    static std::size_t  _live[NumSubsystems];
+    static std::size_t  _peak[NumSubsystems];
+    static std::size_t  _totalLive;
+    static std::size_t  _totalPeak;
+    static std::size_t  _limit;         // In bytes; 0 for no limit
+
+// Constructor
+private:
+    explicit MemoryAccount();
+// Destructor
+    ~MemoryAccount();
+
+// Copy Constructor / Assignment Operator
+    MemoryAccount(const MemoryAccount &);
+    const MemoryAccount &operator =(const MemoryAccount &);
+
+// Functions
+public:
+    // Exits the process if this takes the total over the limit
+    static void Add(const Subsystem &subsystem, const std::size_t &size);
+    static void Remove(const Subsystem &subsystem, const std::size_t &size);
+
+    static void SetLimit(const std::size_t &limit);
+
+    // Writes the live and peak memory of each subsystem as a table
+    static void Write(std::ostream &stream);
+};
+
+#endif
@@ -0,0 +1,118 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Message.h"
+#include "Socket.h"
+
+namespace
+{
+    // Guards against allocating whatever a corrupt header asks for
+    const unsigned int MaxPayloadSize = 1u << 30;
+
+    // The type and the size of the payload
+    const std::size_t HeaderSize = 2 * sizeof(unsigned int);
+}
+
+// Constructor
+Message::Message(const int &type) :
+    _type( type ),
+    _payload(),
+    _readPos( 0 )
+{
+}
+
+// Destructor
+Message::~Message()
+{
+}
+
+// Functions
+const int &Message::Type() const
+{
+    return _type;
+}
+
+void Message::Reset(const int &type)
+{
+    _type = type;
+    _payload.clear();
+    _readPos = 0;
+}
+
+void Message::WriteString(const std::string &str)
+{
+    Write( (unsigned int)str.size() );
+    _payload.insert( _payload.end(), str.begin(), str.end() );
+}
+
+void Message::WriteBuffer(const Buffer &buffer)
+{
+    Write( (unsigned int)buffer.size() );
+    _payload.insert( _payload.end(), buffer.begin(), buffer.end() );
+}
+
+const bool Message::ReadString(std::string &str)
+{
+    unsigned int size;
+    if( !Read( size ) || (_readPos + size > _payload.size()) )
+        return false;
+
+    str.assign( _payload.begin() + _readPos, _payload.begin() + _readPos + size );
+    _readPos += size;
+    return true;
+}
+
+const bool Message::ReadBuffer(Buffer &buffer)
+{
+    unsigned int size;
+    if( !Read( size ) || (_readPos + size > _payload.size()) )
+        return false;
+
+    buffer.assign( _payload.begin() + _readPos, _payload.begin() + _readPos + size );
+    _readPos += size;
+    return true;
+}
+
+const bool Message::Send(Socket &socket) const
+{
+    Buffer header;
+    Utility::ByteOrder::Write( header, (unsigned int)_type );
+    Utility::ByteOrder::Write( header, (unsigned int)_payload.size() );
+
+    return
+        socket.Send( &header[0], header.size() ) &&
+        (_payload.empty() || socket.Send( &_payload[0], _payload.size() ));
+}
+
+const bool Message::Receive(Socket &socket)
+{
+    Buffer header( HeaderSize );
+    std::size_t pos = 0;
+    unsigned int type, size;
+    if( !socket.Receive( &header[0], header.size() ) ||
+        !Utility::ByteOrder::Read( header, pos, type ) || !Utility::ByteOrder::Read( header, pos, size ) ||
+        (size > MaxPayloadSize) )
+        return false;
+
+    Reset( (int)type );
+    _payload.resize( size );
+
+    return _payload.empty() || socket.Receive( &_payload[0], _payload.size() );
+}
@@ -0,0 +1,89 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef MESSAGE_HEADER
+#define MESSAGE_HEADER
+
+#include "Utility.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Forward Declarations
+class Socket;
+
+// A message sent over a Socket; a type followed by a payload of values.
+// Values are written in little-endian byte order (see Utility::ByteOrder), so the two ends needn't
+// run on the same kind of machine.
+class Message
+{
+// Types
+public:
+    typedef std::vector<unsigned char>  Buffer;
+
+// Members
+private:
+    int         _type;
+    Buffer      _payload;
+    std::size_t _readPos;
+
+public:
+// Constructor
+    explicit Message(const int &type = 0);
+// Destructor
+    ~Message();
+
+private:
+// Copy Constructor / Assignment Operator
+    Message(const Message &);
+    const Message &operator =(const Message &);
+
+// Functions
+public:
+    const int &Type() const;
+
+    // Starts a new message
+    void Reset(const int &type);
+
+    void WriteString(const std::string &str);
+    void WriteBuffer(const Buffer &buffer);
+
+    // These return false if the payload doesn't hold the value.
+    const bool ReadString(std::string &str);
+    const bool ReadBuffer(Buffer &buffer);
+
+    const bool Send(Socket &socket) const;
+    const bool Receive(Socket &socket);
+
+    // Templates
+    template <class T>
+    void Write(const T &val)
+    {
+        Utility::ByteOrder::Write( _payload, val );
+    }
+
+    template <class T>
+    const bool Read(T &val)
+    {
+        return Utility::ByteOrder::Read( _payload, _readPos, val );
+    }
+};
+
+#endif
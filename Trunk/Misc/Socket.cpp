@@ -0,0 +1,314 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Socket.h"
+#include <iostream>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _MSVC
+    #define WIN32_LEAN_AND_MEAN
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment( lib, "ws2_32.lib" )
+
+    typedef int socklen_t;
+    #define CloseSocket closesocket
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <sys/un.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <netdb.h>
+    #include <unistd.h>
+
+    #define CloseSocket close
+#endif
+
+namespace
+{
+    const int InvalidHandle = -1;
+
+    // Don't get killed by SIGPIPE when the other end goes away; Send() just fails instead
+#ifdef MSG_NOSIGNAL
+    const int SendFlags = MSG_NOSIGNAL;
+#else
+    const int SendFlags = 0;
+#endif
+
+#ifdef _MSVC
+    // Winsock must be started before it's used
+    const bool StartSockets()
+    {
+        static bool bStarted = false;
+        if( !bStarted )
+        {
+            WSADATA data;
+            bStarted = (WSAStartup( MAKEWORD(2, 2), &data ) == 0);
+        }
+
+        return bStarted;
+    }
+#else
+    const bool StartSockets()
+    {
+        return true;
+    }
+#endif
+}
+
+// Constructor
+Socket::Socket() :
+    _handle( InvalidHandle ),
+    _unixPath()
+{
+}
+
+// Destructor
+Socket::~Socket()
+{
+    Close();
+}
+
+// Functions
+const bool Socket::Create(const std::string &address, const bool &bListen, std::vector<char> &socketAddress)
+{
+    Close();
+
+    if( !StartSockets() )
+        return false;
+
+    // Unix-domain socket
+    if( address.substr( 0, 5 ) == "unix:" )
+    {
+#ifdef _MSVC
+        std::cout << "Error: Unix-domain sockets aren't supported on this platform: " << address << std::endl;
+        return false;
+#else
+        const std::string path = address.substr( 5 );
+
+        sockaddr_un unixAddress;
+        memset( &unixAddress, 0, sizeof(unixAddress) );
+        if( path.empty() || (path.size() >= sizeof(unixAddress.sun_path)) )
+        {
+            std::cout << "Error: Invalid socket path: " << path << std::endl;
+            return false;
+        }
+
+        unixAddress.sun_family = AF_UNIX;
+        strcpy( unixAddress.sun_path, path.c_str() );
+
+        socketAddress.assign( (const char *)&unixAddress, (const char *)&unixAddress + sizeof(unixAddress) );
+        _handle = (int)socket( AF_UNIX, SOCK_STREAM, 0 );
+        return (_handle != InvalidHandle);
+#endif
+    }
+
+    // TCP socket
+    const std::size_t separator = address.rfind( ':' );
+    const std::string host = (separator == std::string::npos)? "": address.substr( 0, separator );
+    const std::string port = (separator == std::string::npos)? address: address.substr( separator + 1 );
+
+    addrinfo hints;
+    memset( &hints, 0, sizeof(hints) );
+    hints.ai_family     = AF_INET;
+    hints.ai_socktype   = SOCK_STREAM;
+    hints.ai_flags      = bListen? AI_PASSIVE: 0;
+
+    addrinfo *pInfo = 0;
+    if( (getaddrinfo( host.empty()? 0: host.c_str(), port.c_str(), &hints, &pInfo ) != 0) || !pInfo )
+    {
+        std::cout << "Error: Invalid address: " << address << std::endl;
+        return false;
+    }
+
+    socketAddress.assign( (const char *)pInfo->ai_addr, (const char *)pInfo->ai_addr + pInfo->ai_addrlen );
+    freeaddrinfo( pInfo );
+
+    _handle = (int)socket( AF_INET, SOCK_STREAM, 0 );
+    if( _handle == InvalidHandle )
+        return false;
+
+    // Tiles are sent as soon as they're done, so don't hold back small messages
+    const int bNoDelay = 1;
+    setsockopt( _handle, IPPROTO_TCP, TCP_NODELAY, (const char *)&bNoDelay, sizeof(bNoDelay) );
+
+    if( bListen )
+    {
+        const int bReuse = 1;
+        setsockopt( _handle, SOL_SOCKET, SO_REUSEADDR, (const char *)&bReuse, sizeof(bReuse) );
+    }
+
+    return true;
+}
+
+const bool Socket::Listen(const std::string &address)
+{
+    std::vector<char> socketAddress;
+    if( !Create( address, true, socketAddress ) )
+        return false;
+
+    // Remove any stale Unix-domain socket left behind by an earlier run
+    if( address.substr( 0, 5 ) == "unix:" )
+    {
+        _unixPath = address.substr( 5 );
+#ifndef _MSVC
+        unlink( _unixPath.c_str() );
+#endif
+    }
+
+    if( (bind( _handle, (const sockaddr *)&socketAddress[0], (socklen_t)socketAddress.size() ) != 0) ||
+        (listen( _handle, 16 ) != 0) )
+    {
+        std::cout << "Error: Failed to listen on address: " << address << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+const bool Socket::Accept(Socket &client)
+{
+    client.Close();
+
+    client._handle = (int)accept( _handle, 0, 0 );
+    return client.IsOpen();
+}
+
+const bool Socket::Connect(const std::string &address)
+{
+    std::vector<char> socketAddress;
+    if( !Create( address, false, socketAddress ) )
+        return false;
+
+    if( connect( _handle, (const sockaddr *)&socketAddress[0], (socklen_t)socketAddress.size() ) != 0 )
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+const bool Socket::Send(const void *const pData, const std::size_t &size)
+{
+    const char *pBytes = static_cast<const char *>( pData );
+    std::size_t remaining = size;
+    while( remaining > 0 )
+    {
+        const int sent = (int)send( _handle, pBytes, (int)remaining, SendFlags );
+        if( sent <= 0 )
+            return false;
+
+        pBytes      += sent;
+        remaining   -= sent;
+    }
+
+    return true;
+}
+
+const bool Socket::Receive(void *const pData, const std::size_t &size)
+{
+    char *pBytes = static_cast<char *>( pData );
+    std::size_t remaining = size;
+    while( remaining > 0 )
+    {
+        const int received = (int)recv( _handle, pBytes, (int)remaining, 0 );
+        if( received <= 0 )
+            return false;
+
+        pBytes      += received;
+        remaining   -= received;
+    }
+
+    return true;
+}
+
+const bool Socket::ReceiveSome(void *const pData, const std::size_t &size, std::size_t &received)
+{
+    const int result = (int)recv( _handle, static_cast<char *>( pData ), (int)size, 0 );
+    if( result <= 0 )
+    {
+        received = 0;
+        return false;
+    }
+
+    received = result;
+    return true;
+}
+
+const bool Socket::WaitForData(const SocketArray &sockets, BoolArray &bReadable, const double &timeout)
+{
+    fd_set readSet;
+    FD_ZERO( &readSet );
+
+    int maxHandle = 0;
+    for(std::size_t i=0; i < sockets.size(); ++i)
+    {
+        if( !sockets[i]->IsOpen() )
+            continue;
+
+        FD_SET( sockets[i]->_handle, &readSet );
+        if( sockets[i]->_handle > maxHandle )
+            maxHandle = sockets[i]->_handle;
+    }
+
+    timeval timeoutValue;
+    timeoutValue.tv_sec     = (long)timeout;
+    timeoutValue.tv_usec    = (long)((timeout - timeoutValue.tv_sec) * 1000000);
+
+    // Being interrupted by a signal just means nothing became readable
+    if( select( maxHandle + 1, &readSet, 0, 0, (timeout < 0)? 0: &timeoutValue ) < 0 )
+    {
+        if( errno != EINTR )
+            return false;
+
+        FD_ZERO( &readSet );
+    }
+
+    bReadable.resize( sockets.size() );
+    for(std::size_t i=0; i < sockets.size(); ++i)
+        bReadable[i] = sockets[i]->IsOpen() && FD_ISSET( sockets[i]->_handle, &readSet );
+
+    return true;
+}
+
+const bool Socket::IsOpen() const
+{
+    return (_handle != InvalidHandle);
+}
+
+void Socket::Close()
+{
+    if( _handle != InvalidHandle )
+    {
+        CloseSocket( _handle );
+        _handle = InvalidHandle;
+    }
+
+#ifndef _MSVC
+    if( !_unixPath.empty() )
+        unlink( _unixPath.c_str() );
+#endif
+    _unixPath.clear();
+}
@@ -0,0 +1,80 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef SOCKET_HEADER
+#define SOCKET_HEADER
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// A blocking stream socket.
+// Addresses are either "unix:<path>" for a Unix-domain socket, or "[host:]port" for TCP
+// (a listening socket without a host listens on all interfaces).
+class Socket
+{
+// Types
+public:
+    typedef std::vector<Socket *>   SocketArray;
+    typedef std::vector<bool>       BoolArray;
+
+// Members
+private:
+    int         _handle;
+    std::string _unixPath;  // Path of the Unix-domain socket we're listening on (removed when closed)
+
+public:
+// Constructor
+    explicit Socket();
+// Destructor
+    ~Socket();
+
+private:
+// Copy Constructor / Assignment Operator
+    Socket(const Socket &);
+    const Socket &operator =(const Socket &);
+
+// Functions
+private:
+    // Creates the socket and fills in the socket address for the address string.
+    const bool Create(const std::string &address, const bool &bListen, std::vector<char> &socketAddress);
+
+public:
+    const bool Listen(const std::string &address);
+    const bool Accept(Socket &client);
+    const bool Connect(const std::string &address);
+
+    // These return false if the connection is closed (or fails) before all the data is transferred.
+    const bool Send(const void *const pData, const std::size_t &size);
+    const bool Receive(void *const pData, const std::size_t &size);
+
+    // Receives whatever data has arrived (waiting for some if there's none), up to the size.
+    // Returns false if the connection is closed (or fails).
+    const bool ReceiveSome(void *const pData, const std::size_t &size, std::size_t &received);
+
+    // Waits until some of the sockets have data to be read (or connections to be accepted),
+    // and sets bReadable for them. A negative timeout (in seconds) waits indefinitely.
+    static const bool WaitForData(const SocketArray &sockets, BoolArray &bReadable, const double &timeout = -1);
+
+    const bool IsOpen() const;
+    void Close();
+};
+
+#endif
@@ -0,0 +1,131 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Statistics.h"
+#include "Timer.h"
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char *const CounterNames[Statistics::NumCounters] =
+    {
+        "primaryRays",
+        "reflectionRays",
+        "fuzzyRays",
+        "refractionRays",
+        "shadowRays",
+        "primitiveTests",
+        "textureSamples"
+    };
+
+    const char *const PhaseNames[Statistics::NumPhases] =
+    {
+        "parse",
+        "textureLoad",
+        "build",
+        "render",
+        "save"
+    };
+}
+
+// Members
+unsigned long long  Statistics::_counts[Statistics::NumCounters]        = { 0 };
+int                 Statistics::_maxRayDepth                            = 0;
+double              Statistics::_phaseTimes[Statistics::NumPhases]      = { 0 };
+double              Statistics::_phaseStartTimes[Statistics::NumPhases] = { 0 };
+
+// Functions
+const unsigned long long &Statistics::Count(const Counter &counter)
+{
+    return _counts[counter];
+}
+
+void Statistics::StartPhase(const Phase &phase)
+{
+    _phaseStartTimes[phase] = Timer::CurrentTime();
+}
+
+void Statistics::EndPhase(const Phase &phase)
+{
+    _phaseTimes[phase] += Timer::CurrentTime() - _phaseStartTimes[phase];
+}
+
+void Statistics::Reset()
+{
+    for(int i=0; i < NumCounters; ++i)
+        _counts[i] = 0;
+
+    _maxRayDepth = 0;
+
+    for(int i=0; i < NumPhases; ++i)
+    {
+        _phaseTimes[i]      = 0;
+        _phaseStartTimes[i] = 0;
+    }
+}
+
+void Statistics::Write(std::ostream &stream)
+{
+    unsigned long long totalRays = 0;
+    for(int i=0; i < NumCounters; ++i)
+    {
+        if( (i != Counter_PrimitiveTests) && (i != Counter_TextureSamples) )
+            totalRays += _counts[i];
+    }
+
+    const double renderTime = _phaseTimes[Phase_Render];
+
+    stream << "{" << std::endl;
+
+    stream << "    \"counters\": {" << std::endl;
+    for(int i=0; i < NumCounters; ++i)
+        stream << "        \"" << CounterNames[i] << "\": " << _counts[i] << "," << std::endl;
+    stream << "        \"maxRayDepth\": " << _maxRayDepth << "," << std::endl;
+    stream << "        \"totalRays\": " << totalRays << "," << std::endl;
+    stream << "        \"raysPerSecond\": " << ((renderTime > 0)? totalRays / renderTime: 0) << std::endl;
+    stream << "    }," << std::endl;
+
+    stream << "    \"phaseSeconds\": {" << std::endl;
+    for(int i=0; i < NumPhases; ++i)
+        stream << "        \"" << PhaseNames[i] << "\": " << _phaseTimes[i] << ((i + 1 < NumPhases)? ",": "") << std::endl;
+    stream << "    }" << std::endl;
+
+    stream << "}" << std::endl;
+}
+
+const bool Statistics::Save(const std::string &fileName)
+{
+    std::ofstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open statistics file: " << fileName << std::endl;
+        return false;
+    }
+
+    Write( stream );
+
+    if( stream.fail() )
+    {
+        std::cout << "Error: Failed while writing statistics file: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,115 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STATISTICS_HEADER
+#define STATISTICS_HEADER
+
+#include <string>
+#include <ostream>
+
+// Counts the work done while rendering, and times the phases of a render.
+// The counting is only compiled in if _STATISTICS is defined; otherwise the STATISTICS_* macros
+// below expand to nothing, so the hot paths pay nothing for it.
+// Note: The renderer is single threaded (renders are spread over processes instead), so there's
+//       a single set of counters for the process.
+class Statistics
+{
+// Types
+public:
+    enum Counter
+    {
+        Counter_PrimaryRays,        // Rays traced from the camera
+        Counter_ReflectionRays,     // Mirror reflections
+        Counter_FuzzyRays,          // Fuzzy reflections
+        Counter_RefractionRays,     // Transmitted rays
+        Counter_ShadowRays,         // Rays from surfaces to the lights
+        Counter_PrimitiveTests,     // Ray-primitive intersection tests
+        Counter_TextureSamples,     // Texels looked up from diffuse maps
+        NumCounters
+    };
+
+    // Note: The phases nest; parsing includes loading the textures and building the light tree.
+    enum Phase
+    {
+        Phase_Parse,
+        Phase_TextureLoad,
+        Phase_Build,                // Building (or refitting) the light tree
+        Phase_Render,
+        Phase_Save,
+        NumPhases
+    };
+
+// Members
+private:
+    static unsigned long long   _counts[NumCounters];
+    static int                  _maxRayDepth;       // Deepest chain of bounces from a primary ray
+    static double               _phaseTimes[NumPhases];
+    static double               _phaseStartTimes[NumPhases];
+
+// Constructor
+private:
+    explicit Statistics();
+// Destructor
+    ~Statistics();
+
+// Copy Constructor / Assignment Operator
+    Statistics(const Statistics &);
+    const Statistics &operator =(const Statistics &);
+
+// Functions
+public:
+    // These are called on every ray, so they're inlined
+    static void Add(const Counter &counter, const unsigned long long &count)
+    {
+        _counts[counter] += count;
+    }
+
+    static void RecordRayDepth(const int &depth)
+    {
+        if( depth > _maxRayDepth )
+            _maxRayDepth = depth;
+    }
+
+    static const unsigned long long &Count(const Counter &counter);
+
+    static void StartPhase(const Phase &phase);
+    static void EndPhase(const Phase &phase);
+
+    static void Reset();
+
+    // Writes the counters and the phase timings as a JSON object
+    static void Write(std::ostream &stream);
+    static const bool Save(const std::string &fileName);
+};
+
+#ifdef _STATISTICS
+    #define STATISTICS_INCREMENT(Counter)           Statistics::Add( Statistics::Counter, 1 )
+    #define STATISTICS_ADD(Counter,Count)           Statistics::Add( Statistics::Counter, (Count) )
+    #define STATISTICS_RAY_DEPTH(Depth)             Statistics::RecordRayDepth( (Depth) )
+    #define STATISTICS_START_PHASE(Phase)           Statistics::StartPhase( Statistics::Phase )
+    #define STATISTICS_END_PHASE(Phase)             Statistics::EndPhase( Statistics::Phase )
+#else
+    #define STATISTICS_INCREMENT(Counter)
+    #define STATISTICS_ADD(Counter,Count)
+    #define STATISTICS_RAY_DEPTH(Depth)
+    #define STATISTICS_START_PHASE(Phase)
+    #define STATISTICS_END_PHASE(Phase)
+#endif
+
+#endif
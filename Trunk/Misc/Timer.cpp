@@ -0,0 +1,74 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Timer.h"
+
+#ifdef _MSVC
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/time.h>
+    #include <unistd.h>
+#endif
+
+// Constructor
+Timer::Timer() :
+    _startTime( CurrentTime() )
+{
+}
+
+// Destructor
+Timer::~Timer()
+{
+}
+
+// Functions
+const double Timer::CurrentTime()
+{
+#ifdef _MSVC
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &counter );
+    return counter.QuadPart / (double)frequency.QuadPart;
+#else
+    timeval time;
+    gettimeofday( &time, 0 );
+    return time.tv_sec + time.tv_usec / 1000000.0;
+#endif
+}
+
+void Timer::Sleep(const double &seconds)
+{
+#ifdef _MSVC
+    ::Sleep( (DWORD)(seconds * 1000) );
+#else
+    usleep( (useconds_t)(seconds * 1000000) );
+#endif
+}
+
+void Timer::Reset()
+{
+    _startTime = CurrentTime();
+}
+
+const double Timer::ElapsedTime() const
+{
+    return CurrentTime() - _startTime;
+}
@@ -0,0 +1,57 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef TIMER_HEADER
+#define TIMER_HEADER
+
+// Measures wall-clock time, in seconds.
+class Timer
+{
+// Members
+private:
+    double  _startTime;
+
+public:
+// Constructor
+    explicit Timer();
+// Destructor
+    ~Timer();
+
+private:
+// Copy Constructor / Assignment Operator
+    Timer(const Timer &);
+    const Timer &operator =(const Timer &);
+
+// Functions
+public:
+    // Returns the current time, from an arbitrary (but fixed) point in the past.
+    static const double CurrentTime();
+
+    // Blocks the calling thread for the specified time.
+    static void Sleep(const double &seconds);
+
+    // Starts timing from now.
+    void Reset();
+
+    // Returns the time elapsed since the timer was constructed or last Reset().
+    const double ElapsedTime() const;
+};
+
+#endif
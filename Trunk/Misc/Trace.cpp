@@ -0,0 +1,167 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Trace.h"
+#include "Timer.h"
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    // Writes a string as a JSON string
+    void WriteJsonString(std::ostream &stream, const std::string &str)
+    {
+        stream << '"';
+        for(std::size_t i=0; i < str.size(); ++i)
+        {
+            const char c = str[i];
+            if( (c == '"') || (c == '\\') )
+                stream << '\\' << c;
+            else if( (unsigned char)c < 0x20 )
+                stream << ' ';
+            else
+                stream << c;
+        }
+        stream << '"';
+    }
+}
+
+// Members
+bool                Trace::_bStarted    = false;
+double              Trace::_startTime   = 0;
+Trace::EventArray   Trace::_events;
+std::size_t         Trace::_numEvents   = 0;
+
+// Scope's Constructors
+Trace::Scope::Scope(const char *const name) :
+    _name( name ),
+    _detail(),
+    _beginTime( Trace::IsStarted()? Timer::CurrentTime(): -1 )
+{
+}
+
+Trace::Scope::Scope(const char *const name, const std::string &detail) :
+    _name( name ),
+    _detail( Trace::IsStarted()? detail: std::string() ),
+    _beginTime( Trace::IsStarted()? Timer::CurrentTime(): -1 )
+{
+}
+
+// Scope's Destructor
+Trace::Scope::~Scope()
+{
+    End();
+}
+
+// Scope's Functions
+void Trace::Scope::End()
+{
+    if( _beginTime < 0 )
+        return;
+
+    Trace::AddEvent( _name, _detail, _beginTime, Timer::CurrentTime() );
+    _beginTime = -1;
+}
+
+// Functions
+void Trace::AddEvent(const char *const name, const std::string &detail, const double &beginTime, const double &endTime)
+{
+    if( !_bStarted )
+        return;
+
+    Event &event = _events[ _numEvents % _events.size() ];
+    event._name         = name;
+    event._detail       = detail;
+    event._beginTime    = beginTime;
+    event._endTime      = endTime;
+
+    ++_numEvents;
+}
+
+void Trace::Start(const std::size_t &capacity)
+{
+    _events.clear();
+    _events.resize( (capacity > 0)? capacity: 1 );
+    _numEvents  = 0;
+    _startTime  = Timer::CurrentTime();
+    _bStarted   = true;
+}
+
+void Trace::Stop()
+{
+    _bStarted = false;
+}
+
+const bool Trace::IsStarted()
+{
+    return _bStarted;
+}
+
+const bool Trace::Save(const std::string &fileName)
+{
+    std::ofstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open trace file: " << fileName << std::endl;
+        return false;
+    }
+
+    // The oldest events have been overwritten if the buffer wrapped around
+    const std::size_t numEvents  = (_numEvents < _events.size())? _numEvents: _events.size();
+    const std::size_t firstEvent = _numEvents - numEvents;
+
+    // Note: Chrome traces are timed in microseconds. The events are complete events ("X"),
+    //       which carry both their begin time and their duration.
+    stream.setf( std::ios::fixed );
+    stream.precision( 3 );
+    stream << "{" << std::endl << "    \"traceEvents\": [";
+
+    for(std::size_t i=0; i < numEvents; ++i)
+    {
+        const Event &event = _events[ (firstEvent + i) % _events.size() ];
+
+        stream << ((i > 0)? ",": "") << std::endl << "        { \"name\": ";
+        WriteJsonString( stream, event._name );
+        stream << ", \"ph\": \"X\", \"pid\": 1, \"tid\": 1";
+        stream << ", \"ts\": " << (event._beginTime - _startTime) * 1000000;
+        stream << ", \"dur\": " << (event._endTime - event._beginTime) * 1000000;
+
+        if( !event._detail.empty() )
+        {
+            stream << ", \"args\": { \"detail\": ";
+            WriteJsonString( stream, event._detail );
+            stream << " }";
+        }
+
+        stream << " }";
+    }
+
+    stream << std::endl << "    ]," << std::endl << "    \"displayTimeUnit\": \"ms\"" << std::endl << "}" << std::endl;
+
+    if( stream.fail() )
+    {
+        std::cout << "Error: Failed while writing trace file: " << fileName << std::endl;
+        return false;
+    }
+
+    if( firstEvent > 0 )
+        std::cout << "The trace only has the last " << numEvents << " events; " << firstEvent << " earlier ones were dropped." << std::endl;
+
+    return true;
+}
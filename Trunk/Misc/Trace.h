@@ -0,0 +1,109 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACE_HEADER
+#define TRACE_HEADER
+
+#include <string>
+#include <vector>
+
+// Records a timeline of what a render did (loading the scene, rendering each tile, etc.), which is
+// saved in the Chrome trace event format; it can be viewed with chrome://tracing or Perfetto.
+// Events are recorded by Scope objects, and only while tracing is started.
+// Note: The renderer is single threaded, so there's a single buffer for the process. It's a ring
+//       buffer which keeps the latest events, so that a long render doesn't keep allocating memory.
+class Trace
+{
+// Types
+public:
+    // Records an event from its construction until it's ended (or destructed)
+    class Scope
+    {
+    // Members
+    private:
+        const char *_name;
+        std::string _detail;
+        double      _beginTime;     // Negative if the event isn't being recorded
+
+    public:
+    // Constructors
+        explicit Scope(const char *const name);
+        explicit Scope(const char *const name, const std::string &detail);
+    // Destructor
+        ~Scope();
+
+    private:
+    // Copy Constructor / Assignment Operator
+        Scope(const Scope &);
+        const Scope &operator =(const Scope &);
+
+    // Functions
+    public:
+        void End();
+    };
+
+private:
+    struct Event
+    {
+        const char *_name;
+        std::string _detail;
+        double      _beginTime;
+        double      _endTime;
+    };
+
+    typedef std::vector<Event> EventArray;
+
+    enum
+    {
+        DefaultCapacity = 65536     // No. of events kept
+    };
+
+// Members
+private:
+    static bool         _bStarted;
+    static double       _startTime;
+    static EventArray   _events;
+    static std::size_t  _numEvents;     // No. of events recorded since tracing was started (including those overwritten)
+
+// Constructor
+private:
+    explicit Trace();
+// Destructor
+    ~Trace();
+
+// Copy Constructor / Assignment Operator
+    Trace(const Trace &);
+    const Trace &operator =(const Trace &);
+
+// Functions
+private:
+    static void AddEvent(const char *const name, const std::string &detail, const double &beginTime, const double &endTime);
+
+public:
+    // Starts recording events afresh
+    static void Start(const std::size_t &capacity = DefaultCapacity);
+    static void Stop();
+
+    static const bool IsStarted();
+
+    // Saves the events recorded as a JSON trace
+    static const bool Save(const std::string &fileName);
+};
+
+#endif
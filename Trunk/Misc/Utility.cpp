@@ -103,4 +103,16 @@ namespace Utility
 
     } // String
 
+    namespace ByteOrder
+    {
+        // Functions
+
+        const bool IsHostLittleEndian()
+        {
+            const unsigned int value = 1;
+            return *reinterpret_cast<const unsigned char *>( &value ) == 1;
+        }
+
+    } // ByteOrder
+
 } // Utility
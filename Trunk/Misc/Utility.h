@@ -21,6 +21,7 @@
 #include "CrcCalculator.h"
 #include <string>
 #include <sstream>
+#include <vector>
 #include <cctype>   // For std::toupper()
 
 namespace Utility
@@ -66,8 +67,72 @@ namespace Utility
             return (!(stream >> std::dec >> val).fail()) && stream.eof();
         }
 
+        // Reads a list of values separated by commas, such as "1,2,3"
+        template<class T>
+        const bool FromString(std::vector<T> &values, const std::string &str)
+        {
+            values.clear();
+
+            std::string::size_type begin = 0;
+            while( true )
+            {
+                const std::string::size_type end = str.find( ',', begin );
+
+                T val;
+                if( !FromString( val, str.substr( begin, (end == std::string::npos)? end: end - begin ) ) )
+                    return false;
+
+                values.push_back( val );
+
+                if( end == std::string::npos )
+                    return true;
+
+                begin = end + 1;
+            }
+        }
+
     } // String
 
+    // Values written in a fixed (little-endian) byte order, so that they can be read back on any machine
+    namespace ByteOrder
+    {
+        // Functions
+        const bool IsHostLittleEndian();
+
+        // Templates
+
+        // Appends the value to the buffer, least significant byte first
+        template<class T>
+        void Write(std::vector<unsigned char> &buffer, const T &val)
+        {
+            const unsigned char *const pBytes = reinterpret_cast<const unsigned char *>( &val );
+            if( IsHostLittleEndian() )
+                buffer.insert( buffer.end(), pBytes, pBytes + sizeof(T) );
+            else
+            {
+                for(std::size_t i = sizeof(T); i > 0; --i)
+                    buffer.push_back( pBytes[i - 1] );
+            }
+        }
+
+        // Reads a value written by Write() at the position, and moves past it.
+        // Returns false if the buffer doesn't hold the value.
+        template<class T>
+        const bool Read(const std::vector<unsigned char> &buffer, std::size_t &pos, T &val)
+        {
+            if( (pos > buffer.size()) || (buffer.size() - pos < sizeof(T)) )
+                return false;
+
+            unsigned char *const pBytes = reinterpret_cast<unsigned char *>( &val );
+            for(std::size_t i=0; i < sizeof(T); ++i)
+                pBytes[ IsHostLittleEndian()? i: sizeof(T) - 1 - i ] = buffer[pos + i];
+
+            pos += sizeof(T);
+            return true;
+        }
+
+    } // ByteOrder
+
 } // Utility
 
 #endif
@@ -19,14 +19,17 @@
 
 #include "Primitive.h"
 #include "Light.h"
+#include "Scene.h"
+#include "Ray.h"
 #include "Deserializer.h"
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
 
 // Constructor
 Primitive::Primitive() :
-    _material(),
-    _pLight( 0 )
+    _pMaterial( 0 ),
+    _pLight( 0 ),
+    _bMaterialReadInline( false )
 {
 }
 
@@ -35,8 +38,42 @@ Primitive::~Primitive()
 {
 }
 
+// Functions
+const Material &Primitive::GetMaterial() const
+{
+    return _pMaterial? *_pMaterial: Material::Default();
+}
+
+const int Primitive::IntersectsAny(
+    const Vector<float>         &origin,
+    const Vector<float> *const   pDirections,
+    const float         *const   pLengths,
+    const int                   &numRays,
+    bool                *const   pOccluded ) const
+{
+    // Test the rays one at a time; derived classes can do better by
+    // sharing the calculations which only depend on the origin.
+    int numOccluded = 0;
+    for(int i=0; i < numRays; ++i)
+    {
+        if( pOccluded[i] )
+            continue;
+
+        const Ray ray( origin, pDirections[i], Ray::RootGeneration() );
+
+        float intersectionDist;
+        if( Intersects( ray, intersectionDist ) && (intersectionDist < pLengths[i]) )
+        {
+            pOccluded[i] = true;
+            ++numOccluded;
+        }
+    }
+
+    return numOccluded;
+}
+
 // Serializable's functions
-const bool Primitive::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Primitive::Read(Deserializer &d, void *const pUserData)
 {
     DESERIALIZE_CLASS( object, d, Primitive )
     {
@@ -44,8 +81,28 @@ const bool Primitive::Read(Deserializer &d, void *const /*pUserData*/)
         if( !Serializable::Read( d, 0 ) )
             break;
 
-        if( !d.ReadObject( "material", _material, 0 )                           ||
-            !d.ReadObject( "light", _pLight, DefaultValue<const Light *>(0) )   )
+        // See if the Material is written out in full, rather than referred to
+        if( d.PeekGroupObject( "material" ) )
+        {
+            Scene *const pScene = static_cast<Scene *>( pUserData );
+            if( !pScene )
+            {
+                d.Log << "Error: A Material can only be written out within a Primitive which is in a Scene." << endl;
+                break;
+            }
+
+            // The Scene owns it, even if it fails to read
+            Material *const pMaterial = pScene->CreateMaterial();
+            _pMaterial = pMaterial;
+            _bMaterialReadInline = true;
+
+            if( !d.ReadObject( "material", *pMaterial, 0 ) )
+                break;
+        }
+        else if( !d.ReadObject( "material", _pMaterial, DefaultValue<const Material *>(0) ) )
+            break;
+
+        if( !d.ReadObject( "light", _pLight, DefaultValue<const Light *>(0) ) )
             break;
     }
 
@@ -60,8 +117,8 @@ const bool Primitive::Write(Serializer &s) const
         if( !Serializable::Write( s ) )
             break;
 
-        if( !s.WriteObject( "material", _material )                             ||
-            !s.WriteObject( "light", _pLight, DefaultValue<const Light *>(0) )  )
+        if( !s.WriteObject( "material", _pMaterial, DefaultValue<const Material *>(0) )  ||
+            !s.WriteObject( "light", _pLight, DefaultValue<const Light *>(0) )          )
             break;
     }
 
@@ -74,6 +131,9 @@ const bool Primitive::RestorePointers(AddressTranslator &t)
     if( !Serializable::RestorePointers( t ) )
         return false;
 
+    if( !_bMaterialReadInline && !t.TranslateAddress( _pMaterial ) )
+        return false;
+
     if( !t.TranslateAddress( _pLight ) )
         return false;
 
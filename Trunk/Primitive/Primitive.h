@@ -27,13 +27,17 @@
 // Forward Declarations
 class Ray;
 class Light;
+class Scene;
 
 class Primitive : public Serializable
 {
 // Members
 public:
-    Material        _material;
-    const Light    *_pLight;
+    const Material  *_pMaterial;    // Shared with other Primitives and owned by the Scene; 0 for the default Material
+    const Light     *_pLight;
+
+private:
+    bool             _bMaterialReadInline;  // The Material was written out within the Primitive, so _pMaterial needn't be restored
 
 protected:
 // Constructor
@@ -44,11 +48,28 @@ public:
 
 // Functions
 public:
+    const Material &GetMaterial() const;
+
     virtual const bool Intersects(const Ray &ray, IntersectionInfo &intersectionInfo) const = 0;
     virtual const bool Intersects(const Ray &ray, float &intersectionDist) const = 0;
     virtual const Vector<float> GetSurfaceNormal(const Vector<float> &position) const = 0;
 
+    // Moves the Primitive by the offset.
+    virtual void Translate(const Vector<float> &offset) = 0;
+
+    // Tests a set of rays, which share a common origin, for an intersection closer than their lengths.
+    // The rays which intersect are marked as occluded; rays which are already marked are skipped.
+    // Returns the no. of rays which were newly marked.
+    virtual const int IntersectsAny(
+        const Vector<float>         &origin,
+        const Vector<float> *const   pDirections,
+        const float         *const   pLengths,
+        const int                   &numRays,
+        bool                *const   pOccluded ) const;
+
     // Serializable's functions
+    // Note: A Material written out in full within the Primitive (as scene files used to have them)
+    //       is given to the Scene, which must be passed in as the pUserData.
     virtual const bool Read(Deserializer &d, void *const pUserData);
     virtual const bool Write(Serializer &s) const;
     virtual const bool RestorePointers(AddressTranslator &t);
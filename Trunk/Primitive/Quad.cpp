@@ -78,11 +78,59 @@ const bool Quad::Intersects(const Ray &ray, float &intersectionDist) const
     return bIntersects;
 }
 
+const int Quad::IntersectsAny(
+    const Vector<float>         &origin,
+    const Vector<float> *const   pDirections,
+    const float         *const   pLengths,
+    const int                   &numRays,
+    bool                *const   pOccluded ) const
+{
+    // This only depends on the origin
+    const float originToPlane = -(origin - _topLeft).Dot( _surfaceNormal );
+
+    int numOccluded = 0;
+    for(int i=0; i < numRays; ++i)
+    {
+        if( pOccluded[i] )
+            continue;
+
+        const Vector<float> &direction = pDirections[i];
+
+        const float d = direction.Dot( _surfaceNormal );
+        if( Maths::IsApproxEqual( d, 0 ) )
+            continue;
+
+        const float intersectionDist = originToPlane / d;
+        if( (intersectionDist < 0.01f) || (intersectionDist >= pLengths[i]) )
+            continue;
+
+        const Vector<float> point = origin + direction * intersectionDist;
+
+        const float tU = (point - _topLeft).Dot( _horizontalNormal );
+        if( tU < 0 || tU > _width )
+            continue;
+
+        const float tV = (point - _topLeft).Dot( _verticalNormal );
+        if( tV < 0 || tV > _height )
+            continue;
+
+        pOccluded[i] = true;
+        ++numOccluded;
+    }
+
+    return numOccluded;
+}
+
 const Vector<float> Quad::GetSurfaceNormal(const Vector<float> &/*position*/) const
 {
     return _surfaceNormal;
 }
 
+void Quad::Translate(const Vector<float> &offset)
+{
+    SetVertices( _topLeft + offset, _v2 + offset, _v3 + offset );
+}
+
 void Quad::SetVertices(const Vector<float> &v1, const Vector<float> &v2, const Vector<float> &v3)
 {
     _topLeft = v1;
@@ -103,12 +151,12 @@ void Quad::SetVertices(const Vector<float> &v1, const Vector<float> &v2, const V
 }
 
 // Serializable's functions
-const bool Quad::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Quad::Read(Deserializer &d, void *const pUserData)
 {
     DESERIALIZE_CLASS( object, d, Quad )
     {
         // Read the base
-        if( !Primitive::Read( d, 0 ) )
+        if( !Primitive::Read( d, pUserData ) )
             break;
 
         Vector<float> vertex1, vertex2, vertex3;
@@ -51,6 +51,13 @@ public:
     virtual const bool Intersects(const Ray &ray, IntersectionInfo &intersectionInfo) const;
     virtual const bool Intersects(const Ray &ray, float &intersectionDist) const;
     virtual const Vector<float> GetSurfaceNormal(const Vector<float> &position) const;
+    virtual void Translate(const Vector<float> &offset);
+    virtual const int IntersectsAny(
+        const Vector<float>         &origin,
+        const Vector<float> *const   pDirections,
+        const float         *const   pLengths,
+        const int                   &numRays,
+        bool                *const   pOccluded ) const;
 
     void SetVertices(const Vector<float> &v1, const Vector<float> &v2, const Vector<float> &v3);
 
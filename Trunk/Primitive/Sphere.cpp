@@ -120,18 +120,67 @@ const bool Sphere::Intersects(const Ray &ray, float &intersectionDist) const
     return bIntersects;
 }
 
+const int Sphere::IntersectsAny(
+    const Vector<float>         &origin,
+    const Vector<float> *const   pDirections,
+    const float         *const   pLengths,
+    const int                   &numRays,
+    bool                *const   pOccluded ) const
+{
+    // These only depend on the origin
+    const Vector<float> rayToCentre = _centre - origin;
+    const float rayToCentreMagnitude2 = rayToCentre.Magnitude2();
+    const float radius2 = _radius*_radius;
+
+    int numOccluded = 0;
+    for(int i=0; i < numRays; ++i)
+    {
+        if( pOccluded[i] )
+            continue;
+
+        const float v = rayToCentre.Dot( pDirections[i] );
+        const float d2 = radius2 - (rayToCentreMagnitude2 - v*v);
+        if( d2 < 0 )
+            continue;
+
+        const float d = sqrt( d2 );
+
+        // The closest intersection in front of the origin (as in Intersects())
+        float intersectionDist = v - d;
+        if( intersectionDist <= 0.01f )
+        {
+            intersectionDist = v + d;
+            if( intersectionDist <= 0.01f )
+                continue;
+        }
+
+        if( intersectionDist < pLengths[i] )
+        {
+            pOccluded[i] = true;
+            ++numOccluded;
+        }
+    }
+
+    return numOccluded;
+}
+
 const Vector<float> Sphere::GetSurfaceNormal(const Vector<float> &position) const
 {
     return (position - _centre) * _oneOverRadius;
 }
 
+void Sphere::Translate(const Vector<float> &offset)
+{
+    SetCentre( _centre + offset );
+}
+
 // Serializable's functions
-const bool Sphere::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Sphere::Read(Deserializer &d, void *const pUserData)
 {
     DESERIALIZE_CLASS( object, d, Sphere )
     {
         // Read the base
-        if( !Primitive::Read( d, 0 ) )
+        if( !Primitive::Read( d, pUserData ) )
             break;
 
         Vector<float> centre;
@@ -53,6 +53,13 @@ public:
     virtual const bool Intersects(const Ray &ray, IntersectionInfo &intersectionInfo) const;
     virtual const bool Intersects(const Ray &ray, float &intersectionDist) const;
     virtual const Vector<float> GetSurfaceNormal(const Vector<float> &position) const;
+    virtual void Translate(const Vector<float> &offset);
+    virtual const int IntersectsAny(
+        const Vector<float>         &origin,
+        const Vector<float> *const   pDirections,
+        const float         *const   pLengths,
+        const int                   &numRays,
+        bool                *const   pOccluded ) const;
 
     // Serializable's functions
     virtual const bool Read(Deserializer &d, void *const pUserData);
@@ -75,11 +75,56 @@ const bool Triangle::Intersects(const Ray &ray, float &intersectionDist) const
     return bIntersects;
 }
 
+const int Triangle::IntersectsAny(
+    const Vector<float>         &origin,
+    const Vector<float> *const   pDirections,
+    const float         *const   pLengths,
+    const int                   &numRays,
+    bool                *const   pOccluded ) const
+{
+    // This only depends on the origin
+    const float originToPlane = -(origin - _v2).Dot( _surfaceNormal );
+
+    int numOccluded = 0;
+    for(int i=0; i < numRays; ++i)
+    {
+        if( pOccluded[i] )
+            continue;
+
+        const Vector<float> &direction = pDirections[i];
+
+        const float d = direction.Dot( _surfaceNormal );
+        if( Maths::IsApproxEqual( d, 0 ) )
+            continue;
+
+        const float intersectionDist = originToPlane / d;
+        if( (intersectionDist < 0.01f) || (intersectionDist >= pLengths[i]) )
+            continue;
+
+        const Vector<float> point = origin + direction * intersectionDist;
+
+        if( (point - _v1).Dot( _edge1Normal ) > 0   ||
+            (point - _v2).Dot( _edge2Normal ) > 0   ||
+            (point - _v3).Dot( _edge3Normal ) > 0   )
+            continue;
+
+        pOccluded[i] = true;
+        ++numOccluded;
+    }
+
+    return numOccluded;
+}
+
 const Vector<float> Triangle::GetSurfaceNormal(const Vector<float> &/*position*/) const
 {
     return _surfaceNormal;
 }
 
+void Triangle::Translate(const Vector<float> &offset)
+{
+    SetVertices( _v1 + offset, _v2 + offset, _v3 + offset );
+}
+
 void Triangle::SetVertices(const Vector<float> &v1, const Vector<float> &v2, const Vector<float> &v3)
 {
     _v1 = v1;
@@ -100,12 +145,12 @@ void Triangle::SetVertices(const Vector<float> &v1, const Vector<float> &v2, con
 }
 
 // Serializable's functions
-const bool Triangle::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Triangle::Read(Deserializer &d, void *const pUserData)
 {
     DESERIALIZE_CLASS( object, d, Triangle )
     {
         // Read the base
-        if( !Primitive::Read( d, 0 ) )
+        if( !Primitive::Read( d, pUserData ) )
             break;
 
         Vector<float> vertex1, vertex2, vertex3;
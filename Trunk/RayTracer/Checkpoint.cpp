@@ -0,0 +1,223 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Checkpoint.h"
+#include "Film.h"
+#include <iostream>
+#include <string.h>
+
+namespace
+{
+    const char          Signature[4]    = { 'R', 'W', 'C', 'P' };
+    const unsigned int  Version         = 1;
+
+    template <class T>
+    const bool Write(FILE *const pFile, const T &val)
+    {
+        return (fwrite( &val, sizeof(T), 1, pFile ) == 1);
+    }
+
+    template <class T>
+    const bool Read(FILE *const pFile, T &val)
+    {
+        return (fread( &val, sizeof(T), 1, pFile ) == 1);
+    }
+}
+
+// Constructor
+Checkpoint::Checkpoint() :
+    _fileName(),
+    _pFile( 0 )
+{
+}
+
+// Destructor
+Checkpoint::~Checkpoint()
+{
+    Close();
+}
+
+// Functions
+const bool Checkpoint::WriteHeader(const unsigned int &crc)
+{
+    return
+        (fwrite( Signature, sizeof(Signature), 1, _pFile ) == 1) &&
+        Write( _pFile, Version ) &&
+        Write( _pFile, crc );
+}
+
+const long Checkpoint::ReadRecords(Film &film, int &pass, IntArray &passPixels, BoolArray &finishedTiles)
+{
+    long validSize = ftell( _pFile );
+
+    int recordType;
+    while( Read( _pFile, recordType ) )
+    {
+        if( recordType == Record_Pass )
+        {
+            int newPass, numPixels;
+            if( !Read( _pFile, newPass ) || !Read( _pFile, numPixels ) || (newPass <= pass) || (numPixels < 0) )
+                break;
+
+            IntArray pixels( numPixels );
+            if( (numPixels > 0) && (fread( &pixels[0], sizeof(int), numPixels, _pFile ) != (std::size_t)numPixels) )
+                break;
+
+            pass = newPass;
+            passPixels.swap( pixels );
+            finishedTiles.assign( finishedTiles.size(), false );
+        }
+        else if( recordType == Record_Tile )
+        {
+            int tilePass, tile, regionSize;
+            if( !Read( _pFile, tilePass ) || !Read( _pFile, tile ) || !Read( _pFile, regionSize ) ||
+                (tilePass != pass) || (tile < 0) || (tile >= (int)finishedTiles.size()) || (regionSize < 0) )
+                break;
+
+            Film::Buffer region( regionSize );
+            if( (regionSize > 0) && (fread( &region[0], 1, regionSize, _pFile ) != (std::size_t)regionSize) )
+                break;
+
+            if( !film.AddRegion( region ) )
+                break;
+
+            finishedTiles[tile] = true;
+        }
+        else
+            break;
+
+        validSize = ftell( _pFile );
+    }
+
+    return validSize;
+}
+
+const bool Checkpoint::Open(const std::string &fileName, const CrcCalculator::CrcType &crc, const bool &bResume,
+    Film &film, int &pass, IntArray &passPixels, BoolArray &finishedTiles)
+{
+    Close();
+
+    _fileName = fileName;
+    pass = 0;
+    passPixels.clear();
+    finishedTiles.assign( finishedTiles.size(), false );
+
+    // Only the lower 32 bits of the CRC are significant
+    const unsigned int fileCrc = (unsigned int)(crc & 0xFFFFFFFF);
+
+    if( bResume && ((_pFile = fopen( fileName.c_str(), "rb" )) != 0) )
+    {
+        char signature[4];
+        unsigned int version, crcRead;
+        if( (fread( signature, sizeof(signature), 1, _pFile ) != 1) || !Read( _pFile, version ) || !Read( _pFile, crcRead ) ||
+            (memcmp( signature, Signature, sizeof(Signature) ) != 0) || (version != Version) || (crcRead != fileCrc) )
+        {
+            std::cout << "Error: The checkpoint file doesn't belong to this scene, camera and these render settings: " << fileName << std::endl;
+            Close();
+            return false;
+        }
+
+        const long validSize = ReadRecords( film, pass, passPixels, finishedTiles );
+
+        // If the render was interrupted while writing a record, then drop what was written of it
+        fseek( _pFile, 0, SEEK_END );
+        if( ftell( _pFile ) != validSize )
+        {
+            std::vector<char> contents( validSize );
+            fseek( _pFile, 0, SEEK_SET );
+            const bool bRead = (fread( &contents[0], 1, validSize, _pFile ) == (std::size_t)validSize);
+            fclose( _pFile );
+
+            _pFile = bRead? fopen( fileName.c_str(), "wb" ): 0;
+            if( !_pFile || (fwrite( &contents[0], 1, validSize, _pFile ) != (std::size_t)validSize) )
+            {
+                std::cout << "Error: Failed to repair the checkpoint file: " << fileName << std::endl;
+                Close();
+                return false;
+            }
+
+            fclose( _pFile );
+        }
+        else
+            fclose( _pFile );
+
+        // Continue appending to it
+        _pFile = fopen( fileName.c_str(), "ab" );
+    }
+    else
+    {
+        _pFile = fopen( fileName.c_str(), "wb" );
+        if( _pFile && !WriteHeader( fileCrc ) )
+            Close();
+    }
+
+    if( !_pFile )
+    {
+        std::cout << "Error: Failed to open the checkpoint file for writing: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const bool Checkpoint::BeginPass(const int &pass, const IntArray &passPixels)
+{
+    if( !_pFile )
+        return false;
+
+    const int numPixels = (int)passPixels.size();
+
+    return
+        Write( _pFile, (int)Record_Pass ) &&
+        Write( _pFile, pass ) &&
+        Write( _pFile, numPixels ) &&
+        ((numPixels == 0) || (fwrite( &passPixels[0], sizeof(int), numPixels, _pFile ) == (std::size_t)numPixels));
+}
+
+const bool Checkpoint::AddTile(const int &pass, const int &tile, const Film &film)
+{
+    if( !_pFile )
+        return false;
+
+    Film::Buffer region;
+    film.WriteCapture( region );
+
+    return
+        Write( _pFile, (int)Record_Tile ) &&
+        Write( _pFile, pass ) &&
+        Write( _pFile, tile ) &&
+        Write( _pFile, (int)region.size() ) &&
+        (fwrite( &region[0], 1, region.size(), _pFile ) == region.size());
+}
+
+void Checkpoint::Flush()
+{
+    if( _pFile )
+        fflush( _pFile );
+}
+
+void Checkpoint::Close()
+{
+    if( _pFile )
+    {
+        fclose( _pFile );
+        _pFile = 0;
+    }
+}
@@ -0,0 +1,95 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef CHECKPOINT_HEADER
+#define CHECKPOINT_HEADER
+
+#include "CrcCalculator.h"
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+// Forward Declarations
+class Film;
+
+// Records the progress of a render in a file, so that it can be resumed if it's interrupted.
+// The file starts with a header holding a CRC of everything which affects the rendered image,
+// followed by a record for every tile completed, holding the tile's contributions to the Film.
+// Records are only ever appended, so writing a checkpoint costs no more than the tiles completed
+// since the last one. A render goes through passes (the first one sampling every pixel, and the
+// rest refining some of them); each pass after the first starts with a record of its pixels.
+class Checkpoint
+{
+// Types
+public:
+    typedef std::vector<int>    IntArray;
+    typedef std::vector<bool>   BoolArray;
+
+private:
+    enum RecordType
+    {
+        Record_Pass = 1,
+        Record_Tile = 2
+    };
+
+// Members
+private:
+    std::string _fileName;
+    FILE       *_pFile;
+
+public:
+// Constructor
+    explicit Checkpoint();
+// Destructor
+    ~Checkpoint();
+
+private:
+// Copy Constructor / Assignment Operator
+    Checkpoint(const Checkpoint &);
+    const Checkpoint &operator =(const Checkpoint &);
+
+// Functions
+private:
+    const bool WriteHeader(const unsigned int &crc);
+
+    // Reads the records of the file into the film, and gets the progress of the render from them.
+    // Returns the no. of bytes of the file which hold complete records.
+    const long ReadRecords(Film &film, int &pass, IntArray &passPixels, BoolArray &finishedTiles);
+
+public:
+    // Opens the checkpoint file for the render. If resuming, the records of an existing file are read into
+    // the film, and the pass being rendered, its pixels (for passes after the first) and its finished tiles
+    // are returned; otherwise (or if there's no file to resume from) a new file is started.
+    // Returns false if the file can't be written, or doesn't belong to this render (going by the CRC).
+    const bool Open(const std::string &fileName, const CrcCalculator::CrcType &crc, const bool &bResume,
+        Film &film, int &pass, IntArray &passPixels, BoolArray &finishedTiles);
+
+    const bool BeginPass(const int &pass, const IntArray &passPixels);
+
+    // Records the region of the film captured while rendering the tile.
+    const bool AddTile(const int &pass, const int &tile, const Film &film);
+
+    // Makes sure everything recorded so far is on disk.
+    void Flush();
+
+    void Close();
+};
+
+#endif
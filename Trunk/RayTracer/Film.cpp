@@ -0,0 +1,376 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "Film.h"
+#include "Image.h"
+#include "Maths.h"
+#include "Utility.h"
+
+namespace
+{
+    // Sizes of a region's header (its x, y, width and height) and of each of its pixels, as written by WriteCapture()
+    const std::size_t RegionHeaderSize  = 4 * sizeof(int);
+    const std::size_t PixelSamplesSize  = 6 * sizeof(float) + sizeof(int);
+
+    const float GetLuminance(const Color &color)
+    {
+        return 0.2126f * color.x + 0.7152f * color.y + 0.0722f * color.z;
+    }
+}
+
+// PixelSamples' Constructor
+Film::PixelSamples::PixelSamples() :
+    _weightedSum( 0 ),
+    _weight( 0 ),
+    _numSamples( 0 ),
+    _luminanceSum( 0 ),
+    _luminanceSquaredSum( 0 )
+{
+}
+
+// Constructor
+Film::Film() :
+    _width( 0 ),
+    _height( 0 ),
+    _windowX( 0 ),
+    _windowY( 0 ),
+    _windowWidth( 0 ),
+    _windowHeight( 0 ),
+    _filter( RenderSettings::Filter_Box ),
+    _filterRadius( 0.5f ),
+    _pixels(),
+    _bCapturing( false ),
+    _captureX( 0 ),
+    _captureY( 0 ),
+    _captureWidth( 0 ),
+    _captureHeight( 0 ),
+    _capture(),
+    _memory( MemoryAccount::Subsystem_Film )
+{
+}
+
+// Destructor
+Film::~Film()
+{
+}
+
+// Functions
+const float Film::FilterWeight(const float &offset) const
+{
+    const float distance = Maths::Abs( offset );
+    if( distance >= _filterRadius )
+        return 0;
+
+    switch( _filter )
+    {
+    case RenderSettings::Filter_Tent:
+        return 1 - distance / _filterRadius;
+
+    case RenderSettings::Filter_Gaussian:
+        // Shifted down so that it falls to 0 at the filter's radius
+        return exp( -2 * distance * distance ) - exp( -2 * _filterRadius * _filterRadius );
+
+    default:
+        return 1;
+    }
+}
+
+const float Film::PixelMean(const int &x, const int &y) const
+{
+    const PixelSamples &pixel = _pixels[ y * _width + x ];
+    return (pixel._numSamples > 0)? pixel._luminanceSum / pixel._numSamples: 0;
+}
+
+Film::PixelSamples *const Film::CapturedPixel(const int &x, const int &y)
+{
+    if( !_bCapturing ||
+        (x < _captureX) || (x >= _captureX + _captureWidth) ||
+        (y < _captureY) || (y >= _captureY + _captureHeight) )
+        return 0;
+
+    return &_capture[ (y - _captureY) * _captureWidth + (x - _captureX) ];
+}
+
+void Film::AddStatistics(const int &x, const int &y, const float &luminance)
+{
+    // The pixel of the film, and its copy in the captured region (if any)
+    PixelSamples *const pPixels[2] = { &_pixels[ y * _width + x ], CapturedPixel( x, y ) };
+    for(int i=0; (i < 2) && pPixels[i]; ++i)
+    {
+        PixelSamples *const pPixel = pPixels[i];
+        ++pPixel->_numSamples;
+        pPixel->_luminanceSum           += luminance;
+        pPixel->_luminanceSquaredSum    += luminance * luminance;
+    }
+}
+
+void Film::AddWeightedColor(const int &x, const int &y, const Color &color, const float &weight)
+{
+    // The pixel of the film, and its copy in the captured region (if any)
+    PixelSamples *const pPixels[2] = { &_pixels[ y * _width + x ], CapturedPixel( x, y ) };
+    for(int i=0; (i < 2) && pPixels[i]; ++i)
+    {
+        PixelSamples *const pPixel = pPixels[i];
+        pPixel->_weightedSum    += color * weight;
+        pPixel->_weight         += weight;
+    }
+}
+
+void Film::UpdateMemory()
+{
+    _memory.SetSize( (_pixels.capacity() + _capture.capacity()) * sizeof(PixelSamples) );
+}
+
+const bool Film::Create(const int &width, const int &height, const RenderSettings::Filter &filter)
+{
+    if( (width < 1) || (height < 1) )
+        return false;
+
+    _width  = width;
+    _height = height;
+    _filter = filter;
+
+    _windowX        = 0;
+    _windowY        = 0;
+    _windowWidth    = width;
+    _windowHeight   = height;
+
+    switch( _filter )
+    {
+    case RenderSettings::Filter_Tent:       _filterRadius = 1.0f;   break;
+    case RenderSettings::Filter_Gaussian:   _filterRadius = 1.5f;   break;
+    default:                                _filterRadius = 0.5f;   break;
+    }
+
+    _pixels.assign( width * height, PixelSamples() );
+    _bCapturing = false;
+    UpdateMemory();
+    return true;
+}
+
+const bool Film::SetWindow(const int &x, const int &y, const int &width, const int &height)
+{
+    if( (x < 0) || (y < 0) || (width < 1) || (height < 1) || (x + width > _width) || (y + height > _height) )
+        return false;
+
+    _windowX        = x;
+    _windowY        = y;
+    _windowWidth    = width;
+    _windowHeight   = height;
+    return true;
+}
+
+void Film::AddSample(const int &x, const int &y, const float &offsetX, const float &offsetY, const Color &color)
+{
+    // Statistics of the pixel the sample was taken for
+    AddStatistics( x, y, GetLuminance( color ) );
+
+    // The box filter doesn't reach beyond the pixel, so there's nothing to weigh
+    if( _filter == RenderSettings::Filter_Box )
+    {
+        AddWeightedColor( x, y, color, 1 );
+        return;
+    }
+
+    // Splat the sample onto all the pixels within the filter's radius
+    const int radius = (int)ceil( _filterRadius );
+    for(int j = Maths::Max( 0, y - radius ); j <= Maths::Min( _height - 1, y + radius ); ++j)
+    {
+        const float weightY = FilterWeight( (j - y) - offsetY );
+        if( weightY <= 0 )
+            continue;
+
+        for(int i = Maths::Max( 0, x - radius ); i <= Maths::Min( _width - 1, x + radius ); ++i)
+        {
+            const float weight = weightY * FilterWeight( (i - x) - offsetX );
+            if( weight > 0 )
+                AddWeightedColor( i, j, color, weight );
+        }
+    }
+}
+
+const int &Film::NumSamples(const int &x, const int &y) const
+{
+    return _pixels[ y * _width + x ]._numSamples;
+}
+
+void Film::BeginCapture(const int &x, const int &y, const int &width, const int &height)
+{
+    // The box filter doesn't reach beyond the pixel
+    const int radius = (_filter == RenderSettings::Filter_Box)? 0: (int)ceil( _filterRadius );
+
+    _captureX       = Maths::Max( 0, x - radius );
+    _captureY       = Maths::Max( 0, y - radius );
+    _captureWidth   = Maths::Min( _width,  x + width  + radius ) - _captureX;
+    _captureHeight  = Maths::Min( _height, y + height + radius ) - _captureY;
+
+    _capture.assign( _captureWidth * _captureHeight, PixelSamples() );
+    _bCapturing = true;
+    UpdateMemory();
+}
+
+void Film::EndCapture()
+{
+    _bCapturing = false;
+}
+
+void Film::WriteCapture(Buffer &buffer) const
+{
+    // Field by field, in a fixed byte order, so that the region can be read back on another machine
+    buffer.reserve( buffer.size() + RegionHeaderSize + _capture.size() * PixelSamplesSize );
+
+    Utility::ByteOrder::Write( buffer, _captureX );
+    Utility::ByteOrder::Write( buffer, _captureY );
+    Utility::ByteOrder::Write( buffer, _captureWidth );
+    Utility::ByteOrder::Write( buffer, _captureHeight );
+
+    for(std::size_t i=0; i < _capture.size(); ++i)
+    {
+        const PixelSamples &pixel = _capture[i];
+
+        Utility::ByteOrder::Write( buffer, pixel._weightedSum.x );
+        Utility::ByteOrder::Write( buffer, pixel._weightedSum.y );
+        Utility::ByteOrder::Write( buffer, pixel._weightedSum.z );
+        Utility::ByteOrder::Write( buffer, pixel._weight );
+        Utility::ByteOrder::Write( buffer, pixel._numSamples );
+        Utility::ByteOrder::Write( buffer, pixel._luminanceSum );
+        Utility::ByteOrder::Write( buffer, pixel._luminanceSquaredSum );
+    }
+}
+
+const bool Film::AddRegion(const Buffer &buffer)
+{
+    std::size_t pos = 0;
+    int x, y, width, height;
+    if( !Utility::ByteOrder::Read( buffer, pos, x )     ||
+        !Utility::ByteOrder::Read( buffer, pos, y )     ||
+        !Utility::ByteOrder::Read( buffer, pos, width ) ||
+        !Utility::ByteOrder::Read( buffer, pos, height ) )
+        return false;
+
+    if( (x < 0) || (y < 0) || (width < 0) || (height < 0) || (x + width > _width) || (y + height > _height) ||
+        (buffer.size() != RegionHeaderSize + width * height * PixelSamplesSize) )
+        return false;
+
+    for(int j=0; j < height; ++j)
+    {
+        for(int i=0; i < width; ++i)
+        {
+            // The size of the buffer has been checked, so these can't fail
+            PixelSamples source;
+            Utility::ByteOrder::Read( buffer, pos, source._weightedSum.x );
+            Utility::ByteOrder::Read( buffer, pos, source._weightedSum.y );
+            Utility::ByteOrder::Read( buffer, pos, source._weightedSum.z );
+            Utility::ByteOrder::Read( buffer, pos, source._weight );
+            Utility::ByteOrder::Read( buffer, pos, source._numSamples );
+            Utility::ByteOrder::Read( buffer, pos, source._luminanceSum );
+            Utility::ByteOrder::Read( buffer, pos, source._luminanceSquaredSum );
+
+            PixelSamples &pixel = _pixels[ (y + j) * _width + (x + i) ];
+
+            pixel._weightedSum          += source._weightedSum;
+            pixel._weight               += source._weight;
+            pixel._numSamples           += source._numSamples;
+            pixel._luminanceSum         += source._luminanceSum;
+            pixel._luminanceSquaredSum  += source._luminanceSquaredSum;
+        }
+    }
+
+    return true;
+}
+
+const int &Film::Width() const
+{
+    return _width;
+}
+
+const int &Film::Height() const
+{
+    return _height;
+}
+
+const bool Film::NeedsRefinement(const int &x, const int &y, const float &threshold) const
+{
+    return NeedsRefinement( x, y, threshold, 0, 0, _width, _height );
+}
+
+const bool Film::NeedsRefinement(const int &x, const int &y, const float &threshold,
+    const int &regionX, const int &regionY, const int &regionWidth, const int &regionHeight) const
+{
+    // Contrast of the neighbourhood
+    float minLuminance = PixelMean( x, y );
+    float maxLuminance = minLuminance;
+    for(int j = Maths::Max( regionY, y - 1 ); j <= Maths::Min( regionY + regionHeight - 1, y + 1 ); ++j)
+    {
+        for(int i = Maths::Max( regionX, x - 1 ); i <= Maths::Min( regionX + regionWidth - 1, x + 1 ); ++i)
+        {
+            const float luminance = PixelMean( i, j );
+            minLuminance = Maths::Min( minLuminance, luminance );
+            maxLuminance = Maths::Max( maxLuminance, luminance );
+        }
+    }
+
+    if( (maxLuminance > 0) && ((maxLuminance - minLuminance) / (maxLuminance + minLuminance) > threshold) )
+        return true;
+
+    // Relative standard error of the pixel's samples
+    const PixelSamples &pixel = _pixels[ y * _width + x ];
+    if( pixel._numSamples < 2 )
+        return false;
+
+    const float mean = pixel._luminanceSum / pixel._numSamples;
+    if( mean <= 0 )
+        return false;
+
+    const float variance = Maths::Max( 0.0f, pixel._luminanceSquaredSum / pixel._numSamples - mean * mean ) * pixel._numSamples / (pixel._numSamples - 1);
+    return (sqrt( variance / pixel._numSamples ) / mean > threshold);
+}
+
+const bool Film::Resolve(Image &image) const
+{
+    if( (image.Width() != _width) || (image.Height() != _height) )
+        return false;
+
+    for(int y=0; y < _height; ++y)
+    {
+        for(int x=0; x < _width; ++x)
+        {
+            // Pixels without any samples yet (while rendering progressively) take
+            // the color of the pixel at the corner of the smallest block sampled.
+            const PixelSamples *pPixel = &_pixels[ y * _width + x ];
+            const bool bInWindow =
+                (x >= _windowX) && (x < _windowX + _windowWidth) &&
+                (y >= _windowY) && (y < _windowY + _windowHeight);
+
+            for(int blockSize = 2; bInWindow && (pPixel->_weight <= 0) && (blockSize <= CoarsestBlockSize); blockSize *= 2)
+                pPixel = &_pixels[ (y - y % blockSize) * _width + (x - x % blockSize) ];
+
+            const PixelSamples &pixel = *pPixel;
+
+            Color color( 0 );
+            if( bInWindow && (pixel._weight > 0) )
+                color = pixel._weightedSum * (1 / pixel._weight);
+
+            image.SetPixel(x, y, Pixel<float>(color.x, color.y, color.z, 1));
+        }
+    }
+
+    return true;
+}
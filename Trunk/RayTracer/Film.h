@@ -0,0 +1,148 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef FILM_HEADER
+#define FILM_HEADER
+
+#include "Color.h"
+#include "RenderSettings.h"
+#include "MemoryAccount.h"
+#include <vector>
+
+// Forward Declarations
+class Image;
+
+// Accumulates the samples of an image, and reconstructs the image from them through a filter.
+// Samples are positioned relative to the pixel they were taken for, in pixels; pixel (x, y)
+// covers the offsets -0.5 to 0.5 around its sample point (which the camera rays pass through
+// when a pixel is sampled only once).
+class Film
+{
+// Types
+public:
+    typedef std::vector<unsigned char>  Buffer;
+
+    enum
+    {
+        CoarsestBlockSize = 8   // Largest block of pixels filled in from the sample at its corner (see Resolve())
+    };
+
+private:
+    struct PixelSamples
+    {
+        Color   _weightedSum;           // Sum of the filtered samples which fall on this pixel
+        float   _weight;                // Sum of their filter weights
+        int     _numSamples;            // No. of samples taken for this pixel
+        float   _luminanceSum;          // For the variance of the samples taken for this pixel
+        float   _luminanceSquaredSum;
+
+        explicit PixelSamples();
+    };
+
+    typedef std::vector<PixelSamples>   PixelSamplesArray;
+
+// Members
+private:
+    int                     _width;
+    int                     _height;
+    int                     _windowX;       // The window being rendered; pixels outside it are resolved as black
+    int                     _windowY;
+    int                     _windowWidth;
+    int                     _windowHeight;
+    RenderSettings::Filter  _filter;
+    float                   _filterRadius;
+    PixelSamplesArray       _pixels;
+
+    // While capturing, the contributions of the samples to a region of the film are also accumulated separately
+    bool                    _bCapturing;
+    int                     _captureX;
+    int                     _captureY;
+    int                     _captureWidth;
+    int                     _captureHeight;
+    PixelSamplesArray       _capture;
+
+    MemoryAccount::Allocation _memory;  // Of the pixels and the captured region
+
+public:
+// Constructor
+    explicit Film();
+// Destructor
+    ~Film();
+
+private:
+// Copy Constructor / Assignment Operator
+    Film(const Film &);
+    const Film &operator =(const Film &);
+
+// Functions
+private:
+    const float FilterWeight(const float &offset) const;
+    const float PixelMean(const int &x, const int &y) const;
+
+    // Returns the pixel of the captured region, or 0 if the pixel isn't being captured.
+    PixelSamples *const CapturedPixel(const int &x, const int &y);
+
+    void AddStatistics(const int &x, const int &y, const float &luminance);
+    void AddWeightedColor(const int &x, const int &y, const Color &color, const float &weight);
+
+    void UpdateMemory();
+
+public:
+    // Discards all the samples, and sets up the film for an image of the specified dimensions.
+    // The window being rendered is the whole image.
+    const bool Create(const int &width, const int &height, const RenderSettings::Filter &filter);
+
+    // Restricts the window being rendered to part of the image.
+    const bool SetWindow(const int &x, const int &y, const int &width, const int &height);
+
+    // Adds a sample taken for pixel (x, y), at the specified offset from its sample point.
+    void AddSample(const int &x, const int &y, const float &offsetX, const float &offsetY, const Color &color);
+
+    const int &NumSamples(const int &x, const int &y) const;
+
+    // Starts capturing the contributions of the samples to the region (grown by the filter's radius
+    // to include the pixels the samples in it can reach), until EndCapture().
+    void BeginCapture(const int &x, const int &y, const int &width, const int &height);
+    void EndCapture();
+
+    // Appends the captured region to the buffer.
+    void WriteCapture(Buffer &buffer) const;
+
+    // Adds a region written by WriteCapture() to the film.
+    // Returns false if the buffer doesn't hold a valid region.
+    const bool AddRegion(const Buffer &buffer);
+
+    const int &Width() const;
+    const int &Height() const;
+
+    // Returns true if the contrast of the pixel's neighbourhood, or the standard error
+    // of the pixel's samples (relative to their mean) exceeds the threshold.
+    // The second version only takes the neighbours within the region into account.
+    const bool NeedsRefinement(const int &x, const int &y, const float &threshold) const;
+    const bool NeedsRefinement(const int &x, const int &y, const float &threshold,
+        const int &regionX, const int &regionY, const int &regionWidth, const int &regionHeight) const;
+
+    // Writes the reconstructed pixels to the image, which must be of the film's dimensions.
+    // Pixels (within the window) without any samples take the color of the pixel at the
+    // corner of their block, for blocks of up to CoarsestBlockSize pixels aligned to the image.
+    const bool Resolve(Image &image) const;
+};
+
+#endif
@@ -0,0 +1,168 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Heatmap.h"
+#include "Image.h"
+#include "Timer.h"
+#include "Statistics.h"
+#include "Maths.h"
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+    // The no. of pixels (in every 100) drawn below the top of the colour scale; a handful of
+    // extremely expensive pixels would otherwise leave everything else looking cheap.
+    const float ColorScalePercentile = 99;
+
+    // Maps 0..1 to blue, cyan, green, yellow and red
+    const Pixel<float> GetFalseColor(const float &t)
+    {
+        return Pixel<float>(
+            Maths::Bound<float>( 1.5f - Maths::Abs( 4 * t - 3 ), 0, 1 ),
+            Maths::Bound<float>( 1.5f - Maths::Abs( 4 * t - 2 ), 0, 1 ),
+            Maths::Bound<float>( 1.5f - Maths::Abs( 4 * t - 1 ), 0, 1 ),
+            1 );
+    }
+
+    const char *const GetCostUnit(const RenderSettings::Cost &cost)
+    {
+        switch( cost )
+        {
+        case RenderSettings::Cost_Time:             return "seconds";
+        case RenderSettings::Cost_Rays:             return "rays";
+        case RenderSettings::Cost_PrimitiveTests:   return "primitive tests";
+        default:                                    return "";
+        }
+    }
+}
+
+// Constructor
+Heatmap::Heatmap() :
+    _cost( RenderSettings::Cost_None ),
+    _width( 0 ),
+    _height( 0 ),
+    _costs(),
+    _startReading( 0 )
+{
+}
+
+// Destructor
+Heatmap::~Heatmap()
+{
+}
+
+// Functions
+const double Heatmap::GetReading() const
+{
+    switch( _cost )
+    {
+    case RenderSettings::Cost_Time:
+        return Timer::CurrentTime();
+
+    case RenderSettings::Cost_PrimitiveTests:
+        return (double)Statistics::Count( Statistics::Counter_PrimitiveTests );
+
+    default:
+        return 0;
+    }
+}
+
+const bool Heatmap::Create(const int &width, const int &height, const RenderSettings::Cost &cost)
+{
+    if( (width < 1) || (height < 1) )
+        return false;
+
+#ifndef _STATISTICS
+    if( cost == RenderSettings::Cost_PrimitiveTests )
+    {
+        std::cout << "Error: Primitive tests are only counted if compiled with _STATISTICS defined" << std::endl;
+        return false;
+    }
+#endif
+
+    _cost   = cost;
+    _width  = width;
+    _height = height;
+    _costs.assign( width * height, 0 );
+    return true;
+}
+
+void Heatmap::BeginPixel()
+{
+    _startReading = GetReading();
+}
+
+void Heatmap::EndPixel(const int &x, const int &y, const int &numRaysTraced)
+{
+    const double cost = (_cost == RenderSettings::Cost_Rays)? numRaysTraced: GetReading() - _startReading;
+    _costs[ y * _width + x ] += cost;
+}
+
+const bool Heatmap::Save(const std::string &imageFileName) const
+{
+    // Replace the extension of the image's file name (if it has one)
+    const std::string::size_type extension = imageFileName.find_last_of( '.' );
+    const std::string::size_type directory = imageFileName.find_last_of( "/\\" );
+    const std::string baseName = ((extension != std::string::npos) && ((directory == std::string::npos) || (extension > directory)))?
+        imageFileName.substr( 0, extension ):
+        imageFileName;
+
+    // Find the top of the colour scale amongst the pixels which were rendered
+    std::vector<double> costs;
+    for(std::size_t i=0; i < _costs.size(); ++i)
+    {
+        if( _costs[i] > 0 )
+            costs.push_back( _costs[i] );
+    }
+
+    double maxCost = 1;
+    if( !costs.empty() )
+    {
+        const std::size_t index = Maths::Min<std::size_t>( (std::size_t)(costs.size() * (ColorScalePercentile / 100)), costs.size() - 1 );
+        std::nth_element( costs.begin(), costs.begin() + index, costs.end() );
+        maxCost = costs[index];
+    }
+
+    Image costImage, colorImage;
+    if( !costImage.Create( _width, _height ) || !colorImage.Create( _width, _height ) )
+        return false;
+
+    for(int y=0; y < _height; ++y)
+    {
+        for(int x=0; x < _width; ++x)
+        {
+            const float cost = (float)_costs[ y * _width + x ];
+            costImage .SetPixel( x, y, Pixel<float>( cost, cost, cost, 1 ) );
+            colorImage.SetPixel( x, y, GetFalseColor( (float)Maths::Min<double>( cost / maxCost, 1 ) ) );
+        }
+    }
+
+    const std::string costFileName  = baseName + ".heat.pfm";
+    const std::string colorFileName = baseName + ".heat.bmp";
+    if( !costImage.Save( costFileName ) || !colorImage.Save( colorFileName ) )
+    {
+        std::cout << "Error: Failed while saving the heatmap to files: " << costFileName << ", " << colorFileName << std::endl;
+        return false;
+    }
+
+    std::cout << "Heatmap written to files: " << costFileName << ", " << colorFileName
+        << " (red is " << maxCost << " " << GetCostUnit( _cost ) << " or more per pixel)" << std::endl;
+    return true;
+}
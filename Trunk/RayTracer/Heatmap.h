@@ -0,0 +1,68 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEATMAP_HEADER
+#define HEATMAP_HEADER
+
+#include "RenderSettings.h"
+#include <string>
+#include <vector>
+
+// Records what each pixel of a render cost (its wall time, the no. of rays traced for it, or the
+// no. of ray-primitive tests), so that the expensive parts of a scene can be found.
+// The costs of all the samples taken for a pixel (in every pass) are added up.
+class Heatmap
+{
+// Members
+private:
+    RenderSettings::Cost    _cost;
+    int                     _width;
+    int                     _height;
+    std::vector<double>     _costs;
+
+    double                  _startReading;  // Time or no. of primitive tests when the current pixel was begun
+
+public:
+// Constructor
+    explicit Heatmap();
+// Destructor
+    ~Heatmap();
+
+private:
+// Copy Constructor / Assignment Operator
+    Heatmap(const Heatmap &);
+    const Heatmap &operator =(const Heatmap &);
+
+// Functions
+private:
+    const double GetReading() const;
+
+public:
+    const bool Create(const int &width, const int &height, const RenderSettings::Cost &cost);
+
+    // Called around the sampling of a pixel
+    void BeginPixel();
+    void EndPixel(const int &x, const int &y, const int &numRaysTraced);
+
+    // Saves the costs beside the image; as they are to <image name>.heat.pfm, and in false
+    // colour (from blue for the cheapest pixels to red for the most expensive) to <image name>.heat.bmp.
+    const bool Save(const std::string &imageFileName) const;
+};
+
+#endif
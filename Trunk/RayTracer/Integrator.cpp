@@ -0,0 +1,383 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Integrator.h"
+#include "Primitive.h"
+#include "Scene.h"
+#include "Light.h"
+#include "Maths.h"
+#include "Statistics.h"
+
+// Entry's Constructor
+Integrator::Entry::Entry(const Ray &ray, const Color &weight) :
+    _ray( ray ),
+    _incidentRay( ray ),
+    _weight( weight ),
+    _survivalScale( 1 ),
+    _stage( Stage_Shade ),
+    _pPrimitive( 0 ),
+    _intersectionInfo(),
+    _surfaceNormal( 0 ),
+    _diffuse( 0 ),
+    _specular( 0 ),
+    _texelColor( 1 ),
+    _opacity( 1 ),
+    _reflectedIllumination( 0 ),
+    _numReflectedRays( 0 ),
+    _reflectedRayIndex( 0 ),
+    _transmittance( 1 ),
+    _reflectionScale( 1 ),
+    _transmissionScale( 1 ),
+    _rayTreeNode( -1 )
+{
+}
+
+// Constructor
+Integrator::Integrator() :
+    _stack(),
+    _settings(),
+    _numRaysTraced( 0 ),
+    _rayBudget( -1 ),
+    _totalRaysTraced( 0 ),
+    _pRayTree( 0 )
+{
+}
+
+// Destructor
+Integrator::~Integrator()
+{
+}
+
+// Functions
+const bool Integrator::Push(const Ray &ray, const Color &weight, const Scene &scene, Color &illumination)
+{
+    const int rayTreeNode = _pRayTree? AddRayTreeNode( ray, weight ): -1;
+
+    // Note: We check the ray's generation against a doubled maxGenerations because
+    //       we create an extra generation for the incident ray passed to the Material.
+    if( ray.Generation() > (scene._maxRayGenerations * 2) )
+    {
+        illumination.Set( 0 );
+        SetRayTreeResult( rayTreeNode, RayTree::Outcome_MaxDepth, illumination );
+        return false;
+    }
+
+    // If the ray can't contribute much to the pixel, then terminate it
+    float survivalScale = 1;
+    if( _settings._minThroughput > 0 )
+    {
+        const float throughput = Maths::Max( weight.x, Maths::Max( weight.y, weight.z ) );
+        if( throughput < _settings._minThroughput )
+        {
+            if( !_settings._bRussianRoulette )
+            {
+                illumination.Set( 0 );
+                SetRayTreeResult( rayTreeNode, RayTree::Outcome_Throughput, illumination );
+                return false;
+            }
+
+            // Let it survive with a probability proportional to its throughput,
+            // and scale up the illumination of the survivors to make up for the rest.
+            const float survivalProbability = throughput / _settings._minThroughput;
+            if( Maths::GenerateRandomValue() >= survivalProbability )
+            {
+                illumination.Set( 0 );
+                SetRayTreeResult( rayTreeNode, RayTree::Outcome_Throughput, illumination );
+                return false;
+            }
+
+            survivalScale = 1 / survivalProbability;
+        }
+    }
+
+    // If we've run out of rays for this sample of the pixel
+    if( (_rayBudget >= 0) && (_numRaysTraced >= _rayBudget) )
+    {
+        illumination.Set( 0 );
+        SetRayTreeResult( rayTreeNode, RayTree::Outcome_RayBudget, illumination );
+        return false;
+    }
+    ++_numRaysTraced;
+    ++_totalRaysTraced;
+
+    // Every bounce takes two generations (see above)
+    STATISTICS_RAY_DEPTH( ray.Generation() / 2 );
+
+    IntersectionInfo intersectionInfo;
+    const Primitive *const pPrimitive = scene.FindClosestIntersection(ray, intersectionInfo);
+
+    // The ray doesn't intersect anything, then return no color.
+    if( !pPrimitive )
+    {
+        illumination.Set( 0 );
+        SetRayTreeResult( rayTreeNode, RayTree::Outcome_Miss, illumination );
+        return false;
+    }
+
+    if( rayTreeNode >= 0 )
+        _pRayTree->SetHit( rayTreeNode, pPrimitive, intersectionInfo._dist );
+
+    // If the Primitive has a Light set to it, then return the Light's illumination
+    if( pPrimitive->_pLight )
+    {
+        illumination = pPrimitive->_pLight->Illumination();
+        if( survivalScale != 1 )
+            illumination *= survivalScale;
+        SetRayTreeResult( rayTreeNode, RayTree::Outcome_Light, illumination );
+        return false;
+    }
+
+    // The stack is never reallocated, since entries are referenced while lights trace shadow rays.
+    // It's reserved for the deepest possible chain of generations, so this should never happen.
+    if( _stack.size() == _stack.capacity() )
+    {
+        illumination.Set( 0 );
+        return false;
+    }
+
+    _stack.push_back( Entry( ray, weight ) );
+
+    Entry &entry = _stack.back();
+    entry._weight          *= survivalScale;
+    entry._survivalScale    = survivalScale;
+    entry._pPrimitive       = pPrimitive;
+    entry._intersectionInfo = intersectionInfo;
+    entry._incidentRay      = Ray( intersectionInfo._point, ray.Direction(), ray );
+    entry._surfaceNormal    = pPrimitive->GetSurfaceNormal( intersectionInfo._point );
+    entry._rayTreeNode      = rayTreeNode;
+
+    return true;
+}
+
+void Integrator::Receive(Entry &entry, const Color &illumination) const
+{
+    const Material &material = entry._pPrimitive->GetMaterial();
+
+    switch( entry._stage )
+    {
+    case Stage_Reflect:
+        entry._reflectedIllumination += illumination;
+        break;
+
+    case Stage_Transmitted:
+        material.AddTransmittedIllumination( entry._diffuse, illumination * (entry._transmittance * entry._transmissionScale), entry._opacity );
+        entry._stage = Stage_Finish;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Integrator::SelectBranch(Entry &entry) const
+{
+    const Material &material = entry._pPrimitive->GetMaterial();
+
+    // Nothing to choose from
+    if( !material.IsReflective() )
+        return;
+
+    // The fuzziness is averaged over the samples of the pixel, rather than at every surface
+    entry._numReflectedRays = 1;
+
+    if( entry._opacity >= 1 )
+        return;
+
+    entry._transmittance = material.GetTransmittance( entry._intersectionInfo._bOnEntry, entry._intersectionInfo._dist );
+
+    const Color reflectedWeight   = material.GetReflectedWeight( entry._texelColor, entry._opacity );
+    const Color transmittedWeight = material.GetTransmittedWeight( entry._texelColor, entry._opacity, entry._transmittance );
+
+    const float reflected   = reflectedWeight.x + reflectedWeight.y + reflectedWeight.z;
+    const float transmitted = transmittedWeight.x + transmittedWeight.y + transmittedWeight.z;
+    const float reflectionProbability = ((reflected + transmitted) > 0)? reflected / (reflected + transmitted): 0.5f;
+
+    if( Maths::GenerateRandomValue() < reflectionProbability )
+    {
+        entry._reflectionScale   = 1 / reflectionProbability;
+        entry._transmissionScale = 0;
+    }
+    else
+    {
+        entry._reflectionScale   = 0;
+        entry._transmissionScale = 1 / (1 - reflectionProbability);
+    }
+}
+
+const int Integrator::AddRayTreeNode(const Ray &ray, const Color &weight) const
+{
+    if( _stack.empty() )
+        return _pRayTree->AddRay( -1, RayTree::RayType_Primary, ray, weight );
+
+    // Note: Shadow rays are traced while the surface is being shaded; and the stage of the
+    //       transmitting entry is advanced before its transmitted ray is traced.
+    const Entry &parent = _stack.back();
+    const RayTree::RayType type =
+        (parent._stage == Stage_Shade)?     RayTree::RayType_Shadow:
+        (parent._stage == Stage_Reflect)?   RayTree::RayType_Reflected:
+        RayTree::RayType_Transmitted;
+
+    return _pRayTree->AddRay( parent._rayTreeNode, type, ray, weight );
+}
+
+void Integrator::SetRayTreeResult(const int &node, const RayTree::Outcome &outcome, const Color &illumination) const
+{
+    if( node >= 0 )
+        _pRayTree->SetResult( node, outcome, illumination );
+}
+
+void Integrator::SetSettings(const RenderSettings &settings)
+{
+    _settings = settings;
+}
+
+void Integrator::SetRayTree(RayTree *const pRayTree)
+{
+    _pRayTree = pRayTree;
+}
+
+void Integrator::ResetRayCount(const int &sample)
+{
+    _numRaysTraced = 0;
+    _rayBudget     = _settings.SampleRayBudget( sample );
+}
+
+const int &Integrator::NumRaysTraced() const
+{
+    return _numRaysTraced;
+}
+
+const unsigned long long &Integrator::TotalRaysTraced() const
+{
+    return _totalRaysTraced;
+}
+
+const Color Integrator::GetIllumination(const Ray &ray, const Scene &scene)
+{
+    // Every entry (including those of nested calls) has a ray two generations after the one below it,
+    // so the stack never holds more than maxRayGenerations + 1 entries.
+    if( _stack.empty() )
+    {
+        const std::size_t requiredCapacity = Maths::Max( 0, scene._maxRayGenerations ) + 2;
+        if( _stack.capacity() < requiredCapacity )
+            _stack.reserve( requiredCapacity );
+    }
+
+    const std::size_t baseSize = _stack.size();
+
+    Color illumination;
+    if( !Push( ray, Color( 1 ), scene, illumination ) )
+        return illumination;
+
+    while( true )
+    {
+        Entry &entry = _stack.back();
+        const Material &material = entry._pPrimitive->GetMaterial();
+
+        switch( entry._stage )
+        {
+        case Stage_Shade:
+            // Note: The lights may trace shadow rays from here, which push entries above this one.
+            material.GetLocalIllumination( entry._incidentRay, entry._surfaceNormal, scene, entry._intersectionInfo,
+                entry._diffuse, entry._specular, entry._texelColor, entry._opacity );
+
+            if( material.IsReflective() )
+            {
+                entry._numReflectedRays = material.GetNumReflectedRays( entry._incidentRay );
+                entry._stage = Stage_Reflect;
+            }
+            else
+                entry._stage = Stage_Transmit;
+
+            if( _settings._bStochasticBranching )
+                SelectBranch( entry );
+
+            if( entry._rayTreeNode >= 0 )
+                _pRayTree->SetBranches( entry._rayTreeNode, entry._numReflectedRays, entry._reflectionScale,
+                    (entry._opacity < 1)? entry._transmissionScale: 0, entry._opacity );
+            continue;
+
+        case Stage_Reflect:
+            if( (entry._reflectedRayIndex < entry._numReflectedRays) && (entry._reflectionScale > 0) )
+            {
+                ++entry._reflectedRayIndex;
+
+                const Vector<float> direction = material.GetReflectedDirection( entry._incidentRay, entry._surfaceNormal );
+                const Color weight = entry._weight * material.GetReflectedWeight( entry._texelColor, entry._opacity ) * (entry._reflectionScale / entry._numReflectedRays);
+
+                Color reflectedIllumination;
+                if( !Push( Ray( entry._incidentRay.Origin(), direction, entry._incidentRay ), weight, scene, reflectedIllumination ) )
+                    Receive( _stack.back(), reflectedIllumination );
+                continue;
+            }
+
+            // Note: The reflected illumination is 0 if the reflected rays weren't followed,
+            //       which still leaves the diffuse illumination scaled for the reflection.
+            material.AddReflectedIllumination( entry._diffuse, entry._reflectedIllumination * (entry._reflectionScale / entry._numReflectedRays) );
+            entry._stage = Stage_Transmit;
+            continue;
+
+        case Stage_Transmit:
+            if( (entry._opacity < 1) && (entry._transmissionScale == 0) )
+            {
+                // The transmitted ray isn't being followed
+                material.AddTransmittedIllumination( entry._diffuse, Color( 0 ), entry._opacity );
+                entry._stage = Stage_Finish;
+                continue;
+            }
+
+            if( entry._opacity < 1 )
+            {
+                entry._transmittance = material.GetTransmittance( entry._intersectionInfo._bOnEntry, entry._intersectionInfo._dist );
+                entry._stage = Stage_Transmitted;
+
+                const Vector<float> direction = material.GetTransmittedDirection( entry._incidentRay, entry._surfaceNormal, entry._intersectionInfo._bOnEntry );
+                const Color weight = entry._weight * material.GetTransmittedWeight( entry._texelColor, entry._opacity, entry._transmittance ) * entry._transmissionScale;
+
+                Color transmittedIllumination;
+                if( !Push( Ray( entry._incidentRay.Origin(), direction, entry._incidentRay ), weight, scene, transmittedIllumination ) )
+                    Receive( _stack.back(), transmittedIllumination );
+                continue;
+            }
+
+            entry._stage = Stage_Finish;
+            continue;
+
+        case Stage_Transmitted:
+            // Still waiting for the transmitted ray
+            continue;
+
+        case Stage_Finish:
+            break;
+        }
+
+        // This entry is done
+        illumination = material.CombineIllumination( entry._diffuse, entry._specular, entry._texelColor );
+        if( entry._survivalScale != 1 )
+            illumination *= entry._survivalScale;
+        SetRayTreeResult( entry._rayTreeNode, RayTree::Outcome_Surface, illumination );
+        _stack.pop_back();
+
+        if( _stack.size() == baseSize )
+            return illumination;
+
+        // Hand it over to the entry which traced it
+        Receive( _stack.back(), illumination );
+    }
+}
@@ -0,0 +1,144 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef INTEGRATOR_HEADER
+#define INTEGRATOR_HEADER
+
+#include "Color.h"
+#include "Ray.h"
+#include "IntersectionInfo.h"
+#include "RenderSettings.h"
+#include "RayTree.h"
+#include <vector>
+
+// Forward Declarations
+class Scene;
+class Primitive;
+
+// Traces rays through a Scene without recursing for every bounce.
+// Each ray which hits a surface gets an entry on an explicit stack, which holds the state
+// of its surface's illumination while its reflected and transmitted rays are being traced.
+// The work is done in the same order (and with the same arithmetic) as a recursive tracer,
+// so the results are identical.
+// The stack is kept between calls, so tracing a ray doesn't allocate any memory.
+// With stochastic branching, a single ray is traced from each surface instead; the ray tree
+// becomes a path whose cost is linear in its depth, and it converges to the same image when
+// several samples are taken for each pixel.
+class Integrator
+{
+// Types
+private:
+    enum Stage
+    {
+        Stage_Shade,        // Get the illumination from the lights
+        Stage_Reflect,      // Trace the reflected rays
+        Stage_Transmit,     // Trace the transmitted ray
+        Stage_Transmitted,  // Waiting for the transmitted ray
+        Stage_Finish        // Combine the illumination
+    };
+
+    struct Entry
+    {
+        Ray                 _ray;               // The ray which hit the surface
+        Ray                 _incidentRay;       // The ray starting at the intersection point
+        Color               _weight;            // How much the illumination from this entry contributes to the ray being traced
+        float               _survivalScale;     // Compensates for the rays terminated by Russian roulette
+        Stage               _stage;
+
+        const Primitive    *_pPrimitive;
+        IntersectionInfo    _intersectionInfo;
+        Vector<float>       _surfaceNormal;
+
+        Color               _diffuse;
+        Color               _specular;
+        Color               _texelColor;
+        float               _opacity;
+
+        Color               _reflectedIllumination; // Sum of the illumination from the reflected rays
+        int                 _numReflectedRays;
+        int                 _reflectedRayIndex;     // Index of the next reflected ray
+        float               _transmittance;
+
+        // Scales the illumination through the reflected/transmitted rays to make up for the branches
+        // not followed (with stochastic branching); 0 if the branch isn't being followed.
+        float               _reflectionScale;
+        float               _transmissionScale;
+
+        int                 _rayTreeNode;       // Node of the ray in the RayTree being recorded; -1 if there's none
+
+        explicit Entry(const Ray &ray, const Color &weight);
+    };
+
+    typedef std::vector<Entry>  EntryStack;
+
+// Members
+private:
+    EntryStack      _stack;
+    RenderSettings  _settings;
+    int             _numRaysTraced; // Since the last call to ResetRayCount()
+    int             _rayBudget;     // Most rays which may be traced until the next call to ResetRayCount(); -1 for no limit
+    unsigned long long _totalRaysTraced;    // Since the Integrator was created
+    RayTree        *_pRayTree;      // Records the rays traced, if set
+
+public:
+// Constructor
+    explicit Integrator();
+// Destructor
+    ~Integrator();
+
+private:
+// Copy Constructor / Assignment Operator
+    Integrator(const Integrator &);
+    const Integrator &operator =(const Integrator &);
+
+// Functions
+private:
+    // Pushes an entry for the ray if it hits a surface; otherwise gets the illumination
+    // through the ray right away, and returns false.
+    const bool Push(const Ray &ray, const Color &weight, const Scene &scene, Color &illumination);
+
+    // Hands over the illumination through a ray traced on behalf of an entry
+    void Receive(Entry &entry, const Color &illumination) const;
+
+    // Picks a single reflected ray, and either the reflected or the transmitted ray to
+    // follow from the entry, with probabilities proportional to their weights.
+    void SelectBranch(Entry &entry) const;
+
+    // Adds a node for the ray to the RayTree; the ray's parent and type are given by the entry at the top of the stack.
+    const int AddRayTreeNode(const Ray &ray, const Color &weight) const;
+    void SetRayTreeResult(const int &node, const RayTree::Outcome &outcome, const Color &illumination) const;
+
+public:
+    void SetSettings(const RenderSettings &settings);
+
+    // Records every ray traced in the tree (until it's set to 0)
+    void SetRayTree(RayTree *const pRayTree);
+
+    // Starts counting rays afresh for a sample of a pixel, against the sample's share of the per pixel ray budget
+    void ResetRayCount(const int &sample);
+    const int &NumRaysTraced() const;
+    const unsigned long long &TotalRaysTraced() const;
+
+    // Gets the illumination from the scene through the ray.
+    // This can be called again while a ray is being traced (for shadow rays, from the lights);
+    // the nested call uses the stack above the entries of the outer one.
+    const Color GetIllumination(const Ray &ray, const Scene &scene);
+};
+
+#endif
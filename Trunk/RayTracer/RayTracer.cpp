@@ -16,19 +16,36 @@
 //  along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "RayTracer.h"
-#include "Primitive.h"
+#include "Integrator.h"
+#include "Film.h"
+#include "Timer.h"
+#include "RenderOrder.h"
+#include "Checkpoint.h"
+#include "RenderWorker.h"
+#include "Message.h"
+#include "SafeDelete.h"
+#include "ForEach.h"
+#include "Utility.h"
 #include "Ray.h"
 #include "Scene.h"
-#include "Light.h"
 #include "Image.h"
+#include "Texture.h"
 #include "Maths.h"
+#include "Statistics.h"
+#include "Heatmap.h"
+#include "RayTree.h"
+#include "Trace.h"
 #include <iostream>
+#include <vector>
 
 // Initialize the static members
 bool RayTracer::_bRayTraceShadows = false;
 
 // Constructor
-RayTracer::RayTracer()
+RayTracer::RayTracer() :
+    _settings(),
+    _sceneCrc( 0 ),
+    _pHeatmap( 0 )
 {
 }
 
@@ -37,64 +54,670 @@ RayTracer::~RayTracer()
 {
 }
 
+// WorkerConnection's Constructor
+RayTracer::WorkerConnection::WorkerConnection() :
+    _socket(),
+    _tile( -1 ),
+    _numTiles( 0 ),
+    _renderTime( 0 )
+{
+}
+
 // Functions
 
+Integrator &RayTracer::GetIntegrator()
+{
+    // The Integrator traces the ray (and all the rays spawned by it) iteratively.
+    // Its stack is reused for every ray, so it's kept around.
+    static Integrator integrator;
+    return integrator;
+}
+
 const Color RayTracer::GetIllumination(const Ray &ray, const Scene &scene)
 {
-    // Note: We check the ray's generation against a doubled maxGenerations because
-    //       we create an extra generation right here in this function below (while
-    //       passing a new ray to Material's GetIllumination().
-    if( ray.Generation() > (scene._maxRayGenerations * 2) )
-        return Color( 0 );
+    return GetIntegrator().GetIllumination( ray, scene );
+}
+
+const unsigned long long RayTracer::NumRaysTraced()
+{
+    return GetIntegrator().TotalRaysTraced();
+}
 
-    IntersectionInfo intersectionInfo;
-    const Primitive *const pPrimitive = scene.FindClosestIntersection(ray, intersectionInfo);
+const Vector<float> RayTracer::GetRayDirection(const Camera &camera, const int &width, const int &height, const float &x, const float &y)
+{
+    Vector<float> rayDirection;
+    rayDirection.x = cos( Maths::DegToRad( Maths::InterpolateLinear( 90 + camera._hFov/2, 90 - camera._hFov/2, x / (float)width ) ) );
+    rayDirection.y = cos( Maths::DegToRad( Maths::InterpolateLinear( 90 - camera._vFov/2, 90 + camera._vFov/2, y / (float)height ) ) );
+    rayDirection.z = -sqrt( (2 - (rayDirection.x * rayDirection.x + rayDirection.y * rayDirection.y)) / 2 );
+    rayDirection.Normalize();
 
-    // The ray doesn't intersect anything, then return no color.
-    if( !pPrimitive )
-        return Color( 0 );
+    return rayDirection;
+}
+
+void RayTracer::SamplePixel(const Camera &camera, const Scene &scene, Film &film,
+    const int &x, const int &y, const int &firstSample, const int &numSamples) const
+{
+    Integrator &integrator = GetIntegrator();
 
-    // If the Primitive has a Light set to it, then return the Light's illumination
-    if( pPrimitive->_pLight )
-        return pPrimitive->_pLight->Illumination();
+    // A pixel which is sampled just once is sampled at its sample point (as without antialiasing)
+    const bool bJitter = (_settings._samplesPerPixel > 1) || (_settings._adaptiveThreshold > 0) || _settings._bProgressive;
 
-    // Return the illumination from the material
-    return pPrimitive->_material.GetIllumination(
-        Ray( intersectionInfo._point, ray.Direction(), ray ),
-        pPrimitive->GetSurfaceNormal( intersectionInfo._point ),
-        scene,
-        intersectionInfo );
+    // The samples are stratified by placing them on a Halton sequence, which stays evenly spread as
+    // samples are added. Each pixel's sequence is shifted (with wrap around) by its own fixed amount,
+    // so that neighbouring pixels don't share the same pattern.
+    float shiftX = 0, shiftY = 0;
+    if( bJitter )
+    {
+        unsigned int hash = (unsigned int)(y * film.Width() + x) * 2654435761u;
+        hash ^= hash >> 16;
+        shiftX = (hash & 0xFFFF) / 65536.0f;
+        shiftY = (hash >> 16) / 65536.0f;
+    }
+
+    if( _pHeatmap )
+        _pHeatmap->BeginPixel();
+
+    int numRaysTraced = 0;
+    for(int sample = firstSample; sample < firstSample + numSamples; ++sample)
+    {
+        float offsetX = 0, offsetY = 0;
+        if( bJitter )
+        {
+            offsetX = Maths::RadicalInverse( sample, 2 ) + shiftX;
+            offsetY = Maths::RadicalInverse( sample, 3 ) + shiftY;
+            offsetX = (offsetX >= 1? offsetX - 1: offsetX) - 0.5f;
+            offsetY = (offsetY >= 1? offsetY - 1: offsetY) - 0.5f;
+        }
+
+        // Each sample gets its share of the pixel's budget of rays
+        integrator.ResetRayCount( sample );
+
+        // Get the illumination from the scene through this ray.
+        const Vector<float> rayDirection = GetRayDirection( camera, film.Width(), film.Height(), x + offsetX, y + offsetY );
+        STATISTICS_INCREMENT( Counter_PrimaryRays );
+        const Color color = GetIllumination( Ray( camera._position, rayDirection, Ray::RootGeneration() ), scene );
+        numRaysTraced += integrator.NumRaysTraced();
+
+        film.AddSample( x, y, offsetX, offsetY, color );
+    }
+
+    if( _pHeatmap )
+        _pHeatmap->EndPixel( x, y, numRaysTraced );
+}
+
+const bool RayTracer::UpdateProgress(const Film &film, Image &image, const std::string &imageFileName,
+    const Timer &renderTimer, Timer &saveTimer) const
+{
+    if( (_settings._saveInterval > 0) && (saveTimer.ElapsedTime() >= _settings._saveInterval) )
+    {
+        if( !film.Resolve( image ) || !image.Save( imageFileName ) )
+            std::cout << "Error: Failed while saving image to file: " << imageFileName << std::endl;
+
+        saveTimer.Reset();
+    }
+
+    return (_settings._timeLimit <= 0) || (renderTimer.ElapsedTime() < _settings._timeLimit);
+}
+
+const bool RayTracer::AssignTile(WorkerConnection &worker, const RenderOrder &order, std::vector<int> &pendingTiles)
+{
+    if( pendingTiles.empty() )
+    {
+        worker._tile = -1;
+        return true;
+    }
+
+    worker._tile = pendingTiles.back();
+    pendingTiles.pop_back();
+
+    int x, y, width, height, firstPixel, lastPixel;
+    order.GetTile( worker._tile, x, y, width, height, firstPixel, lastPixel );
+
+    Message message( RenderWorker::Message_Tile );
+    message.Write( worker._tile );
+    message.Write( x );
+    message.Write( y );
+    message.Write( width );
+    message.Write( height );
+
+    return message.Send( worker._socket );
+}
+
+const bool RayTracer::GetWindow(const Image &image, int &x, int &y, int &width, int &height) const
+{
+    if( _settings._cropWidth == 0 )
+    {
+        x = y = 0;
+        width  = image.Width();
+        height = image.Height();
+        return true;
+    }
+
+    // Clip the crop window to the image
+    x = Maths::Min( _settings._cropX, image.Width() );
+    y = Maths::Min( _settings._cropY, image.Height() );
+    width  = Maths::Min( _settings._cropX + _settings._cropWidth,  image.Width()  ) - x;
+    height = Maths::Min( _settings._cropY + _settings._cropHeight, image.Height() ) - y;
+
+    if( (width < 1) || (height < 1) )
+    {
+        std::cout << "Error: The crop window lies outside the image" << std::endl;
+        return false;
+    }
+
+    return true;
 }
 
 const bool RayTracer::Render(const Camera &camera, const Scene &scene, Image &image) const
 {
     // RayTrace the Scene
+    Integrator &integrator = GetIntegrator();
+    integrator.SetSettings( _settings );
+
+    Film film;
+    if( !film.Create( image.Width(), image.Height(), _settings._filter ) )
+        return false;
+
+    int windowX, windowY, windowWidth, windowHeight;
+    if( !GetWindow( image, windowX, windowY, windowWidth, windowHeight ) ||
+        !film.SetWindow( windowX, windowY, windowWidth, windowHeight ) )
+        return false;
+
+    // Checkpoints record whole tiles, so the image mustn't be a single tile
+    const bool bCheckpoint = !_settings._checkpointFileName.empty();
+    const int tileSize = (bCheckpoint && (_settings._tileSize == 0))? DefaultCheckpointTileSize: _settings._tileSize;
+
+    RenderOrder order;
+    if( !order.Create( windowX, windowY, windowWidth, windowHeight, tileSize, _settings._tileOrder, _settings._pixelOrder ) )
+        return false;
+
+    // The render goes through passes; the first one samples every pixel, and the rest (if the
+    // sampling is adaptive) add samples to the pixels which need refinement.
+    // Each pass goes through the pixels (indices into the order) tile by tile.
+    int pass = 0;
+    std::vector<int> passPixels;
+    std::vector<bool> finishedTiles( order.NumTiles(), false );
+
+    Checkpoint checkpoint;
+    Timer checkpointTimer;
+    bool bResumedPass = false;
+    if( bCheckpoint )
+    {
+        // A checkpoint can only be resumed by a render of the same image
+        const std::string crcString =
+            Utility::String::ToString( _settings.CalculateCrc() )   + " " +
+            Utility::String::ToString( _sceneCrc )                  + " " +
+            Utility::String::ToString( image.Width() )              + " " +
+            Utility::String::ToString( image.Height() )             + " " +
+            Utility::String::ToString( camera._position.x )         + " " +
+            Utility::String::ToString( camera._position.y )         + " " +
+            Utility::String::ToString( camera._position.z )         + " " +
+            Utility::String::ToString( camera._hFov )               + " " +
+            Utility::String::ToString( camera._vFov );
+
+        if( !checkpoint.Open( _settings._checkpointFileName, Utility::String::CalculateCrc( crcString ), _settings._bResume,
+                film, pass, passPixels, finishedTiles ) )
+            return false;
+
+        bResumedPass = _settings._bResume;
+    }
+
+    for(; ; ++pass)
+    {
+        // The first pass samples all the pixels; the pixels of a later pass being
+        // resumed are restored from the checkpoint.
+        if( pass == 0 )
+        {
+            passPixels.resize( order.NumPixels() );
+            for(int i=0; i < order.NumPixels(); ++i)
+                passPixels[i] = i;
+        }
+        else if( !bResumedPass )
+        {
+            // Find all the pixels to refine before adding any samples, so that
+            // the decisions don't depend on the order of the pixels.
+            if( _settings._adaptiveThreshold <= 0 )
+                break;
+
+            passPixels.clear();
+            for(int i=0; i < order.NumPixels(); ++i)
+            {
+                int x, y;
+                order.GetPixel( i, x, y );
+
+                if( (film.NumSamples( x, y ) < _settings._maxSamplesPerPixel) &&
+                    film.NeedsRefinement( x, y, _settings._adaptiveThreshold ) )
+                    passPixels.push_back( i );
+            }
+
+            if( passPixels.empty() )
+                break;
+
+            finishedTiles.assign( finishedTiles.size(), false );
+            if( bCheckpoint && !checkpoint.BeginPass( pass, passPixels ) )
+                std::cout << "Error: Failed while writing the checkpoint file: " << _settings._checkpointFileName << std::endl;
+        }
+        bResumedPass = false;
+
+        // The pixels of each tile are consecutive in the order, and so in passPixels
+        std::size_t nextPixel = 0;
+        for(int tile=0; tile < order.NumTiles(); ++tile)
+        {
+            int tileX, tileY, tileWidth, tileHeight, firstPixel, lastPixel;
+            order.GetTile( tile, tileX, tileY, tileWidth, tileHeight, firstPixel, lastPixel );
+
+            const std::size_t tileFirstPixel = nextPixel;
+            while( (nextPixel < passPixels.size()) && (passPixels[nextPixel] < lastPixel) )
+                ++nextPixel;
+
+            if( finishedTiles[tile] || (tileFirstPixel == nextPixel) )
+                continue;
+
+            const Trace::Scope traceScope( "Render tile", Trace::IsStarted()?
+                "pass " + Utility::String::ToString( pass ) + ", tile " + Utility::String::ToString( tile ): std::string() );
+
+            // Only capture the part of the tile being sampled in this pass
+            if( bCheckpoint )
+            {
+                int minX = tileX + tileWidth, minY = tileY + tileHeight, maxX = tileX, maxY = tileY;
+                for(std::size_t i = tileFirstPixel; i < nextPixel; ++i)
+                {
+                    int x, y;
+                    order.GetPixel( passPixels[i], x, y );
+
+                    minX = Maths::Min( minX, x );
+                    minY = Maths::Min( minY, y );
+                    maxX = Maths::Max( maxX, x );
+                    maxY = Maths::Max( maxY, y );
+                }
+
+                film.BeginCapture( minX, minY, maxX - minX + 1, maxY - minY + 1 );
+            }
+
+            for(std::size_t i = tileFirstPixel; i < nextPixel; ++i)
+            {
+                int x, y;
+                order.GetPixel( passPixels[i], x, y );
+
+                const int numSamples = film.NumSamples( x, y );
+                SamplePixel( camera, scene, film, x, y, numSamples, (pass == 0)?
+                    _settings._samplesPerPixel:
+                    Maths::Min( _settings._samplesPerPixel, _settings._maxSamplesPerPixel - numSamples ) );
+
+                // Display a mark for every row's worth of pixels completed in the first pass
+                if( (pass == 0) && ((passPixels[i] + 1) % windowWidth == 0) )
+                    std::cout << ".";
+            }
+
+            if( bCheckpoint )
+            {
+                film.EndCapture();
+                if( !checkpoint.AddTile( pass, tile, film ) )
+                    std::cout << "Error: Failed while writing the checkpoint file: " << _settings._checkpointFileName << std::endl;
+
+                if( checkpointTimer.ElapsedTime() >= _settings._checkpointInterval )
+                {
+                    checkpoint.Flush();
+                    checkpointTimer.Reset();
+                }
+            }
+        }
+
+        // Display a mark for each refinement pass
+        if( pass > 0 )
+            std::cout << "+";
+    }
+
+    checkpoint.Close();
+
+    return film.Resolve( image );
+}
+
+const bool RayTracer::RenderProgressive(const Camera &camera, const Scene &scene, Image &image, const std::string &imageFileName) const
+{
+    if( !_settings._checkpointFileName.empty() )
+    {
+        std::cout << "Error: Checkpoints aren't supported for progressive renders" << std::endl;
+        return false;
+    }
+
+    const Timer renderTimer;
+    Timer saveTimer;
+
+    // RayTrace the Scene
+    Integrator &integrator = GetIntegrator();
+    integrator.SetSettings( _settings );
+
+    Film film;
+    if( !film.Create( image.Width(), image.Height(), _settings._filter ) )
+        return false;
+
+    int windowX, windowY, windowWidth, windowHeight;
+    if( !GetWindow( image, windowX, windowY, windowWidth, windowHeight ) ||
+        !film.SetWindow( windowX, windowY, windowWidth, windowHeight ) )
+        return false;
+
+    RenderOrder order;
+    if( !order.Create( windowX, windowY, windowWidth, windowHeight, _settings._tileSize, _settings._tileOrder, _settings._pixelOrder ) )
+        return false;
+
+    // Coarse to fine passes; each samples the pixels at every blockSize'th row and column
+    // of the image (within the window), skipping those sampled by the previous pass.
+    bool bInTime = true;
+    for(int blockSize = Film::CoarsestBlockSize; bInTime && (blockSize >= 1); blockSize /= 2)
+    {
+        const Trace::Scope traceScope( "Render coarse pass", Trace::IsStarted()? "block size " + Utility::String::ToString( blockSize ): std::string() );
+        const int firstX = windowX + (blockSize - windowX % blockSize) % blockSize;
+        const int firstY = windowY + (blockSize - windowY % blockSize) % blockSize;
+
+        for(int y = firstY; bInTime && (y < windowY + windowHeight); y += blockSize)
+        {
+            for(int x = firstX; x < windowX + windowWidth; x += blockSize)
+            {
+                if( (blockSize < Film::CoarsestBlockSize) && (x % (blockSize * 2) == 0) && (y % (blockSize * 2) == 0) )
+                    continue;
+
+                SamplePixel( camera, scene, film, x, y, 0, 1 );
+            }
+
+            bInTime = UpdateProgress( film, image, imageFileName, renderTimer, saveTimer );
+        }
+
+        // Display a mark for each pass completed
+        if( bInTime )
+            std::cout << ".";
+    }
+
+    // Keep adding a sample to each pixel (which needs refinement, if the sampling is adaptive)
+    bool bSampled = true;
+    while( bInTime && bSampled )
+    {
+        const Trace::Scope traceScope( "Render refinement pass" );
+        bSampled = false;
+        for(int i=0; bInTime && (i < order.NumPixels()); ++i)
+        {
+            int x, y;
+            order.GetPixel( i, x, y );
+
+            const int numSamples = film.NumSamples( x, y );
+            if( (numSamples < _settings._maxSamplesPerPixel) &&
+                ((_settings._adaptiveThreshold <= 0) || film.NeedsRefinement( x, y, _settings._adaptiveThreshold )) )
+            {
+                SamplePixel( camera, scene, film, x, y, numSamples, 1 );
+                bSampled = true;
+            }
+
+            // Check on the progress after every row's worth of pixels
+            if( (i + 1) % windowWidth == 0 )
+                bInTime = UpdateProgress( film, image, imageFileName, renderTimer, saveTimer );
+        }
+
+        // Display a mark for each pass completed
+        if( bInTime )
+            std::cout << "+";
+    }
+
+    return film.Resolve( image );
+}
+
+void RayTracer::RenderTile(const Camera &camera, const Scene &scene, Film &film,
+    const int &x, const int &y, const int &width, const int &height) const
+{
+    Integrator &integrator = GetIntegrator();
+    integrator.SetSettings( _settings );
+
+    RenderOrder order;
+    if( !order.Create( x, y, width, height, 0, _settings._tileOrder, _settings._pixelOrder ) )
+        return;
+
+    const Trace::Scope traceScope( "Render tile", Trace::IsStarted()?
+        "x " + Utility::String::ToString( x ) + ", y " + Utility::String::ToString( y ): std::string() );
+
+    film.BeginCapture( x, y, width, height );
+
+    for(int i=0; i < order.NumPixels(); ++i)
+    {
+        int pixelX, pixelY;
+        order.GetPixel( i, pixelX, pixelY );
+
+        const int numSamples = film.NumSamples( pixelX, pixelY );
+        SamplePixel( camera, scene, film, pixelX, pixelY, numSamples, _settings._samplesPerPixel );
+    }
+
+    // Refine the tile in passes, as Render() does for the whole window. The pixels are only compared
+    // with their neighbours within the tile: a worker's film also holds the samples of the other tiles
+    // it rendered, which would make the refinement depend on how the tiles were shared out.
+    std::vector<int> passPixels;
+    while( _settings._adaptiveThreshold > 0 )
+    {
+        passPixels.clear();
+        for(int i=0; i < order.NumPixels(); ++i)
+        {
+            int pixelX, pixelY;
+            order.GetPixel( i, pixelX, pixelY );
+
+            if( (film.NumSamples( pixelX, pixelY ) < _settings._maxSamplesPerPixel) &&
+                film.NeedsRefinement( pixelX, pixelY, _settings._adaptiveThreshold, x, y, width, height ) )
+                passPixels.push_back( i );
+        }
+
+        if( passPixels.empty() )
+            break;
+
+        for(std::size_t i=0; i < passPixels.size(); ++i)
+        {
+            int pixelX, pixelY;
+            order.GetPixel( passPixels[i], pixelX, pixelY );
+
+            const int numSamples = film.NumSamples( pixelX, pixelY );
+            SamplePixel( camera, scene, film, pixelX, pixelY, numSamples,
+                Maths::Min( _settings._samplesPerPixel, _settings._maxSamplesPerPixel - numSamples ) );
+        }
+    }
+
+    film.EndCapture();
+}
+
+const bool RayTracer::RenderDistributed(const Camera &camera, const Scene &scene, const std::string &sceneText,
+    const std::vector<std::string> &settings, Image &image, const std::string &address) const
+{
+    if( _settings._bProgressive || !_settings._checkpointFileName.empty() )
+    {
+        std::cout << "Error: Progressive and checkpointed renders can't be distributed" << std::endl;
+        return false;
+    }
 
-    // For each pixel of the image
-    for(int y=0; y < image.Height(); ++y)
+    Film film;
+    if( !film.Create( image.Width(), image.Height(), _settings._filter ) )
+        return false;
+
+    int windowX, windowY, windowWidth, windowHeight;
+    if( !GetWindow( image, windowX, windowY, windowWidth, windowHeight ) ||
+        !film.SetWindow( windowX, windowY, windowWidth, windowHeight ) )
+        return false;
+
+    // The tiles are the units of work handed out, so the image mustn't be a single tile
+    const int tileSize = (_settings._tileSize == 0)? DefaultDistributedTileSize: _settings._tileSize;
+
+    RenderOrder order;
+    if( !order.Create( windowX, windowY, windowWidth, windowHeight, tileSize, _settings._tileOrder, _settings._pixelOrder ) )
+        return false;
+
+    Socket listener;
+    if( !listener.Listen( address ) )
+        return false;
+
+    // Everything a worker needs to render tiles of the image
+    Message sceneMessage( RenderWorker::Message_Scene );
+    sceneMessage.Write( image.Width() );
+    sceneMessage.Write( image.Height() );
+    sceneMessage.Write( camera._position.x );
+    sceneMessage.Write( camera._position.y );
+    sceneMessage.Write( camera._position.z );
+    sceneMessage.Write( camera._hFov );
+    sceneMessage.Write( camera._vFov );
+    sceneMessage.Write( (int)settings.size() );
+    for(std::size_t i=0; i < settings.size(); ++i)
+        sceneMessage.WriteString( settings[i] );
+    sceneMessage.WriteString( sceneText );
+
+    // The workers needn't share a file system with us, so they're sent the texture files as they're stored
+    sceneMessage.Write( (int)scene.Textures().size() );
+    FOR_EACH( itr, Scene::TextureList, scene.Textures() )
     {
-        for(int x=0; x < image.Width(); ++x)
+        const std::string &fileName = (*itr)->FileName();
+
+        Image::FileData file;
+        if( !Image::ReadFile( fileName, file ) )
         {
-            const Vector<float> &rayOrigin = camera._position;
+            std::cout << "Error: Failed to read texture file: " << fileName << std::endl;
+            return false;
+        }
+
+        sceneMessage.WriteString( fileName );
+        sceneMessage.WriteBuffer( file );
+    }
+
+    // The tiles are handed out from the back, so they're stored in reverse order.
+    // The tile of a worker which is lost is put back, to be handed out next.
+    std::vector<int> pendingTiles;
+    for(int tile = order.NumTiles() - 1; tile >= 0; --tile)
+        pendingTiles.push_back( tile );
 
-            Vector<float> rayDirection;
+    std::cout << "Waiting for workers on: " << address << std::endl;
+
+    WorkerConnectionArray workers;
+    Message message;
+    Film::Buffer region;
+    int numFinishedTiles = 0, numWorkers = 0;
+    int slowestTile = -1;
+    double slowestTileTime = 0;
+    bool bResult = true;
+
+    while( numFinishedTiles < order.NumTiles() )
+    {
+        Socket::SocketArray sockets( 1, &listener );
+        for(std::size_t i=0; i < workers.size(); ++i)
+            sockets.push_back( &workers[i]->_socket );
+
+        Socket::BoolArray bReadable;
+        if( !Socket::WaitForData( sockets, bReadable ) )
+        {
+            bResult = false;
+            break;
+        }
+
+        // Receive the results of the workers which have sent them; a worker whose connection
+        // fails (or which sends anything else) is dropped, and its tile handed out again.
+        for(std::size_t i=0; i < workers.size(); ++i)
+        {
+            if( !bReadable[i + 1] )
+                continue;
+
+            WorkerConnection &worker = *workers[i];
+
+            int tile;
+            double seconds;
+            region.clear();
+            if( !message.Receive( worker._socket ) || (message.Type() != RenderWorker::Message_Result) ||
+                !message.Read( tile ) || !message.Read( seconds ) || !message.ReadBuffer( region ) ||
+                (tile != worker._tile) || !film.AddRegion( region ) )
             {
-                rayDirection.x = cos( Maths::DegToRad( Maths::InterpolateLinear( 90 + camera._hFov/2, 90 - camera._hFov/2, x / (float)image.Width() ) ) );
-                rayDirection.y = cos( Maths::DegToRad( Maths::InterpolateLinear( 90 - camera._vFov/2, 90 + camera._vFov/2, y / (float)image.Height() ) ) );
-                rayDirection.z = -sqrt( (2 - (rayDirection.x * rayDirection.x + rayDirection.y * rayDirection.y)) / 2 );
-                rayDirection.Normalize();
+                worker._socket.Close();
+                continue;
             }
 
-            // Get the illumination from the scene through this ray.
-            const Color color = GetIllumination( Ray( rayOrigin, rayDirection, Ray::RootGeneration() ), scene );
+            ++numFinishedTiles;
+            ++worker._numTiles;
+            worker._renderTime += seconds;
+            if( seconds > slowestTileTime )
+            {
+                slowestTile = tile;
+                slowestTileTime = seconds;
+            }
+
+            // Display a mark for each tile completed
+            std::cout << ".";
 
-            // Plot it.
-            image.SetPixel(x, y, Pixel<float>(color.x, color.y, color.z, 1));
+            if( !AssignTile( worker, order, pendingTiles ) )
+                worker._socket.Close();
         }
 
-        // Display the no. of the row just completed
-        std::cout << ".";
+        // Accept a new worker, and send it the scene
+        if( bReadable[0] )
+        {
+            WorkerConnection *pWorker = new WorkerConnection;
+            if( listener.Accept( pWorker->_socket ) && sceneMessage.Send( pWorker->_socket ) )
+            {
+                workers.push_back( pWorker );
+                ++numWorkers;
+            }
+            else
+                SafeDeleteScalar( pWorker );
+        }
+
+        // Put back the tiles of the workers which were lost
+        for(std::size_t i=0; i < workers.size(); )
+        {
+            if( workers[i]->_socket.IsOpen() )
+            {
+                ++i;
+                continue;
+            }
+
+            if( workers[i]->_tile >= 0 )
+                pendingTiles.push_back( workers[i]->_tile );
+
+            std::cout << "Error: Lost a worker; its tile will be rendered again" << std::endl;
+            SafeDeleteScalar( workers[i] );
+            workers.erase( workers.begin() + i );
+        }
+
+        // Hand out tiles to the idle workers
+        for(std::size_t i=0; i < workers.size(); ++i)
+        {
+            if( (workers[i]->_tile < 0) && !AssignTile( *workers[i], order, pendingTiles ) )
+                workers[i]->_socket.Close();
+        }
+    }
+
+    // Tell the workers we're done, and display how much each one of them did
+    for(std::size_t i=0; i < workers.size(); ++i)
+    {
+        Message( RenderWorker::Message_Done ).Send( workers[i]->_socket );
+
+        std::cout << std::endl << "Worker " << i << ": " << workers[i]->_numTiles << " tiles in " << workers[i]->_renderTime << " seconds";
+        SafeDeleteScalar( workers[i] );
     }
 
+    if( !bResult )
+        return false;
+
+    std::cout << std::endl << numWorkers << " workers connected; slowest tile: " << slowestTile << " (" << slowestTileTime << " seconds)" << std::endl;
+
+    return film.Resolve( image );
+}
+
+const bool RayTracer::TracePixel(const Camera &camera, const Scene &scene, const int &width, const int &height,
+    const int &x, const int &y, RayTree &rayTree) const
+{
+    if( (x < 0) || (x >= width) || (y < 0) || (y >= height) )
+    {
+        std::cout << "Error: The pixel (" << x << ", " << y << ") lies outside the image" << std::endl;
+        return false;
+    }
+
+    Integrator &integrator = GetIntegrator();
+    integrator.SetSettings( _settings );
+
+    Film film;
+    if( !film.Create( width, height, _settings._filter ) )
+        return false;
+
+    rayTree.Clear();
+    integrator.SetRayTree( &rayTree );
+    SamplePixel( camera, scene, film, x, y, 0, _settings._samplesPerPixel );
+    integrator.SetRayTree( 0 );
+
     return true;
 }
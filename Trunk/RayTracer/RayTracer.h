@@ -20,18 +20,54 @@
 
 #include "Color.h"
 #include "Camera.h"
+#include "RenderSettings.h"
+#include "CrcCalculator.h"
+#include "Socket.h"
+#include <string>
+#include <vector>
 
 // Forward Declarations
 class Ray;
 class Scene;
 class Image;
+class Integrator;
+class Film;
+class Timer;
+class RenderOrder;
+class Heatmap;
+class RayTree;
 
 class RayTracer
 {
+// Types
+private:
+    enum
+    {
+        DefaultCheckpointTileSize   = 32,   // Tile size used for checkpointed renders which don't specify one
+        DefaultDistributedTileSize  = 32    // Tile size used for distributed renders which don't specify one
+    };
+
+    // A worker connected to a distributed render
+    struct WorkerConnection
+    {
+        Socket  _socket;
+        int     _tile;          // Tile being rendered by the worker; -1 if it's idle
+        int     _numTiles;      // No. of tiles rendered by the worker so far
+        double  _renderTime;    // Time taken by the worker to render them, in seconds
+
+        explicit WorkerConnection();
+    };
+
+    typedef std::vector<WorkerConnection *> WorkerConnectionArray;
+
 // Members
 public:
     static bool _bRayTraceShadows;
 
+    RenderSettings          _settings;
+    CrcCalculator::CrcType  _sceneCrc;  // CRC of the scene file; checkpoints are only resumed for the same scene
+    Heatmap                *_pHeatmap;  // Records the cost of every pixel sampled, if set
+
 public:
 // Constructor
     explicit RayTracer();
@@ -44,10 +80,57 @@ private:
     const RayTracer &operator =(const RayTracer &);
 
 // Functions
+private:
+    static Integrator &GetIntegrator();
+
+    // Gets the window of the image to be rendered (the crop window, clipped to the image).
+    const bool GetWindow(const Image &image, int &x, int &y, int &width, int &height) const;
+
+    static const Vector<float> GetRayDirection(const Camera &camera, const int &width, const int &height, const float &x, const float &y);
+
+    // Traces numSamples rays through the pixel (starting with the sample no. firstSample) into the film.
+    void SamplePixel(const Camera &camera, const Scene &scene, Film &film,
+        const int &x, const int &y, const int &firstSample, const int &numSamples) const;
+
+    // Called between the rows of a progressive render; saves the image if it's time to, and returns
+    // false once the time limit is up.
+    const bool UpdateProgress(const Film &film, Image &image, const std::string &imageFileName,
+        const Timer &renderTimer, Timer &saveTimer) const;
+
+    // Hands the next pending tile to the worker, if there is one.
+    // Returns false if the connection to the worker is lost.
+    static const bool AssignTile(WorkerConnection &worker, const RenderOrder &order, std::vector<int> &pendingTiles);
+
 public:
     static const Color GetIllumination(const Ray &ray, const Scene &scene);
 
+    // Returns the no. of rays traced by the Integrator so far (including shadow rays only if they're ray traced)
+    static const unsigned long long NumRaysTraced();
+
     const bool Render(const Camera &camera, const Scene &scene, Image &image) const;
+
+    // Renders a coarse image first (sampling every 8th pixel), and refines it in passes until every pixel
+    // is sampled; then adds samples to every pixel until the time limit or _maxSamplesPerPixel is reached.
+    // The image rendered so far is saved to the file every _saveInterval seconds.
+    const bool RenderProgressive(const Camera &camera, const Scene &scene, Image &image, const std::string &imageFileName) const;
+
+    // Renders a tile of the film, capturing the contributions of its samples (see Film::WriteCapture()).
+    // If the sampling is adaptive, the tile's pixels are refined before returning.
+    void RenderTile(const Camera &camera, const Scene &scene, Film &film,
+        const int &x, const int &y, const int &width, const int &height) const;
+
+    // Coordinates a render by workers in other processes (see RenderWorker), which connect to the address.
+    // Each worker is sent the text of the scene file (which the scene was read from) along with the contents
+    // of its texture files, the camera and the render settings (as given on the command line), and then a
+    // tile at a time; the tiles they send back are assembled into the image.
+    const bool RenderDistributed(const Camera &camera, const Scene &scene, const std::string &sceneText,
+        const std::vector<std::string> &settings, Image &image, const std::string &address) const;
+
+    // Samples a single pixel of an image of the given size, recording every ray traced for it in the tree.
+    // Note: The random choices (for fuzzy reflections, Russian roulette, etc.) aren't the
+    //       same as those made for the pixel while rendering the whole image.
+    const bool TracePixel(const Camera &camera, const Scene &scene, const int &width, const int &height,
+        const int &x, const int &y, RayTree &rayTree) const;
 };
 
 #endif
@@ -0,0 +1,220 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RayTree.h"
+#include "Ray.h"
+#include "Scene.h"
+#include "Utility.h"
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char *const RayTypeNames[] =
+    {
+        "primary",
+        "reflected",
+        "transmitted",
+        "shadow"
+    };
+
+    const char *const OutcomeNames[] =
+    {
+        "pending",
+        "maxDepth",
+        "throughput",
+        "rayBudget",
+        "miss",
+        "light",
+        "surface"
+    };
+
+    // Writes a vector as a JSON array
+    void WriteJsonVector(std::ostream &stream, const Vector<float> &v)
+    {
+        stream << "[" << v.x << ", " << v.y << ", " << v.z << "]";
+    }
+
+    // Writes a vector for a Graphviz label
+    void WriteLabelVector(std::ostream &stream, const Vector<float> &v)
+    {
+        stream << "(" << v.x << ", " << v.y << ", " << v.z << ")";
+    }
+}
+
+// Node's Constructor
+RayTree::Node::Node() :
+    _parent( -1 ),
+    _type( RayType_Primary ),
+    _generation( 0 ),
+    _origin( 0 ),
+    _direction( 0 ),
+    _weight( 0 ),
+    _outcome( Outcome_Pending ),
+    _pPrimitive( 0 ),
+    _distance( 0 ),
+    _illumination( 0 ),
+    _numReflectedRays( 0 ),
+    _reflectionScale( 0 ),
+    _transmissionScale( 0 ),
+    _opacity( 1 )
+{
+}
+
+// Constructor
+RayTree::RayTree() :
+    _nodes()
+{
+}
+
+// Destructor
+RayTree::~RayTree()
+{
+}
+
+// Functions
+void RayTree::WriteJson(std::ostream &stream, const Scene &scene) const
+{
+    stream << "{" << std::endl << "    \"rays\": [";
+
+    for(std::size_t i=0; i < _nodes.size(); ++i)
+    {
+        const Node &node = _nodes[i];
+
+        stream << ((i > 0)? ",": "") << std::endl << "        {";
+        stream << " \"id\": " << i << ", \"parent\": " << node._parent;
+        stream << ", \"type\": \"" << RayTypeNames[node._type] << "\", \"generation\": " << node._generation;
+        stream << ", \"origin\": ";         WriteJsonVector( stream, node._origin );
+        stream << ", \"direction\": ";      WriteJsonVector( stream, node._direction );
+        stream << ", \"weight\": ";         WriteJsonVector( stream, node._weight );
+        stream << ", \"outcome\": \"" << OutcomeNames[node._outcome] << "\"";
+
+        if( node._pPrimitive )
+            stream << ", \"primitive\": " << scene.GetPrimitiveIndex( node._pPrimitive ) << ", \"distance\": " << node._distance;
+
+        if( node._outcome == Outcome_Surface )
+        {
+            stream << ", \"opacity\": " << node._opacity << ", \"reflectedRays\": " << node._numReflectedRays;
+            stream << ", \"reflectionScale\": " << node._reflectionScale << ", \"transmissionScale\": " << node._transmissionScale;
+        }
+
+        stream << ", \"illumination\": ";   WriteJsonVector( stream, node._illumination );
+        stream << " }";
+    }
+
+    stream << std::endl << "    ]" << std::endl << "}" << std::endl;
+}
+
+void RayTree::WriteGraphviz(std::ostream &stream, const Scene &scene) const
+{
+    stream << "digraph RayTree" << std::endl << "{" << std::endl;
+    stream << "    node [shape=box, fontname=\"Courier\", fontsize=10];" << std::endl;
+
+    for(std::size_t i=0; i < _nodes.size(); ++i)
+    {
+        const Node &node = _nodes[i];
+
+        stream << "    ray" << i << " [label=\"#" << i << " " << RayTypeNames[node._type] << ", generation " << node._generation;
+        stream << "\\norigin ";         WriteLabelVector( stream, node._origin );
+        stream << "\\ndirection ";      WriteLabelVector( stream, node._direction );
+        stream << "\\nweight ";         WriteLabelVector( stream, node._weight );
+        stream << "\\n" << OutcomeNames[node._outcome];
+
+        if( node._pPrimitive )
+            stream << ": primitive " << scene.GetPrimitiveIndex( node._pPrimitive ) << " at " << node._distance;
+
+        if( node._outcome == Outcome_Surface )
+        {
+            stream << "\\nopacity " << node._opacity << ", " << node._numReflectedRays << " reflected ray(s)";
+            stream << "\\nreflection scale " << node._reflectionScale << ", transmission scale " << node._transmissionScale;
+        }
+
+        stream << "\\nillumination ";   WriteLabelVector( stream, node._illumination );
+        stream << "\"];" << std::endl;
+
+        if( node._parent >= 0 )
+            stream << "    ray" << node._parent << " -> ray" << i << ";" << std::endl;
+    }
+
+    stream << "}" << std::endl;
+}
+
+void RayTree::Clear()
+{
+    _nodes.clear();
+}
+
+const int RayTree::AddRay(const int &parent, const RayType &type, const Ray &ray, const Color &weight)
+{
+    Node node;
+    node._parent        = parent;
+    node._type          = type;
+    node._generation    = ray.Generation();
+    node._origin        = ray.Origin();
+    node._direction     = ray.Direction();
+    node._weight        = weight;
+
+    _nodes.push_back( node );
+    return (int)_nodes.size() - 1;
+}
+
+void RayTree::SetHit(const int &node, const Primitive *const pPrimitive, const float &distance)
+{
+    _nodes[node]._pPrimitive    = pPrimitive;
+    _nodes[node]._distance      = distance;
+}
+
+void RayTree::SetBranches(const int &node, const int &numReflectedRays, const float &reflectionScale, const float &transmissionScale, const float &opacity)
+{
+    _nodes[node]._numReflectedRays  = numReflectedRays;
+    _nodes[node]._reflectionScale   = reflectionScale;
+    _nodes[node]._transmissionScale = transmissionScale;
+    _nodes[node]._opacity           = opacity;
+}
+
+void RayTree::SetResult(const int &node, const Outcome &outcome, const Color &illumination)
+{
+    _nodes[node]._outcome       = outcome;
+    _nodes[node]._illumination  = illumination;
+}
+
+const bool RayTree::Save(const std::string &fileName, const Scene &scene) const
+{
+    std::ofstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open ray tree file: " << fileName << std::endl;
+        return false;
+    }
+
+    const std::string fileNameExt = fileName.substr( fileName.find_last_of( '.' ) + 1 );
+    if( (Utility::String::CaseInsensitiveCompare( fileNameExt, "dot" ) == 0) ||
+        (Utility::String::CaseInsensitiveCompare( fileNameExt, "gv" ) == 0) )
+        WriteGraphviz( stream, scene );
+    else
+        WriteJson( stream, scene );
+
+    if( stream.fail() )
+    {
+        std::cout << "Error: Failed while writing ray tree file: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,121 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RAYTREE_HEADER
+#define RAYTREE_HEADER
+
+#include "Color.h"
+#include "Vector.h"
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Forward Declarations
+class Ray;
+class Scene;
+class Primitive;
+
+// Records every ray traced by the Integrator (see Integrator::SetRayTree()), along with what
+// became of it, to see where the rays of a pixel go.
+// Note: Shadow rays are only recorded if they're ray traced (see RayTracer::_bRayTraceShadows);
+//       otherwise they're merely tested for occlusion, without going through the Integrator.
+class RayTree
+{
+// Types
+public:
+    enum RayType
+    {
+        RayType_Primary,
+        RayType_Reflected,
+        RayType_Transmitted,
+        RayType_Shadow
+    };
+
+    enum Outcome
+    {
+        Outcome_Pending,        // Still being traced
+        Outcome_MaxDepth,       // Terminated; too many generations
+        Outcome_Throughput,     // Terminated; contributed too little to the pixel (or lost the Russian roulette)
+        Outcome_RayBudget,      // Terminated; the pixel's ray budget ran out
+        Outcome_Miss,           // Didn't hit anything
+        Outcome_Light,          // Hit a light source
+        Outcome_Surface         // Hit a surface, which was shaded
+    };
+
+private:
+    struct Node
+    {
+        int                 _parent;        // Index of the node of the ray which spawned it; -1 for primary rays
+        RayType             _type;
+        int                 _generation;
+        Vector<float>       _origin;
+        Vector<float>       _direction;
+        Color               _weight;        // How much the ray's illumination contributes to the pixel
+
+        Outcome             _outcome;
+        const Primitive    *_pPrimitive;    // Primitive which was hit
+        float               _distance;
+        Color               _illumination;  // Illumination through the ray
+
+        // The branches followed from the surface
+        int                 _numReflectedRays;
+        float               _reflectionScale;   // 0 if the reflected rays weren't followed (see Integrator::SelectBranch())
+        float               _transmissionScale; // 0 if the transmitted ray wasn't followed; or if the surface is opaque
+        float               _opacity;
+
+        explicit Node();
+    };
+
+    typedef std::vector<Node> NodeArray;
+
+// Members
+private:
+    NodeArray   _nodes;
+
+public:
+// Constructor
+    explicit RayTree();
+// Destructor
+    ~RayTree();
+
+private:
+// Copy Constructor / Assignment Operator
+    RayTree(const RayTree &);
+    const RayTree &operator =(const RayTree &);
+
+// Functions
+private:
+    void WriteJson(std::ostream &stream, const Scene &scene) const;
+    void WriteGraphviz(std::ostream &stream, const Scene &scene) const;
+
+public:
+    void Clear();
+
+    // Adds a ray and returns its node
+    const int AddRay(const int &parent, const RayType &type, const Ray &ray, const Color &weight);
+
+    void SetHit(const int &node, const Primitive *const pPrimitive, const float &distance);
+    void SetBranches(const int &node, const int &numReflectedRays, const float &reflectionScale, const float &transmissionScale, const float &opacity);
+    void SetResult(const int &node, const Outcome &outcome, const Color &illumination);
+
+    // Saves the tree as JSON, or as a Graphviz graph if the file name ends with .dot or .gv
+    const bool Save(const std::string &fileName, const Scene &scene) const;
+};
+
+#endif
@@ -0,0 +1,200 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "RenderOrder.h"
+#include "Maths.h"
+
+namespace
+{
+    // Returns the smallest power of 2 which is >= val.
+    const int CeilPowerOf2(const int &val)
+    {
+        int power = 1;
+        while( power < val )
+            power *= 2;
+
+        return power;
+    }
+
+    // Gets the point at the specified index along the Morton (Z-order) curve,
+    // by de-interleaving the bits of the index.
+    void MortonPoint(const unsigned int &index, int &x, int &y)
+    {
+        x = y = 0;
+        for(int bit=0; bit < 16; ++bit)
+        {
+            x |= ((index >> (2 * bit    )) & 1) << bit;
+            y |= ((index >> (2 * bit + 1)) & 1) << bit;
+        }
+    }
+
+    // Gets the point at the specified index along the Hilbert curve filling a side x side square.
+    void HilbertPoint(const int &side, const int &index, int &x, int &y)
+    {
+        x = y = 0;
+
+        int t = index;
+        for(int s=1; s < side; s *= 2)
+        {
+            const int rx = 1 & (t / 2);
+            const int ry = 1 & (t ^ rx);
+
+            // Rotate the quadrant
+            if( ry == 0 )
+            {
+                if( rx == 1 )
+                {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+
+                const int temp = x;
+                x = y;
+                y = temp;
+            }
+
+            x += s * rx;
+            y += s * ry;
+            t /= 4;
+        }
+    }
+}
+
+// Constructor
+RenderOrder::RenderOrder() :
+    _pixels(),
+    _tiles()
+{
+}
+
+// Destructor
+RenderOrder::~RenderOrder()
+{
+}
+
+// Functions
+void RenderOrder::GetGridOrder(const RenderSettings::Order &order, const int &width, const int &height, PointArray &points)
+{
+    points.clear();
+    points.reserve( width * height );
+
+    if( order == RenderSettings::Order_Scanline )
+    {
+        for(int y=0; y < height; ++y)
+        {
+            for(int x=0; x < width; ++x)
+            {
+                const Point point = { x, y };
+                points.push_back( point );
+            }
+        }
+
+        return;
+    }
+
+    // Walk the curve through the smallest power of 2 square covering the grid, skipping the points outside it
+    const int side = CeilPowerOf2( Maths::Max( width, height ) );
+    for(int index=0; index < side * side; ++index)
+    {
+        Point point;
+        if( order == RenderSettings::Order_Morton )
+            MortonPoint( index, point.x, point.y );
+        else
+            HilbertPoint( side, index, point.x, point.y );
+
+        if( (point.x < width) && (point.y < height) )
+            points.push_back( point );
+    }
+}
+
+const bool RenderOrder::Create(const int &windowX, const int &windowY, const int &windowWidth, const int &windowHeight,
+    const int &tileSize, const RenderSettings::Order &tileOrder, const RenderSettings::Order &pixelOrder)
+{
+    _pixels.clear();
+    _tiles.clear();
+
+    if( (windowWidth < 1) || (windowHeight < 1) || (tileSize < 0) )
+        return false;
+
+    const int tileWidth  = (tileSize > 0)? tileSize: windowWidth;
+    const int tileHeight = (tileSize > 0)? tileSize: windowHeight;
+
+    PointArray tiles;
+    GetGridOrder( tileOrder, (windowWidth + tileWidth - 1) / tileWidth, (windowHeight + tileHeight - 1) / tileHeight, tiles );
+
+    PointArray tilePixels;
+    GetGridOrder( pixelOrder, tileWidth, tileHeight, tilePixels );
+
+    _pixels.reserve( windowWidth * windowHeight );
+    _tiles.reserve( tiles.size() );
+    for(std::size_t i=0; i < tiles.size(); ++i)
+    {
+        Tile tile;
+        tile._x             = windowX + tiles[i].x * tileWidth;
+        tile._y             = windowY + tiles[i].y * tileHeight;
+        tile._width         = Maths::Min( tileWidth,  windowWidth  - tiles[i].x * tileWidth  );
+        tile._height        = Maths::Min( tileHeight, windowHeight - tiles[i].y * tileHeight );
+        tile._firstPixel    = (int)_pixels.size();
+        _tiles.push_back( tile );
+
+        for(std::size_t j=0; j < tilePixels.size(); ++j)
+        {
+            const int x = tiles[i].x * tileWidth  + tilePixels[j].x;
+            const int y = tiles[i].y * tileHeight + tilePixels[j].y;
+
+            // Skip the pixels of the tiles at the edges which lie beyond the window
+            if( (x >= windowWidth) || (y >= windowHeight) )
+                continue;
+
+            const Point pixel = { windowX + x, windowY + y };
+            _pixels.push_back( pixel );
+        }
+    }
+
+    return true;
+}
+
+const int RenderOrder::NumPixels() const
+{
+    return (int)_pixels.size();
+}
+
+void RenderOrder::GetPixel(const int &index, int &x, int &y) const
+{
+    x = _pixels[index].x;
+    y = _pixels[index].y;
+}
+
+const int RenderOrder::NumTiles() const
+{
+    return (int)_tiles.size();
+}
+
+void RenderOrder::GetTile(const int &index, int &x, int &y, int &width, int &height, int &firstPixel, int &lastPixel) const
+{
+    const Tile &tile = _tiles[index];
+    x       = tile._x;
+    y       = tile._y;
+    width   = tile._width;
+    height  = tile._height;
+
+    firstPixel  = tile._firstPixel;
+    lastPixel   = (index + 1 < (int)_tiles.size())? _tiles[index + 1]._firstPixel: (int)_pixels.size();
+}
@@ -0,0 +1,84 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef RENDERORDER_HEADER
+#define RENDERORDER_HEADER
+
+#include "RenderSettings.h"
+#include <vector>
+
+// The order in which the pixels of a window of an image are rendered.
+// The window is split into square tiles which are visited in one order, and the pixels of each tile
+// are visited in another. Morton and Hilbert orders keep consecutive pixels close to each other, so
+// the rays traced for them tend to find what they need in the caches.
+class RenderOrder
+{
+// Types
+private:
+    struct Point
+    {
+        int x, y;
+    };
+
+    typedef std::vector<Point>  PointArray;
+
+    struct Tile
+    {
+        int _x, _y, _width, _height;    // Clipped to the window
+        int _firstPixel;                // Index of the tile's first pixel; its pixels are consecutive
+    };
+
+    typedef std::vector<Tile>   TileArray;
+
+// Members
+private:
+    PointArray  _pixels;
+    TileArray   _tiles;
+
+public:
+// Constructor
+    explicit RenderOrder();
+// Destructor
+    ~RenderOrder();
+
+private:
+// Copy Constructor / Assignment Operator
+    RenderOrder(const RenderOrder &);
+    const RenderOrder &operator =(const RenderOrder &);
+
+// Functions
+private:
+    // Gets all the points of a width x height grid, in the specified order.
+    static void GetGridOrder(const RenderSettings::Order &order, const int &width, const int &height, PointArray &points);
+
+public:
+    // A tileSize of 0 makes the whole window a single tile.
+    const bool Create(const int &windowX, const int &windowY, const int &windowWidth, const int &windowHeight,
+        const int &tileSize, const RenderSettings::Order &tileOrder, const RenderSettings::Order &pixelOrder);
+
+    const int NumPixels() const;
+    void GetPixel(const int &index, int &x, int &y) const;
+
+    const int NumTiles() const;
+    // Gets the tile's rectangle, and the range of indices of its pixels (lastPixel being one beyond its last).
+    void GetTile(const int &index, int &x, int &y, int &width, int &height, int &firstPixel, int &lastPixel) const;
+};
+
+#endif
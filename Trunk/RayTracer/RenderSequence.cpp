@@ -0,0 +1,276 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "RenderSequence.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "Image.h"
+#include "Primitive.h"
+#include "Light.h"
+#include "Utility.h"
+#include "Trace.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#ifndef _MSVC
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+// Constructor
+RenderSequence::RenderSequence() :
+    _frames(),
+    _lightOffsets(),
+    _primitiveOffsets(),
+    _saveProcess( 0 ),
+    _bSaveFailed( false )
+{
+}
+
+// Destructor
+RenderSequence::~RenderSequence()
+{
+    FinishSaving();
+}
+
+// Functions
+const bool RenderSequence::ParseFrame(const std::string &line, const Camera &camera, const float &aspectRatio, Frame &frame)
+{
+    using Utility::String::CaseInsensitiveCompare;
+    using Utility::String::FromString;
+
+    frame._camera = camera;
+    frame._imageFileName.clear();
+
+    std::istringstream stream( line );
+    std::string argument;
+    while( stream >> argument )
+    {
+        std::string name, value;
+        if( !RenderSettings::SplitArgument( argument, name, value ) )
+        {
+            if( !frame._imageFileName.empty() )
+                return false;
+
+            frame._imageFileName = argument;
+            continue;
+        }
+
+        std::vector<float> values;
+        if( !FromString( values, value ) )
+            return false;
+
+        if( (CaseInsensitiveCompare( name, "camera" ) == 0) && (values.size() == 3) )
+        {
+            frame._camera._position.Set( values[0], values[1], values[2] );
+        }
+        else if( (CaseInsensitiveCompare( name, "fov" ) == 0) && (values.size() == 1) && (values[0] > 0) && (values[0] < 180) )
+        {
+            frame._camera._hFov = values[0] * aspectRatio;
+            frame._camera._vFov = values[0];
+        }
+        else if( ((CaseInsensitiveCompare( name, "moveLight" ) == 0) || (CaseInsensitiveCompare( name, "movePrimitive" ) == 0)) &&
+            (values.size() == 4) && (values[0] >= 0) && (values[0] == (int)values[0]) )
+        {
+            OffsetMap &offsets = (CaseInsensitiveCompare( name, "moveLight" ) == 0)? frame._lightOffsets: frame._primitiveOffsets;
+            // The last offset given for an object is the one used
+            const int index = (int)values[0];
+            offsets.erase( index );
+            offsets.insert( std::make_pair( index, Vector<float>( values[1], values[2], values[3] ) ) );
+        }
+        else
+            return false;
+    }
+
+    return !frame._imageFileName.empty();
+}
+
+const bool RenderSequence::MoveObjects(Scene &scene, const bool &bLights, const OffsetMap &frameOffsets, OffsetMap &offsets)
+{
+    bool bMoved = false;
+
+    // Everything the frame moves, and everything moved before, which the frame puts back where it was
+    OffsetMap targetOffsets( frameOffsets );
+    for(OffsetMap::const_iterator itr = offsets.begin(); itr != offsets.end(); ++itr)
+        targetOffsets.insert( std::make_pair( itr->first, Vector<float>( 0 ) ) );
+
+    for(OffsetMap::const_iterator itr = targetOffsets.begin(); itr != targetOffsets.end(); ++itr)
+    {
+        // Vectors aren't initialized by default
+        Vector<float> &offset = offsets.insert( std::make_pair( itr->first, Vector<float>( 0 ) ) ).first->second;
+        if( offset == itr->second )
+            continue;
+
+        if( bLights )
+            scene.GetLight( itr->first )->Translate( itr->second - offset );
+        else
+            scene.GetPrimitive( itr->first )->Translate( itr->second - offset );
+
+        offset = itr->second;
+        bMoved = true;
+    }
+
+    return bMoved && bLights;
+}
+
+void RenderSequence::SaveFrame(const Image &image, const std::string &imageFileName)
+{
+    FinishSaving();
+
+#ifndef _MSVC
+    // The child process saves its own copy of the image, while we go on to render the next frame
+    std::cout.flush();
+    const pid_t pid = fork();
+    if( pid == 0 )
+    {
+        const bool bResult = image.Save( imageFileName );
+        if( !bResult )
+            std::cout << "Error: Failed while saving image to file: " << imageFileName << std::endl;
+
+        // Leave without destroying anything; it all still belongs to the parent
+        std::cout.flush();
+        _exit( bResult? 0: 1 );
+    }
+
+    if( pid > 0 )
+    {
+        _saveProcess = pid;
+        return;
+    }
+#endif
+
+    // Save it ourselves
+    if( !image.Save( imageFileName ) )
+    {
+        std::cout << "Error: Failed while saving image to file: " << imageFileName << std::endl;
+        _bSaveFailed = true;
+    }
+}
+
+void RenderSequence::FinishSaving()
+{
+#ifndef _MSVC
+    if( _saveProcess == 0 )
+        return;
+
+    int status;
+    if( (waitpid( _saveProcess, &status, 0 ) != _saveProcess) || !WIFEXITED( status ) || (WEXITSTATUS( status ) != 0) )
+        _bSaveFailed = true;
+
+    _saveProcess = 0;
+#endif
+}
+
+const bool RenderSequence::Load(const std::string &fileName, const Camera &camera, const float &aspectRatio)
+{
+    _frames.clear();
+
+    std::ifstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        std::cout << "Error: Failed to open frames file: " << fileName << std::endl;
+        return false;
+    }
+
+    std::string line;
+    for(int lineNumber = 1; std::getline( stream, line ); ++lineNumber)
+    {
+        Utility::String::TrimWhiteSpaces( line );
+        if( line.empty() )
+            continue;
+
+        Frame frame;
+        if( !ParseFrame( line, camera, aspectRatio, frame ) )
+        {
+            std::cout << "Error: Invalid frame in line " << lineNumber << " of file: " << fileName << std::endl;
+            return false;
+        }
+
+        _frames.push_back( frame );
+    }
+
+    if( _frames.empty() )
+    {
+        std::cout << "Error: No frames in file: " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const bool RenderSequence::Render(const RayTracer &rayTracer, Scene &scene, Image &image)
+{
+    if( rayTracer._settings._bProgressive || !rayTracer._settings._checkpointFileName.empty() )
+    {
+        std::cout << "Error: Progressive and checkpointed renders can't be rendered as sequences" << std::endl;
+        return false;
+    }
+
+    // Check that the Lights and Primitives moved exist before rendering anything
+    for(std::size_t i=0; i < _frames.size(); ++i)
+    {
+        const Frame &frame = _frames[i];
+
+        for(OffsetMap::const_iterator itr = frame._lightOffsets.begin(); itr != frame._lightOffsets.end(); ++itr)
+        {
+            if( !scene.GetLight( itr->first ) )
+            {
+                std::cout << "Error: The Scene has no Light " << itr->first << " to move in frame: " << frame._imageFileName << std::endl;
+                return false;
+            }
+        }
+
+        for(OffsetMap::const_iterator itr = frame._primitiveOffsets.begin(); itr != frame._primitiveOffsets.end(); ++itr)
+        {
+            if( !scene.GetPrimitive( itr->first ) )
+            {
+                std::cout << "Error: The Scene has no Primitive " << itr->first << " to move in frame: " << frame._imageFileName << std::endl;
+                return false;
+            }
+        }
+    }
+
+    _bSaveFailed = false;
+    for(std::size_t i=0; i < _frames.size(); ++i)
+    {
+        const Frame &frame = _frames[i];
+        const Trace::Scope traceScope( "Render frame", frame._imageFileName );
+
+        MoveObjects( scene, false, frame._primitiveOffsets, _primitiveOffsets );
+        if( MoveObjects( scene, true, frame._lightOffsets, _lightOffsets ) )
+            scene.RefitLightTree();
+
+        if( !rayTracer.Render( frame._camera, scene, image ) )
+        {
+            FinishSaving();
+            return false;
+        }
+
+        SaveFrame( image, frame._imageFileName );
+
+        // Display a mark for each frame rendered
+        std::cout << "|";
+    }
+
+    FinishSaving();
+    return !_bSaveFailed;
+}
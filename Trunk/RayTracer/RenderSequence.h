@@ -0,0 +1,97 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef RENDERSEQUENCE_HEADER
+#define RENDERSEQUENCE_HEADER
+
+#include "Camera.h"
+#include <string>
+#include <vector>
+#include <map>
+
+// Forward Declarations
+class RayTracer;
+class Scene;
+class Image;
+
+// Renders a sequence of frames of a Scene (a turntable, for instance) which differ in the camera, or in
+// where some of the Lights and Primitives are; the Scene is loaded, and its LightTree built, only once.
+// Each frame is a line of a frames file:
+//     <output bitmap filename> [--camera:<x>,<y>,<z>] [--fov:<degrees>]
+//         [--moveLight:<index>,<x>,<y>,<z> ...] [--movePrimitive:<index>,<x>,<y>,<z> ...]
+// Lights and Primitives are numbered from 0, in the order they appear in the scene file, and are moved
+// by the offset from where they are in the scene file. Frames without a camera use the initial one.
+// Each frame is saved while the next one is rendered.
+class RenderSequence
+{
+// Types
+private:
+    typedef std::map<int, Vector<float> >   OffsetMap;  // Offsets of the Lights or Primitives, by index
+
+    struct Frame
+    {
+        std::string     _imageFileName;
+        Camera          _camera;
+        OffsetMap       _lightOffsets;
+        OffsetMap       _primitiveOffsets;
+    };
+
+    typedef std::vector<Frame>  FrameArray;
+
+// Members
+private:
+    FrameArray  _frames;
+    OffsetMap   _lightOffsets;      // How far the Lights and Primitives have been moved so far
+    OffsetMap   _primitiveOffsets;
+    int         _saveProcess;       // Process saving the previous frame; 0 if there's none
+    bool        _bSaveFailed;
+
+public:
+// Constructor
+    explicit RenderSequence();
+// Destructor
+    ~RenderSequence();
+
+private:
+// Copy Constructor / Assignment Operator
+    RenderSequence(const RenderSequence &);
+    const RenderSequence &operator =(const RenderSequence &);
+
+// Functions
+private:
+    static const bool ParseFrame(const std::string &line, const Camera &camera, const float &aspectRatio, Frame &frame);
+
+    // Moves the Lights and Primitives from where they are to where the frame has them.
+    // Returns true if any Light was moved.
+    static const bool MoveObjects(Scene &scene, const bool &bLights, const OffsetMap &frameOffsets, OffsetMap &offsets);
+
+    // Starts saving the image; waits for the previous frame to be saved first.
+    void SaveFrame(const Image &image, const std::string &imageFileName);
+    void FinishSaving();
+
+public:
+    // Reads the frames from the file. The camera is that of the frames which don't specify one.
+    const bool Load(const std::string &fileName, const Camera &camera, const float &aspectRatio);
+
+    // Renders and saves all the frames, into images of the size of the image.
+    const bool Render(const RayTracer &rayTracer, Scene &scene, Image &image);
+};
+
+#endif
@@ -0,0 +1,453 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "RenderServer.h"
+#include "RayTracer.h"
+#include "Scene.h"
+#include "Image.h"
+#include "Deserializer.h"
+#include "SafeDelete.h"
+#include "Utility.h"
+#include "Timer.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdlib.h>
+
+#ifndef _MSVC
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    // Returns the message of the last error in the text displayed by a failed operation.
+    const std::string LastError(const std::string &output, const std::string &defaultError)
+    {
+        const std::size_t start = output.rfind( "Error: " );
+        if( start == std::string::npos )
+            return defaultError;
+
+        std::string error = output.substr( start + 7, output.find( '\n', start ) - (start + 7) );
+        Utility::String::TrimWhiteSpaces( error );
+        return error;
+    }
+}
+
+// Client's Constructor
+RenderServer::Client::Client() :
+    _socket(),
+    _input()
+{
+}
+
+// Constructor
+RenderServer::RenderServer() :
+    _settings(),
+    _maxJobs( 1 ),
+    _maxScenes( 8 ),
+    _scenes(),
+    _clients(),
+    _queue(),
+    _numJobs( 0 ),
+    _numRunning( 0 ),
+    _bQuit( false )
+{
+}
+
+// Destructor
+RenderServer::~RenderServer()
+{
+    for(SceneCache::iterator itr = _scenes.begin(); itr != _scenes.end(); ++itr)
+        SafeDeleteScalar( itr->second._pScene );
+    _scenes.clear();
+
+    for(std::size_t i=0; i < _clients.size(); ++i)
+        SafeDeleteScalar( _clients[i] );
+    _clients.clear();
+}
+
+// Functions
+const bool RenderServer::ParseJob(const std::string &line, JobParameters &parameters, std::string &error) const
+{
+    using Utility::String::CaseInsensitiveCompare;
+    using Utility::String::FromString;
+
+    parameters._settings = _settings;
+    parameters._camera._position.Set( 0, 0, 0 );
+    float vFov = 45;
+
+    // Separate the settings (--<setting>:<value>) from the rest of the arguments, as on the command line
+    std::vector<std::string> arguments;
+    std::istringstream stream( line );
+    std::string argument;
+    while( stream >> argument )
+    {
+        std::string name, value;
+        if( !RenderSettings::SplitArgument( argument, name, value ) )
+        {
+            arguments.push_back( argument );
+            continue;
+        }
+
+        bool bValid;
+        if( CaseInsensitiveCompare( name, "camera" ) == 0 )
+        {
+            // Given as x,y,z
+            std::vector<float> position;
+            bValid = FromString( position, value ) && (position.size() == 3);
+            if( bValid )
+                parameters._camera._position.Set( position[0], position[1], position[2] );
+        }
+        else if( CaseInsensitiveCompare( name, "fov" ) == 0 )
+            bValid = FromString( vFov, value ) && (vFov > 0) && (vFov < 180);
+        else
+            bValid = parameters._settings.Set( name, value );
+
+        if( !bValid )
+        {
+            error = "Invalid render setting: " + argument;
+            return false;
+        }
+    }
+
+    if( (arguments.size() < 2) || (arguments.size() > 4) )
+    {
+        error = "Expected: <scene filename> <output bitmap filename> [width] [height] [--<setting>:<value> ...]";
+        return false;
+    }
+
+    parameters._sceneFileName = arguments[0];
+    parameters._imageFileName = arguments[1];
+
+    parameters._width = parameters._height = 500;
+    if( (arguments.size() > 2) && (!FromString( parameters._width, arguments[2] ) || (parameters._width < 1)) )
+    {
+        error = "Invalid integer specified for width: " + arguments[2];
+        return false;
+    }
+
+    if( (arguments.size() > 3) && (!FromString( parameters._height, arguments[3] ) || (parameters._height < 1)) )
+    {
+        error = "Invalid integer specified for height: " + arguments[3];
+        return false;
+    }
+
+    parameters._camera._hFov = vFov * (parameters._width / (float)parameters._height);
+    parameters._camera._vFov = vFov;
+    return true;
+}
+
+Scene *const RenderServer::GetScene(const std::string &fileName, const int &jobNumber, CrcCalculator::CrcType &crc, std::string &error)
+{
+    std::ifstream stream( fileName.c_str() );
+    if( !stream.is_open() )
+    {
+        error = "Failed to open input scene file: " + fileName;
+        return 0;
+    }
+
+    const std::string sceneText( (std::istreambuf_iterator<char>( stream )), std::istreambuf_iterator<char>() );
+    crc = Utility::String::CalculateCrc( sceneText );
+
+    SceneCache::iterator itr = _scenes.find( crc );
+    if( itr != _scenes.end() )
+    {
+        itr->second._lastUsed = jobNumber;
+        return itr->second._pScene;
+    }
+
+    // Make room for it by unloading the scene which was used the longest time ago
+    if( !_scenes.empty() && ((int)_scenes.size() >= _maxScenes) )
+    {
+        SceneCache::iterator leastRecent = _scenes.begin();
+        for(itr = _scenes.begin(); itr != _scenes.end(); ++itr)
+        {
+            if( itr->second._lastUsed < leastRecent->second._lastUsed )
+                leastRecent = itr;
+        }
+
+        SafeDeleteScalar( leastRecent->second._pScene );
+        _scenes.erase( leastRecent );
+    }
+
+    // The messages displayed while loading would garble the answers, so they're kept aside
+    std::ostringstream output;
+    std::streambuf *const pOutputBuffer = std::cout.rdbuf( output.rdbuf() );
+
+    // Loading some scenes draws random numbers (for the placement of area light samples, for instance);
+    // start from the same random sequence as a render from the command line does.
+    srand( 1 );
+
+    std::istringstream sceneStream( sceneText );
+    Deserializer d;
+    Scene *pScene = 0;
+    if( d.Open( sceneStream ) )
+        pScene = d.Deserialize<Scene>( 0 );
+
+    std::cout.rdbuf( pOutputBuffer );
+
+    if( !pScene )
+    {
+        error = LastError( output.str(), "Failed to load Scene from file: " + fileName );
+        return 0;
+    }
+
+    CachedScene &cachedScene = _scenes[crc];
+    cachedScene._pScene     = pScene;
+    cachedScene._lastUsed   = jobNumber;
+    return pScene;
+}
+
+const std::string RenderServer::RenderJob(const Job &job, const JobParameters &parameters, const Scene &scene) const
+{
+    const Timer timer;
+
+    // The progress (and errors) displayed while rendering would garble the answers, so they're kept aside
+    std::ostringstream output;
+    std::streambuf *const pOutputBuffer = std::cout.rdbuf( output.rdbuf() );
+
+    // Every job starts from the same random sequence, so that it renders the same image
+    // no matter which jobs came before it
+    srand( 1 );
+
+    RayTracer rayTracer;
+    rayTracer._settings = parameters._settings;
+    rayTracer._sceneCrc = parameters._sceneCrc;
+
+    Image image;
+    const bool bResult =
+        image.Create( parameters._width, parameters._height ) &&
+        (rayTracer._settings._bProgressive?
+            rayTracer.RenderProgressive( parameters._camera, scene, image, parameters._imageFileName ):
+            rayTracer.Render( parameters._camera, scene, image )) &&
+        image.Save( parameters._imageFileName );
+
+    std::cout.rdbuf( pOutputBuffer );
+
+    const std::string jobNumber = Utility::String::ToString( job._number );
+    if( !bResult )
+        return "Error " + jobNumber + " " + LastError( output.str(), "Failed to render: " + parameters._imageFileName );
+
+    return "Done " + jobNumber + " " + parameters._imageFileName + " " + Utility::String::ToString( timer.ElapsedTime() );
+}
+
+void RenderServer::Answer(Client *const pClient, const std::string &answer)
+{
+    if( !pClient )
+    {
+        std::cout << answer << std::endl;
+        return;
+    }
+
+    // If the client has gone away, it doesn't need the answer
+    const std::string line = answer + "\n";
+    pClient->_socket.Send( line.data(), line.size() );
+}
+
+void RenderServer::AddInput(const std::string &line, Client *const pClient)
+{
+    std::string job( line );
+    Utility::String::TrimWhiteSpaces( job );
+
+    if( job.empty() )
+        return;
+
+    if( Utility::String::CaseInsensitiveCompare( job, "quit" ) == 0 )
+    {
+        _bQuit = true;
+        return;
+    }
+
+    Job queuedJob;
+    queuedJob._number   = ++_numJobs;
+    queuedJob._line     = job;
+    queuedJob._pClient  = pClient;
+    _queue.push_back( queuedJob );
+}
+
+void RenderServer::StartJob(const Job &job)
+{
+    JobParameters parameters;
+    std::string error;
+    Scene *pScene = 0;
+    if( !ParseJob( job._line, parameters, error ) ||
+        ((pScene = GetScene( parameters._sceneFileName, job._number, parameters._sceneCrc, error )) == 0) )
+    {
+        Answer( job._pClient, "Error " + Utility::String::ToString( job._number ) + " " + error );
+        return;
+    }
+
+#ifndef _MSVC
+    // The child process gets its own copy of everything loaded so far, including the scene.
+    // Anything buffered for the standard output is written first, so that it isn't written twice.
+    std::cout.flush();
+    const pid_t pid = fork();
+    if( pid == 0 )
+    {
+        Answer( job._pClient, RenderJob( job, parameters, *pScene ) );
+        std::cout.flush();
+
+        // Leave without destroying anything; it all still belongs to the server (including its socket)
+        _exit( 0 );
+    }
+
+    if( pid > 0 )
+    {
+        ++_numRunning;
+        return;
+    }
+#endif
+
+    // Render it ourselves
+    Answer( job._pClient, RenderJob( job, parameters, *pScene ) );
+}
+
+void RenderServer::StartQueuedJobs()
+{
+    while( !_queue.empty() && (_numRunning < _maxJobs) )
+    {
+        const Job job = _queue.front();
+        _queue.pop_front();
+
+        StartJob( job );
+    }
+}
+
+void RenderServer::CollectJobs(const bool &bBlock)
+{
+#ifndef _MSVC
+    bool bWait = bBlock;
+    while( _numRunning > 0 )
+    {
+        int status;
+        if( waitpid( -1, &status, bWait? 0: WNOHANG ) <= 0 )
+            break;
+
+        --_numRunning;
+        bWait = false;
+    }
+#endif
+}
+
+const bool RenderServer::Run()
+{
+    std::string line;
+    while( !_bQuit && std::getline( std::cin, line ) )
+    {
+        AddInput( line, 0 );
+
+        // Don't read any further until there's room to start the job
+        CollectJobs( false );
+        while( !_queue.empty() && (_numRunning >= _maxJobs) )
+            CollectJobs( true );
+
+        StartQueuedJobs();
+    }
+
+    while( _numRunning > 0 )
+        CollectJobs( true );
+
+    return true;
+}
+
+const bool RenderServer::Run(const std::string &address)
+{
+    Socket listener;
+    if( !listener.Listen( address ) )
+        return false;
+
+    std::cout << "Waiting for jobs on: " << address << std::endl;
+
+    std::vector<char> buffer( 4096 );
+    while( !_bQuit || !_queue.empty() || (_numRunning > 0) )
+    {
+        Socket::SocketArray sockets( 1, &listener );
+        for(std::size_t i=0; i < _clients.size(); ++i)
+            sockets.push_back( &_clients[i]->_socket );
+
+        // Check on the jobs being rendered every so often
+        Socket::BoolArray bReadable;
+        if( !Socket::WaitForData( sockets, bReadable, (_numRunning > 0)? 0.1: -1 ) )
+            return false;
+
+        // Queue the jobs in the lines received
+        for(std::size_t i=0; i < _clients.size(); ++i)
+        {
+            if( !bReadable[i + 1] )
+                continue;
+
+            Client &client = *_clients[i];
+
+            std::size_t received;
+            if( !client._socket.ReceiveSome( &buffer[0], buffer.size(), received ) )
+            {
+                client._socket.Close();
+                continue;
+            }
+
+            client._input.append( &buffer[0], received );
+
+            std::size_t lineEnd;
+            while( (lineEnd = client._input.find( '\n' )) != std::string::npos )
+            {
+                AddInput( client._input.substr( 0, lineEnd ), &client );
+                client._input.erase( 0, lineEnd + 1 );
+            }
+        }
+
+        if( bReadable[0] )
+        {
+            Client *pClient = new Client;
+            if( listener.Accept( pClient->_socket ) )
+                _clients.push_back( pClient );
+            else
+                SafeDeleteScalar( pClient );
+        }
+
+        // Drop the clients which have gone away, along with their queued jobs
+        for(std::size_t i=0; i < _clients.size(); )
+        {
+            if( _clients[i]->_socket.IsOpen() )
+            {
+                ++i;
+                continue;
+            }
+
+            for(JobQueue::iterator itr = _queue.begin(); itr != _queue.end(); )
+            {
+                if( itr->_pClient == _clients[i] )
+                    itr = _queue.erase( itr );
+                else
+                    ++itr;
+            }
+
+            SafeDeleteScalar( _clients[i] );
+            _clients.erase( _clients.begin() + i );
+        }
+
+        CollectJobs( false );
+        StartQueuedJobs();
+    }
+
+    return true;
+}
@@ -0,0 +1,151 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef RENDERSERVER_HEADER
+#define RENDERSERVER_HEADER
+
+#include "Socket.h"
+#include "Camera.h"
+#include "RenderSettings.h"
+#include "CrcCalculator.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+// Forward Declarations
+class Scene;
+
+// Renders jobs as they come in, keeping the scenes they use (along with their textures) loaded
+// in between, so that rendering many views of a scene only loads it once.
+// Each job is a line of text:
+//     <scene filename> <output bitmap filename> [width] [height] [--<setting>:<value> ...]
+// as on the command line, with the additional settings --camera:<x>,<y>,<z> and --fov:<degrees>
+// (the vertical field of view). A line reading "quit" stops the server once the jobs received
+// so far are done.
+// Every job is answered with a line; "Done <job no.> <output filename> <seconds>", or
+// "Error <job no.> <message>".
+// Jobs are rendered in child processes (which share the loaded scenes with the server), up to
+// _maxJobs at a time; the rest wait in a queue. Where processes can't be forked, jobs are rendered
+// one at a time by the server itself.
+class RenderServer
+{
+// Types
+private:
+    struct CachedScene
+    {
+        Scene  *_pScene;
+        int     _lastUsed;  // No. of the last job which used the scene
+    };
+
+    // Scenes are keyed by the CRC of their scene file's contents, so an edited file is loaded again
+    typedef std::map<CrcCalculator::CrcType, CachedScene>  SceneCache;
+
+    // A client connected to the server's socket
+    struct Client
+    {
+        Socket      _socket;
+        std::string _input;     // Text received which doesn't make up a whole line yet
+
+        explicit Client();
+    };
+
+    typedef std::vector<Client *>   ClientArray;
+
+    struct Job
+    {
+        int         _number;
+        std::string _line;
+        Client     *_pClient;   // Client to answer; 0 to answer on the standard output
+    };
+
+    typedef std::deque<Job> JobQueue;
+
+    // A job's parameters, parsed from its line
+    struct JobParameters
+    {
+        std::string             _sceneFileName;
+        std::string             _imageFileName;
+        int                     _width;
+        int                     _height;
+        Camera                  _camera;
+        RenderSettings          _settings;
+        CrcCalculator::CrcType  _sceneCrc;
+    };
+
+// Members
+public:
+    RenderSettings  _settings;      // Default settings of the jobs
+    int             _maxJobs;       // Maximum no. of jobs rendered at once
+    int             _maxScenes;     // Maximum no. of scenes kept loaded
+
+private:
+    SceneCache  _scenes;
+    ClientArray _clients;
+    JobQueue    _queue;
+    int         _numJobs;           // No. of jobs received so far
+    int         _numRunning;        // No. of jobs being rendered by child processes
+    bool        _bQuit;
+
+public:
+// Constructor
+    explicit RenderServer();
+// Destructor
+    ~RenderServer();
+
+private:
+// Copy Constructor / Assignment Operator
+    RenderServer(const RenderServer &);
+    const RenderServer &operator =(const RenderServer &);
+
+// Functions
+private:
+    const bool ParseJob(const std::string &line, JobParameters &parameters, std::string &error) const;
+
+    // Returns the scene loaded from the file, loading it if it isn't already.
+    Scene *const GetScene(const std::string &fileName, const int &jobNumber, CrcCalculator::CrcType &crc, std::string &error);
+
+    // Renders the job, and returns its answer.
+    const std::string RenderJob(const Job &job, const JobParameters &parameters, const Scene &scene) const;
+
+    static void Answer(Client *const pClient, const std::string &answer);
+
+    // Queues a line of input as a job (or stops the server).
+    void AddInput(const std::string &line, Client *const pClient);
+
+    // Starts rendering the job, and answers it if it fails to start.
+    void StartJob(const Job &job);
+
+    // Starts as many of the queued jobs as we're allowed to.
+    void StartQueuedJobs();
+
+    // Waits for the child processes rendering jobs which are done.
+    // If bBlock is true, waits until at least one of them is done.
+    void CollectJobs(const bool &bBlock);
+
+public:
+    // Serves jobs read from the standard input, until it ends.
+    const bool Run();
+
+    // Serves jobs sent by clients connecting to the address (see Socket).
+    const bool Run(const std::string &address);
+};
+
+#endif
@@ -0,0 +1,262 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RenderSettings.h"
+#include "Utility.h"
+#include <sstream>
+
+namespace
+{
+    const bool ReadOrder(RenderSettings::Order &val, const std::string &str)
+    {
+        if( Utility::String::CaseInsensitiveCompare( str, "scanline" ) == 0 )
+            val = RenderSettings::Order_Scanline;
+        else if( Utility::String::CaseInsensitiveCompare( str, "morton" ) == 0 )
+            val = RenderSettings::Order_Morton;
+        else if( Utility::String::CaseInsensitiveCompare( str, "hilbert" ) == 0 )
+            val = RenderSettings::Order_Hilbert;
+        else
+            return false;
+
+        return true;
+    }
+}
+
+// Constructor
+RenderSettings::RenderSettings() :
+    _minThroughput( 0 ),
+    _bRussianRoulette( false ),
+    _maxRaysPerPixel( 0 ),
+    _bStochasticBranching( false ),
+    _samplesPerPixel( 1 ),
+    _filter( Filter_Box ),
+    _adaptiveThreshold( 0 ),
+    _maxSamplesPerPixel( 64 ),
+    _bProgressive( false ),
+    _timeLimit( 0 ),
+    _saveInterval( 0 ),
+    _tileSize( 0 ),
+    _tileOrder( Order_Scanline ),
+    _pixelOrder( Order_Scanline ),
+    _cropX( 0 ),
+    _cropY( 0 ),
+    _cropWidth( 0 ),
+    _cropHeight( 0 ),
+    _checkpointFileName(),
+    _checkpointInterval( 10 ),
+    _bResume( false ),
+    _statisticsFileName(),
+    _traceFileName(),
+    _heatmapCost( Cost_None ),
+    _memoryLimit( 0 )
+{
+}
+
+// Functions
+const bool RenderSettings::Set(const std::string &name, const std::string &value)
+{
+    using Utility::String::CaseInsensitiveCompare;
+    using Utility::String::FromString;
+
+    if( CaseInsensitiveCompare( name, "minThroughput" ) == 0 )
+        return FromString( _minThroughput, value ) && (_minThroughput >= 0);
+
+    if( CaseInsensitiveCompare( name, "russianRoulette" ) == 0 )
+        return ReadBool( _bRussianRoulette, value );
+
+    if( CaseInsensitiveCompare( name, "maxRaysPerPixel" ) == 0 )
+        return FromString( _maxRaysPerPixel, value ) && (_maxRaysPerPixel >= 0);
+
+    if( CaseInsensitiveCompare( name, "stochasticBranching" ) == 0 )
+        return ReadBool( _bStochasticBranching, value );
+
+    if( CaseInsensitiveCompare( name, "samplesPerPixel" ) == 0 )
+        return FromString( _samplesPerPixel, value ) && (_samplesPerPixel >= 1);
+
+    if( CaseInsensitiveCompare( name, "filter" ) == 0 )
+    {
+        if( CaseInsensitiveCompare( value, "box" ) == 0 )
+            _filter = Filter_Box;
+        else if( CaseInsensitiveCompare( value, "tent" ) == 0 )
+            _filter = Filter_Tent;
+        else if( CaseInsensitiveCompare( value, "gaussian" ) == 0 )
+            _filter = Filter_Gaussian;
+        else
+            return false;
+
+        return true;
+    }
+
+    if( CaseInsensitiveCompare( name, "adaptiveThreshold" ) == 0 )
+        return FromString( _adaptiveThreshold, value ) && (_adaptiveThreshold >= 0);
+
+    if( CaseInsensitiveCompare( name, "maxSamplesPerPixel" ) == 0 )
+        return FromString( _maxSamplesPerPixel, value ) && (_maxSamplesPerPixel >= 1);
+
+    if( CaseInsensitiveCompare( name, "progressive" ) == 0 )
+        return ReadBool( _bProgressive, value );
+
+    if( CaseInsensitiveCompare( name, "timeLimit" ) == 0 )
+        return FromString( _timeLimit, value ) && (_timeLimit >= 0);
+
+    if( CaseInsensitiveCompare( name, "saveInterval" ) == 0 )
+        return FromString( _saveInterval, value ) && (_saveInterval >= 0);
+
+    if( CaseInsensitiveCompare( name, "tileSize" ) == 0 )
+        return FromString( _tileSize, value ) && (_tileSize >= 0);
+
+    if( CaseInsensitiveCompare( name, "tileOrder" ) == 0 )
+        return ReadOrder( _tileOrder, value );
+
+    if( CaseInsensitiveCompare( name, "pixelOrder" ) == 0 )
+        return ReadOrder( _pixelOrder, value );
+
+    if( CaseInsensitiveCompare( name, "crop" ) == 0 )
+    {
+        // Given as x,y,width,height
+        std::string window( value );
+        for(std::size_t i=0; i < window.size(); ++i)
+        {
+            if( window[i] == ',' )
+                window[i] = ' ';
+        }
+
+        std::istringstream stream( window );
+        int x, y, width, height;
+        if( (stream >> x >> y >> width >> height).fail() || !(stream >> std::ws).eof() ||
+            (x < 0) || (y < 0) || (width < 1) || (height < 1) )
+            return false;
+
+        _cropX      = x;
+        _cropY      = y;
+        _cropWidth  = width;
+        _cropHeight = height;
+        return true;
+    }
+
+    if( CaseInsensitiveCompare( name, "checkpoint" ) == 0 )
+    {
+        _checkpointFileName = value;
+        return !value.empty();
+    }
+
+    if( CaseInsensitiveCompare( name, "checkpointInterval" ) == 0 )
+        return FromString( _checkpointInterval, value ) && (_checkpointInterval >= 0);
+
+    if( CaseInsensitiveCompare( name, "resume" ) == 0 )
+        return ReadBool( _bResume, value );
+
+    if( CaseInsensitiveCompare( name, "statistics" ) == 0 )
+    {
+        _statisticsFileName = value;
+        return !value.empty();
+    }
+
+    if( CaseInsensitiveCompare( name, "trace" ) == 0 )
+    {
+        _traceFileName = value;
+        return !value.empty();
+    }
+
+    if( CaseInsensitiveCompare( name, "heatmap" ) == 0 )
+    {
+        if( CaseInsensitiveCompare( value, "none" ) == 0 )
+            _heatmapCost = Cost_None;
+        else if( CaseInsensitiveCompare( value, "time" ) == 0 )
+            _heatmapCost = Cost_Time;
+        else if( CaseInsensitiveCompare( value, "rays" ) == 0 )
+            _heatmapCost = Cost_Rays;
+        else if( CaseInsensitiveCompare( value, "tests" ) == 0 )
+            _heatmapCost = Cost_PrimitiveTests;
+        else
+            return false;
+
+        return true;
+    }
+
+    if( CaseInsensitiveCompare( name, "memoryLimit" ) == 0 )
+        return FromString( _memoryLimit, value ) && (_memoryLimit >= 0);
+
+    // Insert support for additional settings just above this line.
+
+    return false;
+}
+
+void RenderSettings::SplitSetting(const std::string &setting, std::string &name, std::string &value)
+{
+    const std::size_t separator = setting.find( ':' );
+    name  = setting.substr( 0, separator );
+    value = (separator == std::string::npos)? "true": setting.substr( separator + 1 );
+}
+
+const bool RenderSettings::SplitArgument(const std::string &argument, std::string &name, std::string &value)
+{
+    if( argument.substr(0, 2) != "--" )
+        return false;
+
+    SplitSetting( argument.substr( 2 ), name, value );
+    return true;
+}
+
+const bool RenderSettings::ReadBool(bool &val, const std::string &str)
+{
+    if( Utility::String::CaseInsensitiveCompare( str, "true" ) == 0 )
+    {
+        val = true;
+        return true;
+    }
+
+    if( Utility::String::CaseInsensitiveCompare( str, "false" ) == 0 )
+    {
+        val = false;
+        return true;
+    }
+
+    return Utility::String::FromString( val, str );
+}
+
+const int RenderSettings::MaxSamplesPerPixel() const
+{
+    if( (_adaptiveThreshold > 0) || _bProgressive )
+        return (_maxSamplesPerPixel > _samplesPerPixel)? _maxSamplesPerPixel: _samplesPerPixel;
+
+    return _samplesPerPixel;
+}
+
+const int RenderSettings::SampleRayBudget(const int &sample) const
+{
+    if( _maxRaysPerPixel <= 0 )
+        return -1;
+
+    const int maxSamples = MaxSamplesPerPixel();
+    return _maxRaysPerPixel / maxSamples + ((sample < _maxRaysPerPixel % maxSamples)? 1: 0);
+}
+
+const CrcCalculator::CrcType RenderSettings::CalculateCrc() const
+{
+    std::ostringstream stream;
+    stream
+        << _minThroughput       << ' ' << _bRussianRoulette     << ' ' << _maxRaysPerPixel      << ' '
+        << _bStochasticBranching << ' ' << _samplesPerPixel     << ' '
+        << _filter              << ' ' << _adaptiveThreshold    << ' ' << _maxSamplesPerPixel   << ' '
+        << _tileSize            << ' ' << _tileOrder            << ' ' << _pixelOrder           << ' '
+        << _cropX               << ' ' << _cropY                << ' ' << _cropWidth            << ' ' << _cropHeight;
+
+    return Utility::String::CalculateCrc( stream.str() );
+}
@@ -0,0 +1,128 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RENDERSETTINGS_HEADER
+#define RENDERSETTINGS_HEADER
+
+#include "CrcCalculator.h"
+#include <string>
+
+struct RenderSettings
+{
+    // Reconstruction filters
+    enum Filter
+    {
+        Filter_Box,         // Each sample only contributes to the pixel it was taken for
+        Filter_Tent,        // Radius of 1 pixel
+        Filter_Gaussian     // Radius of 1.5 pixels
+    };
+
+    // Orders in which tiles, and the pixels within them, are rendered
+    enum Order
+    {
+        Order_Scanline,
+        Order_Morton,
+        Order_Hilbert
+    };
+
+    // Costs of the pixels which can be recorded in a heatmap
+    enum Cost
+    {
+        Cost_None,
+        Cost_Time,              // Wall time
+        Cost_Rays,              // Rays traced by the Integrator (including shadow rays only if they're ray traced)
+        Cost_PrimitiveTests     // Ray-primitive intersection tests (only counted if compiled with _STATISTICS)
+    };
+
+    // Path termination
+    float   _minThroughput;     // Rays contributing less than this to the pixel are terminated; 0 disables it
+    bool    _bRussianRoulette;  // Terminate such rays randomly (boosting the survivors), which keeps the result unbiased
+    int     _maxRaysPerPixel;   // Hard limit on the no. of rays traced for each pixel (over all its samples); 0 for no limit
+
+    // Sampling
+    bool    _bStochasticBranching;  // Follow either the reflected or the transmitted ray at each surface (chosen randomly),
+                                    // and a single ray for fuzzy reflections, rather than all of them
+    int     _samplesPerPixel;       // No. of rays traced for each pixel (at stratified positions within the pixel, if > 1)
+
+    // Antialiasing
+    Filter  _filter;                // Filter with which the image is reconstructed from the samples
+    float   _adaptiveThreshold;     // If > 0, pixels whose neighbourhood contrast or relative standard error exceeds this
+                                    // get _samplesPerPixel more samples at a time, until _maxSamplesPerPixel
+    int     _maxSamplesPerPixel;
+
+    // Progressive rendering
+    bool    _bProgressive;          // Render coarse to fine, then keep adding samples (up to _maxSamplesPerPixel)
+    float   _timeLimit;             // Stop progressive rendering after these many seconds; 0 for no limit
+    float   _saveInterval;          // Save the image rendered so far every these many seconds; 0 to only save at the end
+
+    // Traversal
+    int     _tileSize;              // Size of the (square) tiles the image is rendered in; 0 for a single tile
+    Order   _tileOrder;
+    Order   _pixelOrder;            // Order of the pixels within each tile
+
+    // Crop window; only the pixels within it are rendered (the rest are left black). A width of 0 renders the whole image.
+    int     _cropX;
+    int     _cropY;
+    int     _cropWidth;
+    int     _cropHeight;
+
+    // Checkpointing
+    std::string _checkpointFileName;    // File to record the progress of the render in; none if empty
+    float       _checkpointInterval;    // Seconds between writes of the checkpoint file
+    bool        _bResume;               // Resume the render recorded in the checkpoint file
+
+    // Diagnostics
+    std::string _statisticsFileName;    // File to write the counters and timings of the render to (as JSON); none if empty
+                                        // Note: These are only gathered if _STATISTICS is defined.
+    std::string _traceFileName;         // File to write a timeline of the render to (as a Chrome trace); none if empty
+    Cost        _heatmapCost;           // Cost of each pixel to record in a heatmap beside the image; Cost_None for no heatmap
+
+    // Memory
+    int     _memoryLimit;           // In MiB; the render fails as soon as the memory accounted for exceeds this (0 for no limit)
+
+    // Constructor
+    explicit RenderSettings();
+
+    // Sets a setting by name, from its value as a string (as given on the command line).
+    // Returns false if there's no such setting, or the value is invalid.
+    const bool Set(const std::string &name, const std::string &value);
+
+    // Splits a setting given as <name>:<value> into its name and value.
+    // A setting without a value is a bool which is being turned on, so its value is "true".
+    static void SplitSetting(const std::string &setting, std::string &name, std::string &value);
+
+    // Splits a command line argument given as --<name>[:<value>], as above.
+    // Returns false if the argument isn't a setting (it doesn't start with --).
+    static const bool SplitArgument(const std::string &argument, std::string &name, std::string &value);
+
+    // Reads a bool as Set() does; true or false (in any case), or a number.
+    static const bool ReadBool(bool &val, const std::string &str);
+
+    // Returns the most samples a pixel can take; adaptive and progressive renders keep adding samples, up to the maximum.
+    const int MaxSamplesPerPixel() const;
+
+    // Returns the sample's share of the pixel's ray budget, so that all the samples together stay within it.
+    // The budget is split evenly, with the remainder going to the first samples; -1 if there's no limit.
+    const int SampleRayBudget(const int &sample) const;
+
+    // Returns the CRC of the settings which affect the rendered image.
+    const CrcCalculator::CrcType CalculateCrc() const;
+};
+
+#endif
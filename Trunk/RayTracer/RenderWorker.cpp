@@ -0,0 +1,183 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "RenderWorker.h"
+#include "Message.h"
+#include "Scene.h"
+#include "Deserializer.h"
+#include "SafeDelete.h"
+#include "Timer.h"
+#include "MemoryAccount.h"
+#include <iostream>
+#include <sstream>
+
+// Constructor
+RenderWorker::RenderWorker() :
+    _socket(),
+    _rayTracer(),
+    _camera(),
+    _film(),
+    _pScene( 0 )
+{
+}
+
+// Destructor
+RenderWorker::~RenderWorker()
+{
+    SafeDeleteScalar( _pScene );
+}
+
+// Functions
+const bool RenderWorker::Connect(const std::string &address)
+{
+    for(int attempt=0; attempt < MaxConnectAttempts; ++attempt)
+    {
+        if( _socket.Connect( address ) )
+            return true;
+
+        Timer::Sleep( 0.1 );
+    }
+
+    std::cout << "Error: Failed to connect to the coordinator at: " << address << std::endl;
+    return false;
+}
+
+const bool RenderWorker::ReceiveScene()
+{
+    Message message;
+    if( !message.Receive( _socket ) || (message.Type() != Message_Scene) )
+    {
+        std::cout << "Error: Failed to receive the scene from the coordinator" << std::endl;
+        return false;
+    }
+
+    int width, height, numSettings;
+    if( !message.Read( width ) || !message.Read( height ) ||
+        !message.Read( _camera._position.x ) || !message.Read( _camera._position.y ) || !message.Read( _camera._position.z ) ||
+        !message.Read( _camera._hFov ) || !message.Read( _camera._vFov ) ||
+        !message.Read( numSettings ) )
+    {
+        std::cout << "Error: Invalid scene message" << std::endl;
+        return false;
+    }
+
+    // The render settings, as given on the coordinator's command line
+    for(int i=0; i < numSettings; ++i)
+    {
+        std::string setting;
+        if( !message.ReadString( setting ) )
+            return false;
+
+        std::string name, value;
+        RenderSettings::SplitSetting( setting, name, value );
+        if( !_rayTracer._settings.Set( name, value ) )
+        {
+            std::cout << "Error: Invalid render setting: " << setting << std::endl;
+            return false;
+        }
+    }
+
+    MemoryAccount::SetLimit( (std::size_t)_rayTracer._settings._memoryLimit * 1024 * 1024 );
+
+    std::string sceneText;
+    int numTextureFiles;
+    if( !message.ReadString( sceneText ) || !message.Read( numTextureFiles ) )
+        return false;
+
+    // The textures are loaded from these, by file name, rather than from files on this machine
+    Scene::TextureFileMap textureFiles;
+    for(int i=0; i < numTextureFiles; ++i)
+    {
+        std::string fileName;
+        if( !message.ReadString( fileName ) || !message.ReadBuffer( textureFiles[fileName] ) )
+            return false;
+    }
+
+    // Load the scene from the text of the scene file
+    std::istringstream stream( sceneText );
+    Deserializer d;
+    if( !d.Open( stream ) || ((_pScene = d.Deserialize<Scene>( &textureFiles )) == 0) )
+    {
+        std::cout << "Error: Failed to load the Scene received from the coordinator" << std::endl;
+        return false;
+    }
+
+    return _film.Create( width, height, _rayTracer._settings._filter );
+}
+
+const bool RenderWorker::RenderTiles()
+{
+    Message message;
+    Film::Buffer region;
+
+    while( true )
+    {
+        if( !message.Receive( _socket ) )
+        {
+            std::cout << "Error: Lost the connection to the coordinator" << std::endl;
+            return false;
+        }
+
+        if( message.Type() == Message_Done )
+            return true;
+
+        int tile, x, y, width, height;
+        if( (message.Type() != Message_Tile) ||
+            !message.Read( tile ) || !message.Read( x ) || !message.Read( y ) || !message.Read( width ) || !message.Read( height ) ||
+            (x < 0) || (y < 0) || (width < 1) || (height < 1) || (x + width > _film.Width()) || (y + height > _film.Height()) )
+        {
+            std::cout << "Error: Invalid tile message" << std::endl;
+            return false;
+        }
+
+        const Timer timer;
+        _rayTracer.RenderTile( _camera, *_pScene, _film, x, y, width, height );
+        const double seconds = timer.ElapsedTime();
+
+        region.clear();
+        _film.WriteCapture( region );
+
+        message.Reset( Message_Result );
+        message.Write( tile );
+        message.Write( seconds );
+        message.WriteBuffer( region );
+        if( !message.Send( _socket ) )
+        {
+            std::cout << "Error: Lost the connection to the coordinator" << std::endl;
+            return false;
+        }
+
+        // Display a mark for each tile rendered
+        std::cout << ".";
+    }
+}
+
+const bool RenderWorker::Run(const std::string &address)
+{
+    std::cout << "Connecting to the coordinator at: " << address << std::endl;
+    if( !Connect( address ) || !ReceiveScene() )
+        return false;
+
+    std::cout << "Rendering";
+    const bool bResult = RenderTiles();
+    std::cout << "Done" << std::endl;
+
+    return bResult;
+}
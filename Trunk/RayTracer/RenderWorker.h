@@ -0,0 +1,87 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef RENDERWORKER_HEADER
+#define RENDERWORKER_HEADER
+
+#include "Socket.h"
+#include "Camera.h"
+#include "RayTracer.h"
+#include "Film.h"
+#include <string>
+
+// Forward Declarations
+class Scene;
+
+// Renders tiles for a coordinator (see RayTracer::RenderDistributed()) in another process,
+// possibly on another machine.
+// The coordinator sends the scene (as the text of its scene file, along with the contents of its texture
+// files, so that the worker needn't share a file system with it), the camera and the render settings
+// once; then a tile at a time. Each tile's contributions to the Film are sent back, along with the time
+// taken to render it, until the coordinator says it's done.
+class RenderWorker
+{
+// Types
+public:
+    enum MessageType
+    {
+        Message_Scene = 1,  // Coordinator -> Worker: width, height, camera, settings, scene file, texture files
+        Message_Tile,       // Coordinator -> Worker: tile no., x, y, width, height
+        Message_Result,     // Worker -> Coordinator: tile no., seconds taken, region of the Film
+        Message_Done        // Coordinator -> Worker: no more tiles
+    };
+
+private:
+    enum
+    {
+        MaxConnectAttempts = 50 // Attempts to connect, 0.1 seconds apart, while the coordinator starts up
+    };
+
+// Members
+private:
+    Socket      _socket;
+    RayTracer   _rayTracer;
+    Camera      _camera;
+    Film        _film;
+    Scene      *_pScene;
+
+public:
+// Constructor
+    explicit RenderWorker();
+// Destructor
+    ~RenderWorker();
+
+private:
+// Copy Constructor / Assignment Operator
+    RenderWorker(const RenderWorker &);
+    const RenderWorker &operator =(const RenderWorker &);
+
+// Functions
+private:
+    const bool Connect(const std::string &address);
+    const bool ReceiveScene();
+    const bool RenderTiles();
+
+public:
+    // Connects to the coordinator at the address, and renders tiles until it's done.
+    const bool Run(const std::string &address);
+};
+
+#endif
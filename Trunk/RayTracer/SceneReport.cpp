@@ -0,0 +1,164 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "SceneReport.h"
+#include "RenderSettings.h"
+#include "Scene.h"
+#include "Sphere.h"
+#include "Quad.h"
+#include "Triangle.h"
+#include "PointLight.h"
+#include "AreaLight.h"
+#include "Texture.h"
+#include "Maths.h"
+#include "ForEach.h"
+#include <map>
+#include <string>
+#include <sstream>
+
+namespace
+{
+    typedef std::map<std::string, int> CountMap;
+
+    const char *const PrimitiveTypeName(const Primitive &primitive)
+    {
+        if( dynamic_cast<const Sphere *>( &primitive ) )
+            return "Sphere";
+        if( dynamic_cast<const Quad *>( &primitive ) )
+            return "Quad";
+        if( dynamic_cast<const Triangle *>( &primitive ) )
+            return "Triangle";
+
+        return "Other";
+    }
+
+    const char *const LightTypeName(const Light &light)
+    {
+        if( dynamic_cast<const PointLight *>( &light ) )
+            return "PointLight";
+        if( dynamic_cast<const AreaLight *>( &light ) )
+            return "AreaLight";
+
+        return "Other";
+    }
+
+    void WriteCounts(std::ostream &stream, const CountMap &counts)
+    {
+        FOR_EACH( itr, CountMap, counts )
+            stream << "  " << itr->first << ": " << itr->second << std::endl;
+    }
+}
+
+// Functions
+void SceneReport::Write(std::ostream &stream, const Scene &scene, const RenderSettings &settings)
+{
+    // Primitives, and the most rays their materials can trace from a point on their surface
+    CountMap primitiveCounts;
+    int maxFirstBranches = 0;   // Fuzzy reflections are only traced from the surfaces the primary rays hit
+    int maxBranches = 0;
+    FOR_EACH( itr, Scene::PrimitiveList, scene.Primitives() )
+    {
+        const Primitive &primitive = **itr;
+        ++primitiveCounts[ PrimitiveTypeName( primitive ) ];
+
+        const Material &material = primitive.GetMaterial();
+        const int numReflectedRays = material.GetMaxNumReflectedRays();
+        const int numTransmittedRays = material.IsTransmissive()? 1: 0;
+        maxFirstBranches = Maths::Max( maxFirstBranches, numReflectedRays + numTransmittedRays );
+        maxBranches = Maths::Max( maxBranches, Maths::Min( numReflectedRays, 1 ) + numTransmittedRays );
+    }
+
+    stream << "Primitives: " << scene.Primitives().size() << std::endl;
+    WriteCounts( stream, primitiveCounts );
+    stream << "Materials: " << scene.Materials().size() << std::endl;
+
+    // Lights, and the shadow rays they trace
+    CountMap lightCounts;
+    int numLightSamples = 0;
+    int numAreaLightSamples = 0;
+    int maxLightSamples = 0;
+    FOR_EACH( itr, Scene::LightList, scene.Lights() )
+    {
+        const Light &light = **itr;
+        ++lightCounts[ LightTypeName( light ) ];
+
+        numLightSamples += light.NumSamples();
+        maxLightSamples = Maths::Max( maxLightSamples, light.NumSamples() );
+        if( dynamic_cast<const AreaLight *>( &light ) )
+            numAreaLightSamples += light.NumSamples();
+    }
+
+    stream << "Lights: " << scene.Lights().size() << " (" << numAreaLightSamples << " area light samples)" << std::endl;
+    WriteCounts( stream, lightCounts );
+
+    // Textures, as they're kept in memory (decoded into floating point pixels)
+    double textureMemory = 0;
+    std::ostringstream textureStream;
+    FOR_EACH( itr, Scene::TextureList, scene.Textures() )
+    {
+        const Image &image = (*itr)->GetImage();
+        const double memory = (double)image.Width() * image.Height() * sizeof(Pixel<float>);
+        textureMemory += memory;
+
+        textureStream << "  " << (*itr)->FileName() << ": " << image.Width() << "x" << image.Height()
+            << ", " << memory / 1024 << " KiB" << std::endl;
+    }
+
+    stream << "Textures: " << scene.Textures().size() << " (" << textureMemory / (1024 * 1024) << " MiB decoded)" << std::endl;
+    stream << textureStream.str();
+
+    // The most rays that can be traced for a sample. A primary ray is the first generation; every surface
+    // a ray hits can then trace a ray of the next generation for each of its branches.
+    double numRaysPerSample = 0;
+    if( scene._maxRayGenerations > 0 )
+    {
+        const int firstBranches = settings._bStochasticBranching? Maths::Min( maxFirstBranches, 1 ): maxFirstBranches;
+        const int branches      = settings._bStochasticBranching? Maths::Min( maxBranches, 1 ): maxBranches;
+
+        double numRays = 1;     // Rays of the current generation
+        numRaysPerSample = 1;
+        for(int generation=2; generation <= scene._maxRayGenerations; ++generation)
+        {
+            numRays *= (generation == 2)? firstBranches: branches;
+            numRaysPerSample += numRays;
+        }
+
+        // The first samples get the largest share of the pixel's ray budget
+        if( settings._maxRaysPerPixel > 0 )
+            numRaysPerSample = Maths::Min<double>( numRaysPerSample, settings.SampleRayBudget( 0 ) );
+    }
+
+    // Every surface traces shadow rays towards the lights it samples
+    const int numShadowRays = ((scene._numLightSamples > 0) && (scene._numLightSamples < (int)scene.Lights().size()))?
+        scene._numLightSamples * maxLightSamples:
+        numLightSamples;
+
+    // Adaptive and progressive renders keep adding samples to a pixel, up to the maximum
+    const int numSamples = settings.MaxSamplesPerPixel();
+
+    stream << "Rays per pixel (worst case): " << numSamples * numRaysPerSample * (1 + numShadowRays) << std::endl;
+    stream << "  Samples per pixel: " << numSamples << std::endl;
+    stream << "  Rays per sample: " << numRaysPerSample << " (" << scene._maxRayGenerations << " generations)" << std::endl;
+    stream << "  Shadow rays per surface: " << numShadowRays << std::endl;
+
+    // The LightTree is the only hierarchy; the Primitives are all tested by every ray
+    const LightTree &lightTree = scene.GetLightTree();
+    stream << "Light tree: " << lightTree.NumNodes() << " nodes, SAH cost " << lightTree.SahCost() << std::endl;
+    stream << "Primitive tests per ray: " << scene.Primitives().size() << " (there's no acceleration structure for Primitives)" << std::endl;
+}
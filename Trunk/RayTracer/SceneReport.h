@@ -0,0 +1,49 @@
+
+//  RayWatch - A simple cross-platform RayTracer.
+//  Copyright (C) 2008
+//      Angelo Rohit Joseph Pulikotil,
+//      Francis Xavier Joseph Pulikotil
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SCENEREPORT_HEADER
+#define SCENEREPORT_HEADER
+
+#include <ostream>
+
+// Forward Declarations
+class Scene;
+struct RenderSettings;
+
+// Describes what rendering a Scene will cost, without rendering it: the Primitives and Lights it has,
+// the memory its Textures take once decoded, the most rays that can be traced for a pixel, and the
+// shape of its LightTree.
+class SceneReport
+{
+// Constructor
+private:
+    explicit SceneReport();
+// Destructor
+    ~SceneReport();
+
+// Copy Constructor / Assignment Operator
+    SceneReport(const SceneReport &);
+    const SceneReport &operator =(const SceneReport &);
+
+// Functions
+public:
+    static void Write(std::ostream &stream, const Scene &scene, const RenderSettings &settings);
+};
+
+#endif
@@ -19,6 +19,7 @@
 
 #include "Scene.h"
 #include "Primitive.h"
+#include "Material.h"
 #include "Light.h"
 #include "Texture.h"
 #include "SafeDelete.h"
@@ -28,36 +29,58 @@
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
 #include "ForEach.h"
+#include "Statistics.h"
+#include "Trace.h"
 #include <algorithm>
 #include <limits>
 
 // Register with the ObjectFactory
 ObjectFactory_Register(Serializable, Scene);
 
+namespace
+{
+    // Removes the item from the list, if it's in it
+    template<class T>
+    void Remove(std::vector<T> &list, const T &item)
+    {
+        list.erase( std::remove( list.begin(), list.end(), item ), list.end() );
+    }
+}
+
 // Constructor
 Scene::Scene() :
     _primitiveList(),
+    _materialList(),
     _lightList(),
     _textureList(),
+    _lightTree(),
+    _arena( MemoryAccount::Subsystem_SceneObjects ),
+    _heapObjects(),
+    _pTextureFiles( 0 ),
     _ambientLight( 0 ),
-    _maxRayGenerations( 3 )
+    _maxRayGenerations( 3 ),
+    _numLightSamples( 0 )
 {
 }
 
 // Destructor
 Scene::~Scene()
 {
-    // Delete all the Primitives
-    FOR_EACH_MUTABLE( itr, PrimitiveList, _primitiveList )
+    // Delete the Primitives and Materials allocated from the heap. Those in the Arena (which is
+    // nearly all of them, for a Scene read from a file) own no memory, so they aren't visited at all.
+    FOR_EACH_MUTABLE( itr, ObjectList, _heapObjects )
         SafeDeleteScalar( *itr );
 
-    // Delete all the Lights
+    // Delete all the Lights and Textures; AreaLights and Textures own buffers on the heap.
+    // There are few of these, however many Primitives there are.
     FOR_EACH_MUTABLE( itr, LightList, _lightList )
         SafeDeleteScalar( *itr );
 
-    // Delete all the Textures
     FOR_EACH_MUTABLE( itr, TextureList, _textureList )
         SafeDeleteScalar( *itr );
+
+    // The memory of everything in the Arena is released all at once
+    _arena.Release();
 }
 
 // Functions
@@ -72,11 +95,43 @@ void Scene::AddPrimitive(Primitive *const pPrimitive)
         return;
 
     _primitiveList.push_back( pPrimitive );
+    if( !Serializable::IsInArena( pPrimitive ) )
+        _heapObjects.push_back( pPrimitive );
 }
 
 void Scene::RemovePrimitive(Primitive *const pPrimitive)
 {
-    _primitiveList.remove( pPrimitive );
+    Remove( _primitiveList, pPrimitive );
+    Remove<Serializable *>( _heapObjects, pPrimitive );
+}
+
+Material *const Scene::CreateMaterial()
+{
+    Material *const pMaterial = new Material();
+    _materialList.push_back( pMaterial );
+    if( !Serializable::IsInArena( pMaterial ) )
+        _heapObjects.push_back( pMaterial );
+    return pMaterial;
+}
+
+void Scene::AddMaterial(Material *const pMaterial)
+{
+    if( !pMaterial )
+        return;
+
+    // If the Material is already in the list, then don't do anything.
+    if( std::find(_materialList.begin(), _materialList.end(), pMaterial) != _materialList.end() )
+        return;
+
+    _materialList.push_back( pMaterial );
+    if( !Serializable::IsInArena( pMaterial ) )
+        _heapObjects.push_back( pMaterial );
+}
+
+void Scene::RemoveMaterial(Material *const pMaterial)
+{
+    Remove( _materialList, pMaterial );
+    Remove<Serializable *>( _heapObjects, pMaterial );
 }
 
 void Scene::AddLight(Light *const pLight)
@@ -89,11 +144,88 @@ void Scene::AddLight(Light *const pLight)
         return;
 
     _lightList.push_back( pLight );
+
+    // The LightTree is out of date now
+    _lightTree.Clear();
 }
 
 void Scene::RemoveLight(Light *const pLight)
 {
-    _lightList.remove( pLight );
+    Remove( _lightList, pLight );
+
+    // The LightTree is out of date now
+    _lightTree.Clear();
+}
+
+void Scene::BuildLightTree()
+{
+    STATISTICS_START_PHASE( Phase_Build );
+    const Trace::Scope traceScope( "Build light tree" );
+    _lightTree.Build( _lightList );
+    STATISTICS_END_PHASE( Phase_Build );
+}
+
+void Scene::RefitLightTree()
+{
+    STATISTICS_START_PHASE( Phase_Build );
+    const Trace::Scope traceScope( "Refit light tree" );
+    _lightTree.Refit();
+    STATISTICS_END_PHASE( Phase_Build );
+}
+
+Primitive *const Scene::GetPrimitive(const int &index) const
+{
+    if( (index < 0) || (index >= (int)_primitiveList.size()) )
+        return 0;
+
+    return _primitiveList[index];
+}
+
+Light *const Scene::GetLight(const int &index) const
+{
+    if( (index < 0) || (index >= (int)_lightList.size()) )
+        return 0;
+
+    return _lightList[index];
+}
+
+const int Scene::GetPrimitiveIndex(const Primitive *const pPrimitive) const
+{
+    const PrimitiveList::const_iterator itr = std::find( _primitiveList.begin(), _primitiveList.end(), pPrimitive );
+    if( itr == _primitiveList.end() )
+        return -1;
+
+    return (int)std::distance( _primitiveList.begin(), itr );
+}
+
+const Scene::PrimitiveList &Scene::Primitives() const
+{
+    return _primitiveList;
+}
+
+const Scene::MaterialList &Scene::Materials() const
+{
+    return _materialList;
+}
+
+const Scene::LightList &Scene::Lights() const
+{
+    return _lightList;
+}
+
+const Scene::TextureList &Scene::Textures() const
+{
+    return _textureList;
+}
+
+const LightTree &Scene::GetLightTree() const
+{
+    return _lightTree;
+}
+
+const Scene::TextureFileMap *const Scene::TextureFiles() const
+{
+    return _pTextureFiles;
 }
 
 void Scene::AddTexture(Texture *const pTexture)
@@ -110,7 +242,7 @@ void Scene::AddTexture(Texture *const pTexture)
 
 void Scene::RemoveTexture(Texture *const pTexture)
 {
-    _textureList.remove( pTexture );
+    Remove( _textureList, pTexture );
 }
 
 const Primitive *const Scene::FindClosestIntersection(const Ray &ray, IntersectionInfo &closestIntersectionInfo) const
@@ -123,6 +255,8 @@ const Primitive *const Scene::FindClosestIntersection(const Ray &ray, Intersecti
     {
         const Primitive *const pPrimitive = *itr;
 
+        STATISTICS_INCREMENT( Counter_PrimitiveTests );
+
         IntersectionInfo intersectionInfo;
         if( pPrimitive->Intersects( ray, intersectionInfo ) && (intersectionInfo._dist < closestIntersectionInfo._dist) )
         {
@@ -144,6 +278,8 @@ const bool Scene::IsOccluded(const Ray &ray, const float &rayLength) const
         if( pPrimitive->_pLight )
             continue;
 
+        STATISTICS_INCREMENT( Counter_PrimitiveTests );
+
         float intersectionDist;
         if( pPrimitive->Intersects( ray, intersectionDist ) && (intersectionDist < rayLength) )
             return true;
@@ -152,6 +288,36 @@ const bool Scene::IsOccluded(const Ray &ray, const float &rayLength) const
     return false;
 }
 
+void Scene::IsOccluded(
+    const Vector<float>         &origin,
+    const Vector<float> *const   pDirections,
+    const float         *const   pLengths,
+    const int                   &numRays,
+    bool                *const   pOccluded ) const
+{
+    for(int i=0; i < numRays; ++i)
+        pOccluded[i] = false;
+
+    // Go through all the primitives (which are not light sources) and see if they intersect the rays
+    int numUnoccluded = numRays;
+    FOR_EACH( itr, PrimitiveList, _primitiveList )
+    {
+        // If all the rays are occluded, then we're done
+        if( numUnoccluded <= 0 )
+            break;
+
+        const Primitive *const pPrimitive = *itr;
+
+        if( pPrimitive->_pLight )
+            continue;
+
+        // Only the rays which aren't occluded yet are tested
+        STATISTICS_ADD( Counter_PrimitiveTests, numUnoccluded );
+
+        numUnoccluded -= pPrimitive->IntersectsAny( origin, pDirections, pLengths, numRays, pOccluded );
+    }
+}
+
 void Scene::GetSurfaceIllumination(
     const Ray           &ray,
     const Vector<float> &surfaceNormal,
@@ -163,6 +329,20 @@ void Scene::GetSurfaceIllumination(
     diffuse     = _ambientLight;
     specular    .Set( 0 );
 
+    // If we're supposed to sample the Lights, rather than go through all of them
+    if( (_numLightSamples > 0) && !_lightTree.IsEmpty() )
+    {
+        _lightTree.SampleIlluminationAtSurface( ray, surfaceNormal, surfaceRoughness, *this, _numLightSamples, diffuse, specular );
+        return;
+    }
+
+    // Accumulate illumination from all the lights in range
+    if( !_lightTree.IsEmpty() )
+    {
+        _lightTree.AccumulateIlluminationAtSurface( ray, surfaceNormal, surfaceRoughness, *this, diffuse, specular );
+        return;
+    }
+
     // Accumulate illumination from all the lights
     FOR_EACH( itr, LightList, _lightList )
     {
@@ -203,8 +383,14 @@ Texture *const Scene::LoadTexture(const std::string &fileName)
 }
 
 // Serializable's functions
-const bool Scene::Read(Deserializer &d, void *const /*pUserData*/)
+const bool Scene::Read(Deserializer &d, void *const pUserData)
 {
+    // The objects read are allocated one after the other, rather than being scattered over the heap
+    Arena::Scope arenaScope( _arena );
+
+    // The Textures find these through the Scene, which is what they're given
+    _pTextureFiles = static_cast<const TextureFileMap *>( pUserData );
+
     DESERIALIZE_CLASS( object, d, Scene )
     {
         // Read the base
@@ -212,7 +398,8 @@ const bool Scene::Read(Deserializer &d, void *const /*pUserData*/)
             break;
 
         if( !d.ReadObject( "ambientLight", _ambientLight, Color(0) )    ||
-            !d.ReadObject( "maxRayGenerations", _maxRayGenerations, 3 ) )
+            !d.ReadObject( "maxRayGenerations", _maxRayGenerations, 3 ) ||
+            !d.ReadObject( "numLightSamples", _numLightSamples, 0 )     )
             break;
 
         // Read the children
@@ -232,19 +419,30 @@ const bool Scene::Read(Deserializer &d, void *const /*pUserData*/)
             }
 
             // Load the object
-            if( !pSerializable->Read( d, 0 ) )
+            // Note: Primitives give the Scene the Materials written out within them.
+            if( !pSerializable->Read( d, this ) )
             {
                 SafeDeleteScalar( pSerializable );
                 break;
             }
 
-            // Depending on the type of object it is, push it into the appropriate list
+            // Depending on the type of object it is, push it into the appropriate list.
+            // Note: It's only just been created, so it can't be in the list already; the lists
+            //       aren't searched for it (as AddPrimitive() and AddLight() do), which is quadratic.
             {
                 // See if it's a Primitive
                 Primitive *pPrimitive = dynamic_cast<Primitive *>(pSerializable);
                 if( pPrimitive )
                 {
-                    AddPrimitive( pPrimitive );
+                    _primitiveList.push_back( pPrimitive );
+                    continue;
+                }
+
+                // See if it's a Material
+                Material *pMaterial = dynamic_cast<Material *>(pSerializable);
+                if( pMaterial )
+                {
+                    _materialList.push_back( pMaterial );
                     continue;
                 }
 
@@ -252,7 +450,7 @@ const bool Scene::Read(Deserializer &d, void *const /*pUserData*/)
                 Light *pLight = dynamic_cast<Light *>(pSerializable);
                 if( pLight )
                 {
-                    AddLight( pLight );
+                    _lightList.push_back( pLight );
                     continue;
                 }
 
@@ -275,8 +473,13 @@ const bool Scene::Read(Deserializer &d, void *const /*pUserData*/)
 
         if( children.ReadFailed() )
             break;
+
+        // All the Lights have been read
+        BuildLightTree();
     }
 
+    _pTextureFiles = 0;
+
     return object.ReadResult();
 }
 
@@ -289,12 +492,25 @@ const bool Scene::Write(Serializer &s) const
             break;
 
         if( !s.WriteObject( "ambientLight", _ambientLight, Color(0) )       ||
-            !s.WriteObject( "maxRayGenerations", _maxRayGenerations, 3 )    )
+            !s.WriteObject( "maxRayGenerations", _maxRayGenerations, 3 )    ||
+            !s.WriteObject( "numLightSamples", _numLightSamples, 0 )        )
             break;
 
         // Write all the children
         SERIALIZE_OBJECT( children, s, "Children" )
         {
+            // Write all the Materials
+            {
+                MaterialList::const_iterator itr;
+                for(itr = _materialList.begin(); itr != _materialList.end(); ++itr)
+                {
+                    if( !(*itr)->Write( s ) )
+                        break;
+                }
+                if( itr != _materialList.end() )
+                    break;
+            }
+
             // Write all the Primitives
             {
                 PrimitiveList::const_iterator itr;
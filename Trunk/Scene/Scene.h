@@ -23,12 +23,16 @@
 #include "Color.h"
 #include "IntersectionInfo.h"
 #include "Serializable.h"
-#include <list>
+#include "LightTree.h"
+#include "Arena.h"
+#include <vector>
+#include <map>
 #include <string>
 
 // Forward Declarations
 class Ray;
 class Primitive;
+class Material;
 class Light;
 class Texture;
 
@@ -36,19 +40,32 @@ class Scene : public Serializable
 {
 // Typedefs
 public:
-    typedef std::list<Primitive *>  PrimitiveList;
-    typedef std::list<Light *>      LightList;
-    typedef std::list<Texture *>    TextureList;
+    typedef std::vector<Primitive *>    PrimitiveList;
+    typedef std::vector<Material *>     MaterialList;
+    typedef LightTree::LightList        LightList;
+    typedef std::vector<Texture *>      TextureList;
+
+    // The contents of texture files, by file name (see Read())
+    typedef std::map<std::string, std::vector<unsigned char> >  TextureFileMap;
+
+private:
+    typedef std::vector<Serializable *> ObjectList;
 
 // Members
 private:
     PrimitiveList   _primitiveList;
+    MaterialList    _materialList;  // Shared by the Primitives; written out once, before them
     LightList       _lightList;
     TextureList     _textureList;
+    LightTree       _lightTree;
+    Arena           _arena;         // The objects read from a scene file are allocated from this, in the order they're read
+    ObjectList      _heapObjects;   // The Primitives and Materials which weren't allocated from the Arena (see ~Scene())
+    const TextureFileMap *_pTextureFiles;   // Those being read with the Scene, if any (see Read())
 
 public:
     Color           _ambientLight;
     int             _maxRayGenerations;
+    int             _numLightSamples;   // No. of Lights sampled per point on a surface; 0 for all the Lights
 
 public:
 // Constructor
@@ -63,12 +80,45 @@ private:
 
 // Functions
 public:
+    // Note: Objects read from a scene file are in the Scene's Arena; any removed from the Scene
+    //       must be deleted before the Scene is.
+    //       Primitives and Materials in the Arena are never destructed, so they mustn't own any memory.
     void AddPrimitive(Primitive *const pPrimitive);
     void RemovePrimitive(Primitive *const pPrimitive);
 
+    // The Materials the Primitives refer to (see Primitive::_pMaterial); the Scene owns them.
+    // CreateMaterial() returns a new Material which has been added to the Scene.
+    Material *const CreateMaterial();
+    void AddMaterial(Material *const pMaterial);
+    void RemoveMaterial(Material *const pMaterial);
+
     void AddLight(Light *const pLight);
     void RemoveLight(Light *const pLight);
 
+    // Builds the LightTree used for sampling the Lights.
+    // This has to be called again after any Light is added, removed or modified.
+    void BuildLightTree();
+
+    // Updates the LightTree after Lights have been moved, without building it again (see LightTree::Refit()).
+    void RefitLightTree();
+
+    // Get the Primitives and Lights in the order they were added; 0 if there aren't that many.
+    Primitive *const GetPrimitive(const int &index) const;
+    Light *const GetLight(const int &index) const;
+
+    // Returns the index of the Primitive (as for GetPrimitive()); -1 if it isn't in the Scene.
+    const int GetPrimitiveIndex(const Primitive *const pPrimitive) const;
+
+    // Accessors
+    const PrimitiveList &Primitives() const;
+    const MaterialList &Materials() const;
+    const LightList &Lights() const;
+    const TextureList &Textures() const;
+    const LightTree &GetLightTree() const;
+
+    // The contents of the texture files the Scene is being read with; 0 if the Textures are loaded from the files themselves.
+    const TextureFileMap *const TextureFiles() const;
+
     void AddTexture(Texture *const pTexture);
     void RemoveTexture(Texture *const pTexture);
 
@@ -76,6 +126,15 @@ public:
 
     const bool IsOccluded(const Ray &ray, const float &rayLength) const;
 
+    // Tests a set of rays, which share a common origin, for occlusion (Packet version of the above).
+    // This goes through the primitives once for all the rays, rather than once per ray.
+    void IsOccluded(
+        const Vector<float>         &origin,
+        const Vector<float> *const   pDirections,
+        const float         *const   pLengths,
+        const int                   &numRays,
+        bool                *const   pOccluded ) const;
+
     void GetSurfaceIllumination(
         const Ray           &ray,
         const Vector<float> &surfaceNormal,
@@ -86,6 +145,8 @@ public:
     Texture *const LoadTexture(const std::string &fileName);
 
     // Serializable's functions
+    // pUserData: A TextureFileMap, whose contents the Textures are loaded from rather than their files
+    //            (as for a Scene sent to another machine); 0 to load the files.
     virtual const bool Read(Deserializer &d, void *const pUserData);
     virtual const bool Write(Serializer &s) const;
 };
@@ -250,6 +250,26 @@ const bool Deserializer::ReadGroupObjectFooter()
     return ReadKnownToken( "}" );
 }
 
+const bool Deserializer::PeekGroupObject(const std::string &name)
+{
+    // A group object reads as: name = Type { ...
+    // while a pointer reads as: name = "address";
+    std::string token;
+    if( !_stream.PeekToken( token, "{;\"" ) )
+        return false;
+
+    const std::size_t equals = token.find( '=' );
+    if( equals == std::string::npos )
+        return false;
+
+    std::string readName( token, 0, equals );
+    std::string objectType( token, equals + 1 );
+    Utility::String::TrimWhiteSpaces( readName );
+    Utility::String::TrimWhiteSpaces( objectType );
+
+    return (readName.compare( name ) == 0) && (objectType.size() > 0);
+}
+
 // Helper functions to read various data types
 const bool Deserializer::ReadObject(const std::string &name, std::string &value, const DefaultValue<std::string> &defaultValue)
 {
@@ -76,6 +76,10 @@ public:
     const bool PeekGroupObjectFooter();
     const bool ReadGroupObjectFooter();
 
+    // Peeks whether the named object is written out in full (see ReadObject() for a Serializable),
+    // rather than as a pointer to an object written elsewhere.
+    const bool PeekGroupObject(const std::string &name);
+
     // Helper functions to read various data types
     const bool ReadObject(const std::string &name, std::string   &value, const DefaultValue<std::string>    &defaultValue = DefaultValue<std::string>()    );
     const bool ReadObject(const std::string &name, std::size_t   &value, const DefaultValue<std::size_t>    &defaultValue = DefaultValue<std::size_t>()    );
@@ -19,6 +19,8 @@
 #include "DeserializerHelper.h"
 #include "SerializerHelper.h"
 #include "Utility.h"
+#include "MemoryAccount.h"
+#include "Arena.h"
 
 // Constructor
 Serializable::Serializable() :
@@ -32,6 +34,44 @@ Serializable::~Serializable()
 }
 
 // Functions
+void *Serializable::operator new(std::size_t size)
+{
+    Arena *const pArena = Arena::Current();
+    const std::size_t totalSize = sizeof(AllocationHeader) + size;
+
+    AllocationHeader *pHeader = 0;
+    if( pArena )
+        pHeader = static_cast<AllocationHeader *>( pArena->Allocate( totalSize ) );
+    else
+    {
+        MemoryAccount::Add( MemoryAccount::Subsystem_SceneObjects, totalSize );
+        pHeader = static_cast<AllocationHeader *>( ::operator new( totalSize ) );
+    }
+
+    pHeader->_pArena = pArena;
+    return pHeader + 1;
+}
+
+void Serializable::operator delete(void *p, std::size_t size)
+{
+    if( !p )
+        return;
+
+    AllocationHeader *const pHeader = static_cast<AllocationHeader *>( p ) - 1;
+    if( pHeader->_pArena )
+        return;
+
+    MemoryAccount::Remove( MemoryAccount::Subsystem_SceneObjects, sizeof(AllocationHeader) + size );
+    ::operator delete( pHeader );
+}
+
+const bool Serializable::IsInArena(const Serializable *const pSerializable)
+{
+    // The header precedes the whole object, which a base class pointer needn't point to the start of
+    const AllocationHeader *const pHeader = static_cast<const AllocationHeader *>( dynamic_cast<const void *>( pSerializable ) ) - 1;
+    return (pHeader->_pArena != 0);
+}
+
 const bool Serializable::Read(Deserializer &d, void *const /*pUserData*/)
 {
     DESERIALIZE_CLASS( object, d, Serializable )
@@ -18,13 +18,26 @@
 #ifndef SERIALIZABLE_HEADER
 #define SERIALIZABLE_HEADER
 
+#include <cstddef>
+
 // Forward Declarations
 class Deserializer;
 class Serializer;
 class AddressTranslator;
+class Arena;
 
 class Serializable
 {
+// Types
+private:
+    // Precedes every Serializable in memory, recording where it was allocated from.
+    // It's a union so that its size keeps the Serializable after it aligned.
+    union AllocationHeader
+    {
+        Arena       *_pArena;       // 0 if it was allocated from the heap
+        long double  _alignment;
+    };
+
 // Members
 protected:
     mutable int _serializationDepth;
@@ -38,6 +51,15 @@ public:
 
 // Functions
 public:
+    // Serializables are allocated from the current Arena, if there's one (see Arena::Scope), and
+    // otherwise from the heap, which accounts for their memory (see MemoryAccount). Deleting one
+    // in an Arena only destructs it; its memory is released along with the Arena.
+    static void *operator new(std::size_t size);
+    static void operator delete(void *p, std::size_t size);
+
+    // Returns true if the Serializable was allocated from an Arena (rather than from the heap)
+    static const bool IsInArena(const Serializable *const pSerializable);
+
     virtual const bool Read(Deserializer &d, void *const pUserData) =0;
     virtual const bool Write(Serializer &s) const =0;
 
@@ -24,7 +24,8 @@ StreamIterator::StreamIterator() :
     _buffer(),
     _cursor( _buffer.end() ),
     _lineNumber( 0 ),
-    _positionInfoStack()
+    _positionInfoStack(),
+    _memory( MemoryAccount::Subsystem_Parse )
 {
 }
 
@@ -48,10 +49,12 @@ const bool StreamIterator::Open(std::istream &stream)
 
         // Read the entire file into the buffer
         std::copy( std::istreambuf_iterator<char>( stream ), std::istreambuf_iterator<char>(), std::back_inserter( _buffer ) );
-        
+        _memory.SetSize( _buffer.capacity() );
+
         // Preprocess the buffer
         if( !Preprocessor::Process( _buffer ) )
             EXIT_CODE_BLOCK;
+        _memory.SetSize( _buffer.capacity() );
 
         Reset();
 
@@ -68,7 +71,9 @@ const bool StreamIterator::Open(std::istream &stream)
 
 void StreamIterator::Close()
 {
-    _buffer.clear();
+    // Release the buffer, rather than only emptying it
+    Buffer().swap( _buffer );
+    _memory.SetSize( 0 );
     _cursor = _buffer.end();
     _lineNumber = 0;
     _positionInfoStack.clear();
@@ -19,6 +19,7 @@
 #define STREAM_HEADER
 
 #include "LineNumberProvider.h"
+#include "MemoryAccount.h"
 #include <string>
 #include <vector>
 #include <istream>
@@ -36,6 +37,7 @@ private:
     Cursor              _cursor;
     int                 _lineNumber;
     PositionInfoStack   _positionInfoStack;
+    MemoryAccount::Allocation _memory;  // Of the buffer
 
 public:
 // Constructor